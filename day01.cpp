@@ -1,19 +1,271 @@
 #include <iostream>
 #include <array>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <initializer_list>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
-// Initializer list
-int makeSum(std::initializer_list<int> nums) {
-    int sum = 0;
-    for (auto n : nums) {
-        sum += n;
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define DAY01_SUM_X86 1
+#endif
+
+/*
+* Reductions
+*
+* makeSum() sums any contiguous range: an initializer list, a C array,
+* std::array, std::vector, anything std::data() and std::size() accept.
+* The sum is kept in a 64-bit accumulator: signed integers add up in
+* std::int64_t, unsigned ones in std::uint64_t and floating point in
+* double. That only rules out overflow for elements narrower than 64 bits:
+* 32-bit values cannot overflow a 64-bit sum below 2^32 elements, but
+* 64-bit values get no headroom and overflow as they would on their own.
+*
+* int ranges, the common case, also have SSE4.1 and AVX2 kernels that
+* widen and add several elements per instruction, picked at run time, and
+* large ranges are split across threads. Integer addition is associative,
+* so every kernel and thread count gives the same sum; floating point sums
+* may differ in the last bits, because the additions are regrouped.
+*/
+template <typename T>
+using WideSum = std::conditional_t<std::is_floating_point_v<T>, double,
+                std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+enum class SumKernel
+{
+    Scalar,
+    Sse41,  // four ints per iteration
+    Avx2    // sixteen ints per iteration
+};
+
+// Ranges smaller than this are summed on the calling thread alone.
+const size_t kParallelSumThreshold = 1 << 20;
+
+// Four independent accumulators keep four additions in flight.
+template <typename T>
+WideSum<T> sumScalar(const T* data, size_t count) {
+    WideSum<T> partial[4] = {};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        partial[0] += data[i];
+        partial[1] += data[i + 1];
+        partial[2] += data[i + 2];
+        partial[3] += data[i + 3];
+    }
+    for (; i < count; ++i) {
+        partial[0] += data[i];
+    }
+    return (partial[0] + partial[1]) + (partial[2] + partial[3]);
+}
+
+#ifdef DAY01_SUM_X86
+__attribute__((target("sse4.1")))
+std::int64_t sumSse41(const int* data, size_t count) {
+    __m128i low = _mm_setzero_si128();
+    __m128i high = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // Sign-extend two ints at a time to 64 bits before adding.
+        low = _mm_add_epi64(low, _mm_cvtepi32_epi64(values));
+        high = _mm_add_epi64(high, _mm_cvtepi32_epi64(_mm_srli_si128(values, 8)));
+    }
+    __m128i total = _mm_add_epi64(low, high);
+    return _mm_cvtsi128_si64(total) + _mm_extract_epi64(total, 1) + sumScalar(data + i, count - i);
+}
+
+__attribute__((target("avx2")))
+std::int64_t sumAvx2(const int* data, size_t count) {
+    __m256i partial[4] = { _mm256_setzero_si256(), _mm256_setzero_si256(),
+                           _mm256_setzero_si256(), _mm256_setzero_si256() };
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 4 * lane));
+            partial[lane] = _mm256_add_epi64(partial[lane], _mm256_cvtepi32_epi64(values));
+        }
+    }
+    __m256i total = _mm256_add_epi64(_mm256_add_epi64(partial[0], partial[1]),
+                                     _mm256_add_epi64(partial[2], partial[3]));
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+    return _mm_cvtsi128_si64(half) + _mm_extract_epi64(half, 1) + sumScalar(data + i, count - i);
+}
+#endif
+
+bool isSupported(SumKernel kernel) {
+    switch (kernel) {
+        case SumKernel::Scalar:
+            return true;
+#ifdef DAY01_SUM_X86
+        case SumKernel::Sse41:
+            return __builtin_cpu_supports("sse4.1");
+        case SumKernel::Avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+SumKernel bestSumKernel() {
+    static const SumKernel best = isSupported(SumKernel::Avx2) ? SumKernel::Avx2
+                                : isSupported(SumKernel::Sse41) ? SumKernel::Sse41
+                                : SumKernel::Scalar;
+    return best;
+}
+
+const char* kernelName(SumKernel kernel) {
+    switch (kernel) {
+        case SumKernel::Sse41:
+            return "SSE4.1";
+        case SumKernel::Avx2:
+            return "AVX2";
+        default:
+            return "scalar";
+    }
+}
+
+// The SIMD kernels only exist for int; every other type sums with the
+// scalar one, which the compiler is free to vectorize.
+template <typename T>
+WideSum<T> sumRange(const T* data, size_t count, SumKernel kernel) {
+#ifdef DAY01_SUM_X86
+    if constexpr (std::is_same_v<T, int>) {
+        switch (kernel) {
+            case SumKernel::Avx2:
+                return sumAvx2(data, count);
+            case SumKernel::Sse41:
+                return sumSse41(data, count);
+            default:
+                break;
+        }
+    }
+#endif
+    (void) kernel;
+    return sumScalar(data, count);
+}
+
+// Sums count values starting at data. Ranges of at least
+// kParallelSumThreshold elements are split into one part per thread
+// (threads == 0 means one per hardware thread), and the parts' sums added.
+template <typename T>
+WideSum<T> reduceSum(const T* data, size_t count, unsigned threads = 0,
+                     SumKernel kernel = bestSumKernel()) {
+    if (!isSupported(kernel)) {
+        kernel = SumKernel::Scalar;
+    }
+    // Small ranges skip asking for the thread count, which is a system call.
+    if (count < kParallelSumThreshold || threads == 1) {
+        return sumRange(data, count, kernel);
+    }
+    size_t workers = threads != 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<WideSum<T>> partial(workers);
+    std::vector<std::thread> helpers;
+    for (size_t worker = 1; worker < workers; ++worker) {
+        size_t begin = count * worker / workers;
+        size_t end = count * (worker + 1) / workers;
+        helpers.emplace_back([&partial, worker, data, begin, end, kernel] {
+            partial[worker] = sumRange(data + begin, end - begin, kernel);
+        });
+    }
+    partial[0] = sumRange(data, count / workers, kernel);
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+    WideSum<T> sum = 0;
+    for (WideSum<T> part : partial) {
+        sum += part;
     }
     return sum;
 }
 
-int main() 
+// Initializer list
+template <typename T>
+WideSum<T> makeSum(std::initializer_list<T> nums) {
+    return reduceSum(std::data(nums), std::size(nums));
+}
+
+// Any other contiguous range
+template <typename Range>
+auto makeSum(const Range& range) {
+    return reduceSum(std::data(range), std::size(range));
+}
+
+// Billions of ints summed per second, for every range size from 16
+// elements up to maxCount, growing fourfold. Each kernel's sum is checked
+// against the scalar one.
+int runSumBenchmark(size_t maxCount) {
+    std::mt19937 rng(1);
+    std::vector<int> values(std::max<size_t>(maxCount, 16));
+    for (int& value : values) {
+        // The whole int range, so an int accumulator would overflow.
+        value = static_cast<int>(rng());
+    }
+
+    std::vector<SumKernel> kernels;
+    for (SumKernel kernel : { SumKernel::Scalar, SumKernel::Sse41, SumKernel::Avx2 }) {
+        if (isSupported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "Gints/s by range size" << std::endl << std::setw(12) << "elements";
+    for (SumKernel kernel : kernels) {
+        std::cout << std::setw(10) << kernelName(kernel);
+    }
+    std::cout << std::setw(10) << "threads" << std::endl;
+
+    bool identical = true;
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t count = 16; count <= values.size(); count *= 4) {
+        // Repeat small ranges so each timing covers enough work to measure.
+        size_t repeats = std::max<size_t>((size_t{1} << 26) / count, 1);
+        std::int64_t expected = 0;
+        std::cout << std::setw(12) << count;
+        auto run = [&](SumKernel kernel, unsigned threads) {
+            std::int64_t sum = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t repeat = 0; repeat < repeats; ++repeat) {
+                // Keeps the compiler from summing once and reusing the result.
+                asm volatile("" : : "r"(values.data()) : "memory");
+                sum = reduceSum(values.data(), count, threads, kernel);
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (kernel == SumKernel::Scalar && threads == 1) {
+                expected = sum;
+            }
+            bool same = sum == expected;
+            identical = identical && same;
+            std::cout << std::setw(10) << static_cast<double>(count * repeats) / elapsed.count() / 1e9
+                      << (same ? "" : "  MISMATCH");
+        };
+        for (SumKernel kernel : kernels) {
+            run(kernel, 1);
+        }
+        // The best kernel on every hardware thread.
+        run(bestSumKernel(), 0);
+        std::cout << std::endl;
+    }
+    return identical ? 0 : 1;
+}
+
+// Usage: day01 [elements]
+// With an element count, benchmarks makeSum's reductions on ranges of up
+// to that many ints (1073741824 for 1G) instead of the examples.
+int main(int argc, char* argv[])
 {
+    if (argc > 1) {
+        return runSumBenchmark(std::strtoull(argv[1], nullptr, 10));
+    }
+
     // struct binding
     // * variable can be declared with number of variables in the struct, array, tuple, etc.
     // * the declared variables must match the number of elements in the struct, array, tuple, etc.
@@ -25,8 +277,11 @@ int main()
     std::cout << "a: " << a << ", b: " << b << ", c: " << c << std::endl;
 
     // Example: Function with Initializer List
-    int sum = makeSum({1, 2, 3, 4, 5});
+    auto sum = makeSum({1, 2, 3, 4, 5});
     std::cout << "Sum: " << sum << std::endl;
 
+    // Example: any contiguous range, such as the array above
+    std::cout << "Sum of arr: " << makeSum(arr) << std::endl;
+
     return 0;
 }
\ No newline at end of file
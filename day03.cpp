@@ -2,8 +2,19 @@
 * Dynamically allocate memory for an array.
 */
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <thread>
+#include <utility>
 #include <vector>
 
 
@@ -46,8 +57,383 @@ double divide(double a, double b)
 }
 
 
-int main()
+/*
+* Pooled arrays
+*
+* Code that allocates short-lived scratch arrays in a loop spends much of
+* its time in the allocator. ArrayPool keeps freed blocks for reuse in
+* power-of-two size classes, from 16 bytes to 64 KiB:
+*  - each thread first takes from and returns to its own cache, with no lock;
+*  - a cache that runs dry refills, or one that grows too big drains, a
+*    batch of blocks at a time to a depot shared by all threads;
+*  - the depot carves new blocks out of 64 KiB chunks, which it keeps for
+*    the life of the program.
+* Larger arrays go straight to operator new.
+*
+* Chunks are 64-byte aligned and carved at multiples of the class size, so
+* every block of 64 bytes or more starts on a cache line, as SIMD loads and
+* stores like. PooledArray<T, 64> (SimdArray<T>) asks for that alignment.
+*/
+class ArrayPool
+{
+    public:
+        static const size_t kAlignment = 64;
+        static const size_t kLargestClass = 64 * 1024;
+
+        // At least bytes of storage, aligned to the smaller of kAlignment
+        // and the size class, or to kAlignment for large arrays.
+        static void* allocate(size_t bytes);
+        // Takes back a block from allocate(), which must be given the same
+        // bytes. Any thread may return any thread's block.
+        static void deallocate(void* block, size_t bytes);
+
+    private:
+        static const size_t kSmallestClass = 16;
+        static const size_t kClassCount = 13;   // 16 bytes to 64 KiB
+        static const size_t kChunkBytes = 64 * 1024;
+        static const size_t kCacheBytes = 256 * 1024;
+
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        struct FreeList
+        {
+            FreeBlock* head = nullptr;
+            size_t count = 0;
+
+            void push(void* block)
+            {
+                FreeBlock* freed = static_cast<FreeBlock*>(block);
+                freed->next = head;
+                head = freed;
+                ++count;
+            }
+            void* pop()
+            {
+                FreeBlock* taken = head;
+                head = taken->next;
+                --count;
+                return taken;
+            }
+        };
+
+        // Shared by every thread.
+        struct Depot
+        {
+            std::mutex lock;
+            FreeList lists[kClassCount];
+            std::vector<void*> chunks;
+        };
+
+        // One thread's blocks, handed back to the depot when the thread ends.
+        // Arrays freed after that, such as statics released once main
+        // returns, go straight to the depot.
+        struct ThreadCache
+        {
+            FreeList lists[kClassCount];
+            ~ThreadCache();
+        };
+
+        static size_t classOf(size_t bytes)
+        {
+            return bytes <= kSmallestClass ? 0 : 64 - static_cast<size_t>(__builtin_clzll(bytes - 1)) - 4;
+        }
+        static size_t classBytes(size_t index) { return kSmallestClass << index; }
+        // Blocks a thread keeps of one class before draining half of them.
+        static size_t maxCached(size_t index)
+        {
+            return std::min<size_t>(64, std::max<size_t>(kCacheBytes / classBytes(index), 2));
+        }
+        static void move(FreeList& from, FreeList& to, size_t count)
+        {
+            while (count-- > 0 && from.head != nullptr) {
+                to.push(from.pop());
+            }
+        }
+
+        // Never destroyed, so threads that exit after main still find it.
+        static Depot& depot()
+        {
+            static Depot* theDepot = new Depot;
+            return *theDepot;
+        }
+        // Set once this thread's cache is destroyed. A plain bool has no
+        // destructor, so it can still be read after the cache is gone.
+        static bool& cacheDestroyed()
+        {
+            thread_local bool destroyed = false;
+            return destroyed;
+        }
+        // This thread's cache, or nullptr once it has been destroyed.
+        static ThreadCache* threadCache()
+        {
+            if (cacheDestroyed()) {
+                return nullptr;
+            }
+            thread_local ThreadCache cache;
+            return &cache;
+        }
+        // Moves count blocks of a class from the depot to cached.
+        static void refill(size_t index, FreeList& cached, size_t count);
+};
+
+ArrayPool::ThreadCache::~ThreadCache()
+{
+    cacheDestroyed() = true;
+    Depot& shared = depot();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    for (size_t index = 0; index < kClassCount; ++index) {
+        move(lists[index], shared.lists[index], lists[index].count);
+    }
+}
+
+void ArrayPool::refill(size_t index, FreeList& cached, size_t count)
+{
+    Depot& shared = depot();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    FreeList& spare = shared.lists[index];
+    if (spare.head == nullptr) {
+        char* chunk = static_cast<char*>(::operator new(kChunkBytes, std::align_val_t{kAlignment}));
+        shared.chunks.push_back(chunk);
+        for (size_t offset = 0; offset < kChunkBytes; offset += classBytes(index)) {
+            spare.push(chunk + offset);
+        }
+    }
+    move(spare, cached, count);
+}
+
+void* ArrayPool::allocate(size_t bytes)
+{
+    if (bytes > kLargestClass) {
+        return ::operator new(bytes, std::align_val_t{kAlignment});
+    }
+    size_t index = classOf(bytes);
+    ThreadCache* cache = threadCache();
+    if (cache == nullptr) {
+        FreeList taken;
+        refill(index, taken, 1);
+        return taken.pop();
+    }
+    FreeList& cached = cache->lists[index];
+    if (cached.head == nullptr) {
+        refill(index, cached, maxCached(index) / 2);
+    }
+    return cached.pop();
+}
+
+void ArrayPool::deallocate(void* block, size_t bytes)
 {
+    if (bytes > kLargestClass) {
+        ::operator delete(block, std::align_val_t{kAlignment});
+        return;
+    }
+    size_t index = classOf(bytes);
+    ThreadCache* cache = threadCache();
+    if (cache == nullptr) {
+        Depot& shared = depot();
+        std::lock_guard<std::mutex> guard(shared.lock);
+        shared.lists[index].push(block);
+        return;
+    }
+    FreeList& cached = cache->lists[index];
+    cached.push(block);
+    if (cached.count > maxCached(index)) {
+        Depot& shared = depot();
+        std::lock_guard<std::mutex> guard(shared.lock);
+        move(cached, shared.lists[index], maxCached(index) / 2);
+    }
+}
+
+// A fixed-size array of T in pooled storage, aligned to Alignment bytes.
+// Like unique_ptr<T[]> it owns its elements and can be moved but not
+// copied; unlike it, it knows its size. Elements are default-initialized,
+// as by new T[size].
+template <typename T, size_t Alignment = alignof(T)>
+class PooledArray
+{
+    static_assert(Alignment >= alignof(T) && Alignment <= ArrayPool::kAlignment
+                  && (Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be a power of two from alignof(T) to 64");
+
+    public:
+        PooledArray() = default;
+        explicit PooledArray(size_t size)
+            : mData(acquire(size))
+            , mSize(size)
+        {
+            try {
+                std::uninitialized_default_construct_n(mData, size);
+            } catch (...) {
+                ArrayPool::deallocate(mData, bytes(size));
+                throw;
+            }
+        }
+        PooledArray(size_t size, const T& value)
+            : mData(acquire(size))
+            , mSize(size)
+        {
+            try {
+                std::uninitialized_fill_n(mData, size, value);
+            } catch (...) {
+                ArrayPool::deallocate(mData, bytes(size));
+                throw;
+            }
+        }
+        ~PooledArray() { release(); }
+
+        PooledArray(PooledArray&& other) noexcept
+            : mData(std::exchange(other.mData, nullptr))
+            , mSize(std::exchange(other.mSize, 0))
+        {
+        }
+        PooledArray& operator=(PooledArray&& other) noexcept
+        {
+            if (this != &other) {
+                release();
+                mData = std::exchange(other.mData, nullptr);
+                mSize = std::exchange(other.mSize, 0);
+            }
+            return *this;
+        }
+        PooledArray(const PooledArray&) = delete;
+        PooledArray& operator=(const PooledArray&) = delete;
+
+        T& operator[](size_t index) { return mData[index]; }
+        const T& operator[](size_t index) const { return mData[index]; }
+        T* data() { return mData; }
+        const T* data() const { return mData; }
+        size_t size() const { return mSize; }
+        T* begin() { return mData; }
+        T* end() { return mData + mSize; }
+        const T* begin() const { return mData; }
+        const T* end() const { return mData + mSize; }
+
+    private:
+        // Never less than Alignment, so the block comes from a class that
+        // is aligned at least that well.
+        static size_t bytes(size_t size) { return std::max(size * sizeof(T), Alignment); }
+
+        static T* acquire(size_t size)
+        {
+            if (size == 0) {
+                return nullptr;
+            }
+            if (size > SIZE_MAX / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T*>(ArrayPool::allocate(bytes(size)));
+        }
+
+        void release()
+        {
+            if (mData != nullptr) {
+                std::destroy_n(mData, mSize);
+                ArrayPool::deallocate(mData, bytes(mSize));
+                mData = nullptr;
+                mSize = 0;
+            }
+        }
+
+        T* mData = nullptr;
+        size_t mSize = 0;
+};
+
+// For arrays processed with SIMD loads and stores.
+template <typename T>
+using SimdArray = PooledArray<T, ArrayPool::kAlignment>;
+
+// Allocations per second under churn: each thread replaces, one at a
+// time, the arrays in a ring of 64 live ones with a new array of 4 to
+// 8192 ints, writing its first and last element. Runs on one thread and
+// on every hardware thread (at least two).
+int runAllocationBenchmark(size_t allocations)
+{
+    const size_t kLive = 64;
+    std::mt19937 rng(1);
+    std::vector<size_t> sizes(4096);
+    for (size_t& size : sizes) {
+        size_t base = size_t{4} << (rng() % 11);
+        size = base + rng() % base;
+    }
+
+    // Runs churn(allocations per thread) on workers threads at once and
+    // returns the seconds taken.
+    auto time = [&](unsigned workers, auto churn) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> helpers;
+        for (unsigned worker = 1; worker < workers; ++worker) {
+            helpers.emplace_back(churn, allocations / workers);
+        }
+        churn(allocations / workers);
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    };
+    auto newArray = [&](size_t count) {
+        int* live[kLive] = {};
+        for (size_t i = 0; i < count; ++i) {
+            size_t size = sizes[i % sizes.size()];
+            delete[] live[i % kLive];
+            live[i % kLive] = new int[size];
+            live[i % kLive][0] = live[i % kLive][size - 1] = static_cast<int>(i);
+        }
+        for (int* array : live) {
+            delete[] array;
+        }
+    };
+    auto uniqueArray = [&](size_t count) {
+        std::unique_ptr<int[]> live[kLive];
+        for (size_t i = 0; i < count; ++i) {
+            size_t size = sizes[i % sizes.size()];
+            live[i % kLive] = std::make_unique<int[]>(size);
+            live[i % kLive][0] = live[i % kLive][size - 1] = static_cast<int>(i);
+        }
+    };
+    auto pooledArray = [&](size_t count) {
+        PooledArray<int> live[kLive];
+        for (size_t i = 0; i < count; ++i) {
+            size_t size = sizes[i % sizes.size()];
+            live[i % kLive] = PooledArray<int>(size);
+            live[i % kLive][0] = live[i % kLive][size - 1] = static_cast<int>(i);
+        }
+    };
+    auto simdArray = [&](size_t count) {
+        SimdArray<int> live[kLive];
+        for (size_t i = 0; i < count; ++i) {
+            size_t size = sizes[i % sizes.size()];
+            live[i % kLive] = SimdArray<int>(size);
+            live[i % kLive][0] = live[i % kLive][size - 1] = static_cast<int>(i);
+        }
+    };
+
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 2u);
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (unsigned workers : { 1u, threads }) {
+        std::cout << workers << " thread(s), million allocations/s:" << std::endl;
+        std::cout << "  new int[]:               " << allocations / time(workers, newArray) / 1e6 << std::endl;
+        // make_unique<int[]> also zeroes every element.
+        std::cout << "  make_unique<int[]>:      " << allocations / time(workers, uniqueArray) / 1e6 << std::endl;
+        std::cout << "  PooledArray<int>:        " << allocations / time(workers, pooledArray) / 1e6 << std::endl;
+        std::cout << "  SimdArray<int>:          " << allocations / time(workers, simdArray) / 1e6 << std::endl;
+    }
+    return 0;
+}
+
+
+// Usage: day03 [allocations]
+// With an allocation count, benchmarks pooled arrays instead of the examples.
+int main(int argc, char* argv[])
+{
+    if (argc > 1) {
+        return runAllocationBenchmark(std::strtoull(argv[1], nullptr, 10));
+    }
+
+
     // Dynamically allocate memory for an array of integers in heap
     int size = 6;
     int* my_array = new int[size];
@@ -132,6 +518,21 @@ int main()
     // By default use unique_ptr instead of raw pointers
     // but if you need shared ownership, use shared_ptr
 
+    // Scratch arrays allocated over and over can come from a pool instead
+    // (see PooledArray above); it frees itself like unique_ptr does.
+    PooledArray<int> pooledArray(5, 0);
+    for (size_t i = 0; i < pooledArray.size(); ++i) {
+        pooledArray[i] = static_cast<int>(i) * 40;
+    }
+    std::cout << "Values in pooledArray: ";
+    for (int value : pooledArray) {
+        std::cout << value << " ";
+    }
+    std::cout << std::endl;
+    SimdArray<float> simdArray(16);
+    std::cout << "simdArray is 64-byte aligned: "
+              << (reinterpret_cast<std::uintptr_t>(simdArray.data()) % 64 == 0 ? "yes" : "no") << std::endl;
+
 
     //////////////
     // Reference//
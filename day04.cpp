@@ -3,8 +3,25 @@
 * Class
 */
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DAY04_PRICING_X86 1
+#endif
 
 
 /*
@@ -15,11 +32,49 @@
 */
 
 
+/*
+* Fare rules
+*
+* Each fare class is a type whose pricing rules are compile-time constants.
+* Code templated on a fare (the method and the batch kernels below) gets
+* them folded in as immediates, so a fare class costs nothing at run time.
+*/
+struct SaverFare
+{
+    static constexpr double kBasePrice = 60.0;     // Base price in dollars
+    static constexpr double kPricePerMile = 0.08;  // Price per mile in dollars
+    static constexpr double kEliteDiscount = 0.95; // 5% discount for elite members
+};
+
+struct StandardFare
+{
+    static constexpr double kBasePrice = 100.0;
+    static constexpr double kPricePerMile = 0.1;
+    static constexpr double kEliteDiscount = 0.9;
+};
+
+struct FlexibleFare
+{
+    static constexpr double kBasePrice = 150.0;
+    static constexpr double kPricePerMile = 0.12;
+    static constexpr double kEliteDiscount = 0.85;
+};
+
+// The price of one ticket under Fare.
+template <typename Fare>
+inline double fareInDollars(int miles, bool elite)
+{
+    double totalPrice = Fare::kBasePrice + (miles * Fare::kPricePerMile);
+    return elite ? totalPrice * Fare::kEliteDiscount : totalPrice;
+}
+
+
 class AirlineTicket
 {
     public:   // can be accessed from outside the class
         AirlineTicket();
         ~AirlineTicket();
+        template <typename Fare = StandardFare>
         double calculatePriceInDollars() const;
         const std::string& getPassengerName() const;
         void setPassengerName(const std::string& name);
@@ -84,18 +139,13 @@ AirlineTicket::~AirlineTicket()
 }
 
 // Definition of methods
+// A member template: ticket.calculatePriceInDollars<SaverFare>() prices the
+// ticket as a saver fare, plain calculatePriceInDollars() as a standard one.
+template <typename Fare>
 double AirlineTicket::calculatePriceInDollars() const
 {
     // Example logic for calculating price based on miles and elite status
-    double basePrice = 100.0; // Base price in dollars
-    double pricePerMile = 0.1; // Price per mile in dollars
-    double totalPrice = basePrice + (mNumberOfMiles * pricePerMile);
-    
-    if (mHasEliteSuperRewardsStatus) {
-        totalPrice *= 0.9; // 10% discount for elite members
-    }
-    
-    return totalPrice;
+    return fareInDollars<Fare>(mNumberOfMiles, mHasEliteSuperRewardsStatus);
 }
 const std::string& AirlineTicket::getPassengerName() const
 {
@@ -123,9 +173,552 @@ void AirlineTicket::setHasEliteSuperRewardsStatus(bool status)
 }
 
 
+/*
+* Batch pricing
+*
+* Fare quoting prices millions of tickets at a time. Instead of one object
+* per ticket, the batch API takes the two inputs as separate arrays (a
+* "structure of arrays"), so the SIMD kernels below can load several
+* tickets' miles, or elite flags, with one instruction.
+*
+* Every kernel does the same double operations in the same order as
+* calculatePriceInDollars(): convert, multiply, add, then multiply by the
+* discount. Each is correctly rounded, so the results are bit-identical as
+* long as the compiler does not fuse a multiply and add into an FMA, which
+* the build turns off for this file (-ffp-contract=off).
+*/
+enum class PricingKernel
+{
+    Scalar,
+    Sse2,   // two tickets per instruction
+    Avx2    // four tickets per instruction
+};
+
+// Batches smaller than this are priced on the calling thread alone.
+const size_t kParallelPricingThreshold = 1 << 16;
+
+template <typename Fare>
+void priceRangeScalar(const int* miles, const bool* elite, double* prices, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i) {
+        prices[i] = fareInDollars<Fare>(miles[i], elite[i]);
+    }
+}
+
+#ifdef DAY04_PRICING_X86
+template <typename Fare>
+__attribute__((target("sse2")))
+void priceRangeSse2(const int* miles, const bool* elite, double* prices, size_t begin, size_t end)
+{
+    const __m128d base = _mm_set1_pd(Fare::kBasePrice);
+    const __m128d perMile = _mm_set1_pd(Fare::kPricePerMile);
+    const __m128d discount = _mm_set1_pd(Fare::kEliteDiscount);
+    size_t i = begin;
+    for (; i + 2 <= end; i += 2) {
+        __m128d distance = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(miles + i)));
+        __m128d price = _mm_add_pd(base, _mm_mul_pd(distance, perMile));
+        // All ones in the lanes of elite tickets.
+        __m128d isElite = _mm_castsi128_pd(_mm_set_epi64x(-static_cast<long long>(elite[i + 1]),
+                                                          -static_cast<long long>(elite[i])));
+        __m128d discounted = _mm_mul_pd(price, discount);
+        price = _mm_or_pd(_mm_and_pd(isElite, discounted), _mm_andnot_pd(isElite, price));
+        _mm_storeu_pd(prices + i, price);
+    }
+    priceRangeScalar<Fare>(miles, elite, prices, i, end);
+}
+
+template <typename Fare>
+__attribute__((target("avx2")))
+void priceRangeAvx2(const int* miles, const bool* elite, double* prices, size_t begin, size_t end)
+{
+    const __m256d base = _mm256_set1_pd(Fare::kBasePrice);
+    const __m256d perMile = _mm256_set1_pd(Fare::kPricePerMile);
+    const __m256d discount = _mm256_set1_pd(Fare::kEliteDiscount);
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d distance = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(miles + i)));
+        __m256d price = _mm256_add_pd(base, _mm256_mul_pd(distance, perMile));
+        // Widen four one-byte flags to four 64-bit lanes, all ones if set.
+        int flags;
+        std::memcpy(&flags, elite + i, sizeof(flags));
+        __m256i wide = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(flags));
+        __m256d isElite = _mm256_castsi256_pd(_mm256_cmpgt_epi64(wide, _mm256_setzero_si256()));
+        price = _mm256_blendv_pd(price, _mm256_mul_pd(price, discount), isElite);
+        _mm256_storeu_pd(prices + i, price);
+    }
+    priceRangeScalar<Fare>(miles, elite, prices, i, end);
+}
+#endif
+
+bool isSupported(PricingKernel kernel)
+{
+    switch (kernel) {
+        case PricingKernel::Scalar:
+            return true;
+#ifdef DAY04_PRICING_X86
+        case PricingKernel::Sse2:
+            return __builtin_cpu_supports("sse2");
+        case PricingKernel::Avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+PricingKernel bestPricingKernel()
+{
+    static const PricingKernel best = isSupported(PricingKernel::Avx2) ? PricingKernel::Avx2
+                                    : isSupported(PricingKernel::Sse2) ? PricingKernel::Sse2
+                                    : PricingKernel::Scalar;
+    return best;
+}
+
+const char* kernelName(PricingKernel kernel)
+{
+    switch (kernel) {
+        case PricingKernel::Sse2:
+            return "SSE2";
+        case PricingKernel::Avx2:
+            return "AVX2";
+        default:
+            return "scalar";
+    }
+}
+
+template <typename Fare>
+void priceRange(PricingKernel kernel, const int* miles, const bool* elite, double* prices,
+                size_t begin, size_t end)
+{
+    switch (kernel) {
+#ifdef DAY04_PRICING_X86
+        case PricingKernel::Avx2:
+            priceRangeAvx2<Fare>(miles, elite, prices, begin, end);
+            break;
+        case PricingKernel::Sse2:
+            priceRangeSse2<Fare>(miles, elite, prices, begin, end);
+            break;
+#endif
+        default:
+            priceRangeScalar<Fare>(miles, elite, prices, begin, end);
+            break;
+    }
+}
+
+// Prices count tickets, whose miles and elite status are in the arrays
+// miles and elite, into prices. prices[i] is bit-identical to what
+// calculatePriceInDollars<Fare>() returns for ticket i. Batches of at least
+// kParallelPricingThreshold tickets are split into one range per thread
+// (threads == 0 means one per hardware thread).
+template <typename Fare = StandardFare>
+void priceTicketsInDollars(const int* miles, const bool* elite, double* prices, size_t count,
+                           unsigned threads = 0, PricingKernel kernel = bestPricingKernel())
+{
+    if (!isSupported(kernel)) {
+        kernel = PricingKernel::Scalar;
+    }
+    size_t workers = threads != 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+    if (count < kParallelPricingThreshold) {
+        workers = 1;
+    }
+    std::vector<std::thread> helpers;
+    for (size_t worker = 1; worker < workers; ++worker) {
+        helpers.emplace_back(priceRange<Fare>, kernel, miles, elite, prices,
+                             count * worker / workers, count * (worker + 1) / workers);
+    }
+    priceRange<Fare>(kernel, miles, elite, prices, 0, count / workers);
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+}
+
+// Fare classes chosen at run time, such as from a booking request.
+enum class FareClass
+{
+    Saver,
+    Standard,
+    Flexible
+};
+const size_t kFareClassCount = 3;
 
-int main ()
+const char* fareName(FareClass fare)
 {
+    switch (fare) {
+        case FareClass::Saver:
+            return "saver";
+        case FareClass::Flexible:
+            return "flexible";
+        default:
+            return "standard";
+    }
+}
+
+// One fully specialized batch pricer per fare class, indexed by FareClass.
+// The fare is looked up once per batch; the loops inside see constants.
+using BatchPricer = void (*)(const int* miles, const bool* elite, double* prices, size_t count,
+                             unsigned threads, PricingKernel kernel);
+const BatchPricer kBatchPricers[kFareClassCount] = {
+    priceTicketsInDollars<SaverFare>,
+    priceTicketsInDollars<StandardFare>,
+    priceTicketsInDollars<FlexibleFare>
+};
+
+void priceTicketsInDollars(FareClass fare, const int* miles, const bool* elite, double* prices,
+                           size_t count, unsigned threads = 0, PricingKernel kernel = bestPricingKernel())
+{
+    kBatchPricers[static_cast<size_t>(fare)](miles, elite, prices, count, threads, kernel);
+}
+
+// The baseline the templates replace: a fare configured at run time behind
+// a virtual call per ticket, which the compiler can neither inline nor
+// vectorize across.
+class FarePolicy
+{
+    public:
+        virtual ~FarePolicy() = default;
+        virtual double priceInDollars(int miles, bool elite) const = 0;
+};
+
+template <typename Fare>
+class FixedFarePolicy : public FarePolicy
+{
+    public:
+        double priceInDollars(int miles, bool elite) const override
+        {
+            return fareInDollars<Fare>(miles, elite);
+        }
+};
+
+const FarePolicy& farePolicy(FareClass fare)
+{
+    static const FixedFarePolicy<SaverFare> saver;
+    static const FixedFarePolicy<StandardFare> standard;
+    static const FixedFarePolicy<FlexibleFare> flexible;
+    static const FarePolicy* const policies[kFareClassCount] = { &saver, &standard, &flexible };
+    return *policies[static_cast<size_t>(fare)];
+}
+
+// Out of line, so the benchmark cannot devirtualize it for a known fare.
+__attribute__((noinline))
+void priceTicketsVirtual(const FarePolicy& policy, const int* miles, const bool* elite, double* prices,
+                         size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        prices[i] = policy.priceInDollars(miles[i], elite[i]);
+    }
+}
+
+/*
+* Fare cache
+*
+* Quotes on popular routes keep asking for the same (miles, elite) pair.
+* FareCache remembers up to a fixed number of prices and can be shared by
+* any number of pricing threads. It is split into shards, each with its
+* own lock, so threads pricing different keys rarely wait on each other.
+*
+* A full shard evicts with the CLOCK algorithm: entries sit in a ring, a
+* hit sets the entry's referenced bit, and the hand sweeps the ring,
+* clearing bits, until it finds an entry not used since its last pass.
+* That approximates LRU without relinking a list on every hit.
+*
+* A lookup costs a lock and a hash probe, which is more than today's fare
+* formula (see the benchmark); the cache earns its keep once pricing needs
+* something slower, such as taxes or a fare lookup.
+*/
+template <typename Fare = StandardFare>
+class FareCache
+{
+    public:
+        static const size_t kShardCount = 16;
+
+        explicit FareCache(size_t capacity)
+            : mShardCapacity(std::max<size_t>(capacity / kShardCount, 1))
+        {
+            for (Shard& shard : mShards) {
+                shard.index.reserve(mShardCapacity);
+                shard.entries.reserve(mShardCapacity);
+            }
+        }
+        FareCache(const FareCache&) = delete;
+        FareCache& operator=(const FareCache&) = delete;
+
+        // What ticket.calculatePriceInDollars<Fare>() returns.
+        double priceInDollars(const AirlineTicket& ticket)
+        {
+            return priceInDollars(ticket.getNumberOfMiles(), ticket.hasEliteSuperRewardsStatus());
+        }
+
+        double priceInDollars(int miles, bool elite)
+        {
+            uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(miles)) << 1) | (elite ? 1 : 0);
+            Shard& shard = mShards[shardOf(key)];
+            std::lock_guard<std::mutex> guard(shard.lock);
+            auto found = shard.index.find(key);
+            if (found != shard.index.end()) {
+                ++shard.hits;
+                Entry& entry = shard.entries[found->second];
+                entry.referenced = true;
+                return entry.price;
+            }
+            ++shard.misses;
+            double price = fareInDollars<Fare>(miles, elite);
+            if (shard.entries.size() < mShardCapacity) {
+                shard.index.emplace(key, shard.entries.size());
+                shard.entries.push_back(Entry{ key, price, false });
+                return price;
+            }
+            while (shard.entries[shard.hand].referenced) {
+                shard.entries[shard.hand].referenced = false;
+                shard.hand = (shard.hand + 1) % shard.entries.size();
+            }
+            Entry& victim = shard.entries[shard.hand];
+            shard.index.erase(victim.key);
+            shard.index.emplace(key, shard.hand);
+            victim = Entry{ key, price, false };
+            shard.hand = (shard.hand + 1) % shard.entries.size();
+            return price;
+        }
+
+        uint64_t hits() const { return sum(&Shard::hits); }
+        uint64_t misses() const { return sum(&Shard::misses); }
+
+        size_t size() const
+        {
+            size_t total = 0;
+            for (const Shard& shard : mShards) {
+                std::lock_guard<std::mutex> guard(shard.lock);
+                total += shard.entries.size();
+            }
+            return total;
+        }
+
+    private:
+        struct Entry
+        {
+            uint64_t key;
+            double price;
+            bool referenced;
+        };
+
+        // Aligned so that two shards' locks never share a cache line.
+        struct alignas(64) Shard
+        {
+            mutable std::mutex lock;
+            std::unordered_map<uint64_t, size_t> index;  // key to slot in entries
+            std::vector<Entry> entries;                  // the CLOCK ring
+            size_t hand = 0;
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+        };
+
+        static size_t shardOf(uint64_t key)
+        {
+            // Fibonacci hashing: the top bits of the product mix every key bit.
+            return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 60) % kShardCount;
+        }
+
+        uint64_t sum(uint64_t Shard::* counter) const
+        {
+            uint64_t total = 0;
+            for (const Shard& shard : mShards) {
+                std::lock_guard<std::mutex> guard(shard.lock);
+                total += shard.*counter;
+            }
+            return total;
+        }
+
+        size_t mShardCapacity;
+        Shard mShards[kShardCount];
+};
+
+// Draws mile counts from 0 to values - 1 with Zipf's law: the k-th most
+// popular value comes up in proportion to 1 / k^skew. Which miles are
+// popular is shuffled, so the hot keys land in different shards.
+class ZipfianMiles
+{
+    public:
+        ZipfianMiles(int values, double skew, std::mt19937& rng)
+            : mCumulative(static_cast<size_t>(values))
+            , mMiles(static_cast<size_t>(values))
+        {
+            double total = 0.0;
+            for (int rank = 0; rank < values; ++rank) {
+                total += 1.0 / std::pow(rank + 1.0, skew);
+                mCumulative[static_cast<size_t>(rank)] = total;
+                mMiles[static_cast<size_t>(rank)] = rank;
+            }
+            for (double& bound : mCumulative) {
+                bound /= total;
+            }
+            std::shuffle(mMiles.begin(), mMiles.end(), rng);
+        }
+
+        int operator()(std::mt19937& rng) const
+        {
+            double draw = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+            size_t rank = static_cast<size_t>(std::upper_bound(mCumulative.begin(), mCumulative.end(), draw)
+                                              - mCumulative.begin());
+            return mMiles[std::min(rank, mMiles.size() - 1)];
+        }
+
+    private:
+        std::vector<double> mCumulative;
+        std::vector<int> mMiles;
+};
+
+// Per-ticket pricing with and without a shared FareCache, over count
+// tickets whose miles follow Zipf's law, on one thread and on every
+// hardware thread. Every cached price is checked against the method.
+int runFareCacheBenchmark(size_t count)
+{
+    const int kMileValues = 20000;
+    std::mt19937 rng(2);
+    // At least two, so the shared cache is always exercised concurrently.
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 2u);
+    std::vector<AirlineTicket> tickets(count);
+    std::vector<double> expected(count);
+    std::vector<double> prices(count);
+
+    // Runs price(begin, end) over the tickets split across workers threads.
+    auto time = [&](unsigned workers, auto&& price) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> helpers;
+        for (unsigned worker = 1; worker < workers; ++worker) {
+            helpers.emplace_back(price, count * worker / workers, count * (worker + 1) / workers);
+        }
+        price(size_t{0}, count / workers);
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    };
+
+    bool identical = true;
+    std::cout << std::fixed;
+    for (double skew : { 0.8, 0.99, 1.2 }) {
+        ZipfianMiles draw(kMileValues, skew, rng);
+        for (size_t i = 0; i < count; ++i) {
+            tickets[i].setNumberOfMiles(draw(rng));
+            tickets[i].setHasEliteSuperRewardsStatus(rng() % 4 == 0);
+        }
+        for (unsigned workers : { 1u, threads }) {
+            double seconds = time(workers, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    expected[i] = tickets[i].calculatePriceInDollars();
+                }
+            });
+            std::cout << std::setprecision(2) << "zipf " << skew << ", " << workers << " thread(s), uncached: "
+                      << std::setprecision(0) << count / seconds << " tickets/s" << std::endl;
+            for (size_t capacity : { size_t{1024}, size_t{8192} }) {
+                FareCache<> cache(capacity);
+                seconds = time(workers, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        prices[i] = cache.priceInDollars(tickets[i]);
+                    }
+                });
+                bool same = std::memcmp(prices.data(), expected.data(), count * sizeof(double)) == 0;
+                identical = identical && same;
+                double hitRate = 100.0 * static_cast<double>(cache.hits())
+                               / static_cast<double>(std::max<uint64_t>(cache.hits() + cache.misses(), 1));
+                std::cout << std::setprecision(2) << "zipf " << skew << ", " << workers << " thread(s), cache of "
+                          << capacity << ": " << std::setprecision(0) << count / seconds << " tickets/s, "
+                          << std::setprecision(1) << hitRate << "% hits" << (same ? "" : "  MISMATCH") << std::endl;
+            }
+        }
+    }
+    return identical ? 0 : 1;
+}
+
+// Tickets priced per second by each approach, over a batch of count
+// random tickets. Every batch result is checked against the method.
+int runPricingBenchmark(size_t count)
+{
+    std::mt19937 rng(1);
+    std::vector<AirlineTicket> tickets(count);
+    std::vector<int> miles(count);
+    std::unique_ptr<bool[]> elite(new bool[count]);
+    for (size_t i = 0; i < count; ++i) {
+        miles[i] = static_cast<int>(rng() % 20000);
+        elite[i] = rng() % 4 == 0;
+        tickets[i].setNumberOfMiles(miles[i]);
+        tickets[i].setHasEliteSuperRewardsStatus(elite[i]);
+    }
+
+    std::vector<double> expected(count);
+    auto time = [](auto&& fn) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    };
+    double seconds = time([&] {
+        for (size_t i = 0; i < count; ++i) {
+            expected[i] = tickets[i].calculatePriceInDollars();
+        }
+    });
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "calculatePriceInDollars():  " << count / seconds << " tickets/s" << std::endl;
+
+    bool identical = true;
+    std::vector<double> prices(count);
+    for (PricingKernel kernel : { PricingKernel::Scalar, PricingKernel::Sse2, PricingKernel::Avx2 }) {
+        if (!isSupported(kernel)) {
+            continue;
+        }
+        for (unsigned threads : { 1u, 0u }) {
+            std::fill(prices.begin(), prices.end(), 0.0);
+            seconds = time([&] {
+                priceTicketsInDollars(miles.data(), elite.get(), prices.data(), count, threads, kernel);
+            });
+            bool same = std::memcmp(prices.data(), expected.data(), count * sizeof(double)) == 0;
+            identical = identical && same;
+            std::cout << "batch, " << kernelName(kernel) << ", "
+                      << (threads == 1 ? "1 thread:  " : "all threads: ") << count / seconds
+                      << " tickets/s" << (same ? "" : "  MISMATCH") << std::endl;
+        }
+    }
+
+    // Per fare class, chosen at run time: a virtual call per ticket against
+    // the dispatch table, both on one thread.
+    std::vector<double> baseline(count);
+    for (size_t index = 0; index < kFareClassCount; ++index) {
+        FareClass fare = static_cast<FareClass>(index);
+        seconds = time([&] {
+            priceTicketsVirtual(farePolicy(fare), miles.data(), elite.get(), baseline.data(), count);
+        });
+        std::cout << fareName(fare) << " fare, virtual per ticket: " << count / seconds << " tickets/s" << std::endl;
+        for (PricingKernel kernel : { PricingKernel::Scalar, bestPricingKernel() }) {
+            std::fill(prices.begin(), prices.end(), 0.0);
+            seconds = time([&] {
+                priceTicketsInDollars(fare, miles.data(), elite.get(), prices.data(), count, 1, kernel);
+            });
+            bool same = std::memcmp(prices.data(), baseline.data(), count * sizeof(double)) == 0;
+            identical = identical && same;
+            std::cout << fareName(fare) << " fare, dispatch table, " << kernelName(kernel) << ": "
+                      << count / seconds << " tickets/s" << (same ? "" : "  MISMATCH") << std::endl;
+            if (kernel == bestPricingKernel()) {
+                break;
+            }
+        }
+    }
+    return identical ? 0 : 1;
+}
+
+
+// Usage: day04 [tickets]
+// With a ticket count, benchmarks batch pricing and the fare cache instead
+// of the example.
+int main (int argc, char* argv[])
+{
+    if (argc > 1) {
+        size_t count = std::strtoull(argv[1], nullptr, 10);
+        int pricing = runPricingBenchmark(count);
+        int cache = runFareCacheBenchmark(count);
+        return pricing != 0 ? pricing : cache;
+    }
+
     AirlineTicket ticket; // Create an instance of AirlineTicket
     ticket.setPassengerName("John Doe");
     ticket.setNumberOfMiles(1500);
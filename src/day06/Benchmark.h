@@ -0,0 +1,34 @@
+#pragma once
+
+/*
+ * Tiny timing helpers shared by the *Benchmark.cpp programs.
+ */
+
+#include <chrono>
+#include <cstddef>
+
+namespace Bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Keeps the optimizer from discarding a value that is otherwise unused.
+    template <typename T>
+    inline void doNotOptimize(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // Runs fn(i) for i in [0, iterations) and returns the mean time per call
+    // in nanoseconds.
+    template <typename Fn>
+    double nanosPerOp(std::size_t iterations, Fn&& fn)
+    {
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            fn(i);
+        }
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        return iterations == 0 ? 0.0 : elapsed.count() / static_cast<double>(iterations);
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * Importing a roster with one Database::addEmployee call per person
+ * against one Database::addEmployees call for the whole batch.
+ *
+ * Usage: BulkHireBenchmark [employees]   (default 10000000)
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Database.h"
+
+using namespace std;
+using namespace Records;
+
+template <typename Fn>
+static double seconds(Fn&& fn)
+{
+    auto start = Bench::Clock::now();
+    fn();
+    chrono::duration<double> elapsed = Bench::Clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+
+    vector<pair<string, string>> names;
+    names.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        names.emplace_back("First" + to_string(i % 4000), "Last" + to_string(i % 150000));
+    }
+
+    double perCall = seconds([&] {
+        Database db;
+        for (const auto& name : names)
+        {
+            db.addEmployee(name.first, name.second);
+        }
+        Bench::doNotOptimize(db.size());
+    });
+
+    double bulk = seconds([&] {
+        Database db;
+        Bench::doNotOptimize(db.addEmployees(names));
+    });
+
+    cout << "employees: " << count << endl << fixed;
+    cout << setw(16) << "addEmployee" << setw(10) << setprecision(3) << perCall << " s"
+         << setw(14) << setprecision(0) << static_cast<double>(count) / perCall << " hires/s" << endl;
+    cout << setw(16) << "addEmployees" << setw(10) << setprecision(3) << bulk << " s"
+         << setw(14) << setprecision(0) << static_cast<double>(count) / bulk << " hires/s" << endl;
+    return 0;
+}
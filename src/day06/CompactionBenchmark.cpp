@@ -0,0 +1,95 @@
+/*
+ * A roster where most records are former employees, before and after
+ * compaction: current-staff scans, lookups in each tier, the cost of
+ * compaction itself and its longest step, and the bytes an archived
+ * record takes.
+ *
+ * Usage: CompactionBenchmark [maxEmployees]   (default 1000000)
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "Benchmark.h"
+#include "Database.h"
+
+using namespace std;
+using namespace Records;
+
+int main(int argc, char* argv[])
+{
+    size_t maxEmployees = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+
+    for (size_t count = 10000; count <= maxEmployees; count *= 10)
+    {
+        // Years of turnover: three in four records are former employees.
+        Database db;
+        db.reserve(count);
+        mt19937 rng(7);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Employee& employee = db.addEmployee("First" + to_string(rng() % 2000), "Last" + to_string(rng() % 5000));
+            employee.setSalary(30000 + static_cast<int>(rng() % 150000));
+            if (rng() % 4 != 0)
+            {
+                employee.fire();
+            }
+        }
+
+        size_t scanOps = max<size_t>(1, 20000000 / count);
+        auto measure = [&]() {
+            double payroll = Bench::nanosPerOp(scanOps, [&](size_t) {
+                Bench::doNotOptimize(db.getPayroll(StatusFilter::Current).total);
+            });
+            double walk = Bench::nanosPerOp(scanOps, [&](size_t) {
+                size_t hired = 0;
+                for (const Employee& employee : db)
+                {
+                    hired += employee.isHired();
+                }
+                Bench::doNotOptimize(hired);
+            });
+            return make_pair(payroll / 1e3, walk / 1e3);
+        };
+        auto before = measure();
+
+        double longestStep = 0;
+        auto start = Bench::Clock::now();
+        for (bool finished = false; !finished; )
+        {
+            auto stepStart = Bench::Clock::now();
+            finished = db.compactStep();
+            chrono::duration<double, micro> step = Bench::Clock::now() - stepStart;
+            longestStep = max(longestStep, step.count());
+        }
+        chrono::duration<double, milli> total = Bench::Clock::now() - start;
+        auto after = measure();
+
+        Employee copy;
+        double hotLookup = Bench::nanosPerOp(200000, [&](size_t i) {
+            int number = kDefaultEmployeeNumber + static_cast<int>(i * 7919 % count);
+            if (!db.isArchived(number))
+            {
+                Bench::doNotOptimize(db.findEmployee(number, copy));
+            }
+        });
+        double anyLookup = Bench::nanosPerOp(200000, [&](size_t i) {
+            Bench::doNotOptimize(db.findEmployee(kDefaultEmployeeNumber + static_cast<int>(i * 7919 % count), copy));
+        });
+
+        cout << count << " employees, " << db.archivedCount() << " archived" << fixed << setprecision(2) << endl
+             << "  payroll of current staff  " << setw(10) << before.first << " us -> " << after.first << " us" << endl
+             << "  walk of the hot tier      " << setw(10) << before.second << " us -> " << after.second << " us" << endl
+             << "  compaction                " << setw(10) << total.count() << " ms, longest step "
+             << longestStep << " us" << endl
+             << "  lookup (hot / any tier)   " << setw(10) << hotLookup << " ns / " << anyLookup << " ns" << endl
+             << "  bytes per archived record " << setw(10)
+             << static_cast<double>(db.archivedBytes()) / static_cast<double>(db.archivedCount())
+             << " (an Employee is " << sizeof(Employee) << ")" << endl;
+    }
+    return 0;
+}
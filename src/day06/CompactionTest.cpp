@@ -0,0 +1,425 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConcurrentDatabase.h"
+#include "Database.h"
+#include "RosterCsv.h"
+#include "TestHelpers.h"
+
+using namespace std;
+using namespace Records;
+
+/*
+ * Compacts rosters a step at a time, in both layouts and with a salary
+ * index, while hiring, firing and raising in between, and checks after
+ * every step that lookups, queries and counters agree with a plain model
+ * of the roster and with a scan of the hot tier.
+ */
+
+struct Expected
+{
+    string firstName;
+    string lastName;
+    int salary;
+    bool hired;
+};
+
+static vector<int> hotNumbers(const Database& db)
+{
+    vector<int> numbers;
+    for (const Employee& employee : db)
+    {
+        numbers.push_back(employee.getEmployeeNumber());
+    }
+    return numbers;
+}
+
+static bool matchesModel(const Database& db, const map<int, Expected>& model)
+{
+    if (db.size() != model.size())
+    {
+        return false;
+    }
+    for (const auto& [number, expected] : model)
+    {
+        Employee employee;
+        if (!db.findEmployee(number, employee)
+            || employee.getFirstName() != expected.firstName
+            || employee.getLastName() != expected.lastName
+            || employee.getSalary() != expected.salary
+            || employee.isHired() != expected.hired
+            || (db.isArchived(number) && expected.hired))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Payroll queries, salary queries and counters against scans of the hot
+// tier and the archive, which the queries cover as one roster: the hot
+// tier in the order added, then the archive.
+static bool matchesScan(const Database& db)
+{
+    RosterCounters counters(db.getCounters().getLowest(), db.getCounters().getBucketWidth(),
+                            db.getCounters().getBucketCount());
+    vector<const Employee*> hot;
+    for (const Employee& employee : db)
+    {
+        hot.push_back(&employee);
+        counters.add(employee.getSalary(), employee.isHired());
+    }
+    db.forEachArchived([&](const Employee& employee) { counters.add(employee.getSalary(), employee.isHired()); });
+
+    // The columns hold the hot tier only, and nothing for the slots a
+    // compaction pass has freed so far.
+    if (db.getLayout() == StorageLayout::Columnar)
+    {
+        const EmployeeColumns& columns = db.getColumns();
+        for (bool hired : { true, false })
+        {
+            size_t count = 0;
+            long long payroll = 0;
+            for (const Employee* employee : hot)
+            {
+                count += employee->isHired() == hired;
+                payroll += employee->isHired() == hired ? employee->getSalary() : 0;
+            }
+            size_t visited = 0;
+            columns.forEach(hired, [&](size_t) { ++visited; });
+            if (columns.countHired(hired) != count || columns.totalSalary(hired) != payroll || visited != count)
+            {
+                return false;
+            }
+        }
+    }
+
+    vector<Employee> archived;
+    db.forEachArchived([&](const Employee& employee) { archived.push_back(employee); });
+    // Orderings list archived employees after the hot tier, by number.
+    sort(archived.begin(), archived.end(), [](const Employee& a, const Employee& b) {
+        return a.getEmployeeNumber() < b.getEmployeeNumber();
+    });
+    vector<const Employee*> everyone = hot;
+    for (const Employee& employee : archived)
+    {
+        everyone.push_back(&employee);
+    }
+
+    for (StatusFilter filter : { StatusFilter::Current, StatusFilter::Former, StatusFilter::All })
+    {
+        auto covered = [&](const Employee* employee) {
+            return filter == StatusFilter::All || employee->isHired() == (filter == StatusFilter::Current);
+        };
+        PayrollSummary expected;
+        size_t above = 0;
+        vector<size_t> histogram(8, 0);
+        vector<const Employee*> ranked;
+        for (const Employee* employee : everyone)
+        {
+            if (!covered(employee))
+            {
+                continue;
+            }
+            int salary = employee->getSalary();
+            expected.minSalary = expected.count == 0 ? salary : min(expected.minSalary, salary);
+            expected.maxSalary = expected.count == 0 ? salary : max(expected.maxSalary, salary);
+            ++expected.count;
+            expected.total += salary;
+            above += salary > 40000;
+            ++histogram[static_cast<size_t>(min(max((salary - 20000) / 5000, 0), 7))];
+            ranked.push_back(employee);
+        }
+        PayrollSummary payroll = db.getPayroll(filter);
+        if (payroll.count != expected.count || payroll.total != expected.total
+            || payroll.minSalary != expected.minSalary || payroll.maxSalary != expected.maxSalary
+            || db.countSalariesAbove(40000, filter) != above
+            || db.getSalaryHistogram(20000, 5000, 8, filter) != histogram)
+        {
+            return false;
+        }
+
+        vector<const Employee*> inRange;
+        copy_if(ranked.begin(), ranked.end(), back_inserter(inRange), [](const Employee* e) {
+            return e->getSalary() >= 31000 && e->getSalary() <= 31500;
+        });
+        stable_sort(inRange.begin(), inRange.end(), [](const Employee* a, const Employee* b) {
+            return a->getSalary() < b->getSalary();
+        });
+        vector<int> inRangeNumbers;
+        for (const Employee* employee : inRange)
+        {
+            inRangeNumbers.push_back(employee->getEmployeeNumber());
+        }
+
+        stable_sort(ranked.begin(), ranked.end(), [](const Employee* a, const Employee* b) {
+            return a->getSalary() > b->getSalary();
+        });
+        vector<int> top;
+        for (size_t i = 0; i < min<size_t>(ranked.size(), 25); ++i)
+        {
+            top.push_back(ranked[i]->getEmployeeNumber());
+        }
+        if (db.getTopEarners(25, filter) != top
+            || db.findEmployeesBySalary(31000, 31500, filter) != inRangeNumbers)
+        {
+            return false;
+        }
+
+        if (counters.headcount(filter) != db.getCounters().headcount(filter)
+            || counters.payroll(filter) != db.getCounters().payroll(filter))
+        {
+            return false;
+        }
+    }
+
+    // Name lookups list the hot tier in order, then archived employees by
+    // number, and find names only the archive holds.
+    map<pair<string, string>, vector<int>> byName;
+    for (const Employee* employee : everyone)
+    {
+        byName[{ string(employee->getFirstName()), string(employee->getLastName()) }].push_back(
+            employee->getEmployeeNumber());
+    }
+    for (const auto& [name, numbers] : byName)
+    {
+        if (db.findEmployees(name.first, name.second) != numbers)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void compactWhileChanging(StorageLayout layout, bool indexSalaries)
+{
+    Database db(layout);
+    if (indexSalaries)
+    {
+        db.indexSalaries();
+    }
+    map<int, Expected> model;
+    mt19937 rng(21);
+    uniform_int_distribution<int> pickSalary(30000, 32000);
+
+    auto hire = [&]() {
+        string last = "Last" + to_string(rng() % 50);
+        Employee& employee = db.addEmployee("First", last);
+        employee.setSalary(pickSalary(rng));
+        model[employee.getEmployeeNumber()] = { "First", last, employee.getSalary(), true };
+    };
+    auto randomNumber = [&]() {
+        return kDefaultEmployeeNumber + static_cast<int>(rng() % static_cast<unsigned>(model.size()));
+    };
+    for (int i = 0; i < 3000; ++i)
+    {
+        hire();
+    }
+    for (int i = 0; i < 1500; ++i)
+    {
+        int number = randomNumber();
+        db.getEmployee(number).fire();
+        model[number].hired = false;
+    }
+
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        bool finished = false;
+        while (!finished)
+        {
+            // A step keeps the order of the hot tier and drops exactly the
+            // records it archives.
+            vector<int> before = hotNumbers(db);
+            finished = db.compactStep(100);
+            vector<int> kept;
+            copy_if(before.begin(), before.end(), back_inserter(kept), [&](int number) {
+                return !db.isArchived(number);
+            });
+            CHECK(hotNumbers(db) == kept);
+            CHECK(matchesModel(db, model));
+            CHECK(matchesScan(db));
+
+            // Changes in between steps, including to archived employees,
+            // which brings them back.
+            for (int change = 0; change < 10; ++change)
+            {
+                int number = randomNumber();
+                switch (rng() % 4)
+                {
+                    case 0:
+                        hire();
+                        break;
+                    case 1:
+                        db.getEmployee(number).fire();
+                        model[number].hired = false;
+                        break;
+                    case 2:
+                        db.getEmployee(number).promote(100);
+                        model[number].salary += 100;
+                        break;
+                    default:
+                        db.getEmployee(number).hire();
+                        model[number].hired = true;
+                        break;
+                }
+            }
+        }
+        CHECK(matchesModel(db, model));
+    }
+
+    // With nothing changing, a pass leaves only current staff.
+    db.compact();
+    size_t former = 0;
+    for (const auto& [number, expected] : model)
+    {
+        former += !expected.hired;
+    }
+    CHECK(db.archivedCount() == former);
+    CHECK(db.archivedBytes() < former * 12);
+    CHECK(all_of(db.begin(), db.end(), [](const Employee& employee) { return employee.isHired(); }));
+    CHECK(matchesScan(db));
+    db.setSalaryBuckets(25000, 1000, 10);
+    CHECK(matchesScan(db));
+}
+
+int main()
+{
+    cout << "Archiving and bringing back." << endl;
+    {
+        Database db;
+        for (int i = 0; i < 10; ++i)
+        {
+            db.addEmployee("Employee", to_string(i)).setSalary(40000 + i);
+        }
+        for (int number : { 1002, 1005, 1007 })
+        {
+            db.getEmployee(number).fire();
+        }
+        CHECK(db.compactStep(1));
+        CHECK(db.archivedCount() == 3);
+        CHECK(db.size() == 10);
+        CHECK(hotNumbers(db) == vector<int>({ 1000, 1001, 1003, 1004, 1006, 1008, 1009 }));
+        CHECK(db.isArchived(1005) && db.contains(1005) && !db.contains(1010));
+        CHECK(db.getCounters().headcount(StatusFilter::Former) == 3);
+        // Archived employees still count as former ones everywhere.
+        CHECK(db.findEmployees("Employee", "5") == vector<int>({ 1005 }));
+        CHECK(db.getPayroll(StatusFilter::Former).count == 3);
+        CHECK(db.getPayroll(StatusFilter::Former).total == 40002 + 40005 + 40007);
+        CHECK(db.getPayroll(StatusFilter::Current).count == 7);
+        CHECK(db.countSalariesAbove(40004, StatusFilter::All) == 5);
+        CHECK(db.getTopEarners(2, StatusFilter::Former) == vector<int>({ 1007, 1005 }));
+        CHECK(db.findEmployeesBySalary(40001, 40005) == vector<int>({ 1001, 1002, 1003, 1004, 1005 }));
+        CHECK(db.isArchived(1005) && db.archivedCount() == 3);
+
+        Employee copy;
+        CHECK(db.findEmployee(1005, copy) && copy.getSalary() == 40005 && !copy.isHired());
+        CHECK(db.isArchived(1005));
+        // A const lookup never moves a record.
+        const Database& constDb = db;
+        CHECK_THROWS(constDb.getEmployee(1005), logic_error);
+        CHECK(db.isArchived(1005) && db.archivedCount() == 3);
+        db.getEmployee(1005).hire();
+        CHECK(!db.isArchived(1005) && db.archivedCount() == 2);
+        CHECK(hotNumbers(db).back() == 1005);
+        CHECK(db.getCounters().headcount(StatusFilter::Current) == 8);
+        CHECK(db.getCounters().payroll(StatusFilter::All) == 400045);
+        CHECK_THROWS(db.getEmployee(1010), logic_error);
+        CHECK_THROWS(db.insertEmployee(copy), logic_error);
+        // Looked up by name, an archived employee comes back like by number.
+        CHECK(db.getEmployee("Employee", "7").getEmployeeNumber() == 1007);
+        CHECK(!db.isArchived(1007) && db.archivedCount() == 1);
+
+        cout << "Archived employees are saved." << endl;
+        db.saveSnapshot("compaction.snapshot");
+        Database loaded;
+        loaded.loadSnapshot("compaction.snapshot");
+        remove("compaction.snapshot");
+        CHECK(loaded.size() == 10 && loaded.archivedCount() == 0);
+        CHECK(!loaded.getEmployee(1007).isHired());
+        CHECK(loaded.getEmployee(1007).getSalary() == 40007);
+        CHECK_THROWS(db.loadSnapshot("compaction.snapshot"), logic_error);
+
+        exportCsv(db, "compaction.csv");
+        Database imported;
+        CHECK(importCsv(imported, "compaction.csv") == 10);
+        remove("compaction.csv");
+        CHECK(imported.getEmployee(1002).getLastName() == "2");
+    }
+
+    cout << "Compacting while the roster changes." << endl;
+    compactWhileChanging(StorageLayout::Rows, false);
+    compactWhileChanging(StorageLayout::Columnar, false);
+    compactWhileChanging(StorageLayout::Columnar, true);
+
+    cout << "Background compaction." << endl;
+    {
+        ConcurrentDatabase shards(8);
+        for (int i = 0; i < 20000; ++i)
+        {
+            shards.addEmployee("Shard", "Member");
+        }
+        shards.startCompaction(chrono::milliseconds(1), 64);
+        atomic<bool> failed{false};
+        vector<thread> workers;
+        for (int worker = 0; worker < 3; ++worker)
+        {
+            workers.emplace_back([&, worker]() {
+                mt19937 rng(static_cast<unsigned>(worker));
+                for (int i = 0; i < 20000; ++i)
+                {
+                    int number = kDefaultEmployeeNumber + static_cast<int>(rng() % 20000);
+                    switch (rng() % 3)
+                    {
+                        case 0:
+                            shards.fire(number);
+                            break;
+                        case 1:
+                            if (shards.getEmployee(number).getEmployeeNumber() != number)
+                            {
+                                failed = true;
+                            }
+                            break;
+                        default:
+                            shards.promote(number, 1);
+                            break;
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        // On a busy or single-core machine the workers may finish before the
+        // compactor has run; give it a moment to archive the fired staff.
+        auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+        while (shards.archivedCount() == 0 && chrono::steady_clock::now() < deadline)
+        {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        shards.stopCompaction();
+        CHECK(!failed);
+        CHECK(shards.size() == 20000);
+        CHECK(shards.archivedCount() > 0);
+        RosterCounters counters = shards.getCounters();
+        CHECK(counters.headcount(StatusFilter::All) == 20000);
+        CHECK(counters.payroll(StatusFilter::All) >= 20000LL * kDefaultStartingSlalary);
+        long long payroll = 0;
+        for (int number = kDefaultEmployeeNumber; number < kDefaultEmployeeNumber + 20000; ++number)
+        {
+            payroll += shards.read(number, [](const Employee& employee) { return employee.getSalary(); });
+        }
+        CHECK(payroll == counters.payroll(StatusFilter::All));
+        shards.startCompaction();
+    }
+
+    return Testing::testResult();
+}
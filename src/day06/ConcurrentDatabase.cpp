@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "ConcurrentDatabase.h"
+#include "ReportWriter.h"
+
+using namespace std;
+
+namespace Records
+{
+    ConcurrentDatabase::ConcurrentDatabase(size_t shardCount)
+    {
+        if (shardCount == 0)
+        {
+            throw invalid_argument("A concurrent database needs at least one shard.");
+        }
+        mShards.reserve(shardCount);
+        for (size_t i = 0; i < shardCount; ++i)
+        {
+            mShards.push_back(make_unique<Shard>(kDefaultEmployeeNumber + static_cast<int>(i),
+                                                 static_cast<int>(shardCount)));
+        }
+    }
+
+    ConcurrentDatabase::~ConcurrentDatabase()
+    {
+        stopCompaction();
+    }
+
+    int ConcurrentDatabase::addEmployee(string_view firstName, string_view lastName)
+    {
+        // Round-robin keeps the shards, and so the number space, evenly filled.
+        Shard& shard = *mShards[mNextShard.fetch_add(1, memory_order_relaxed) % mShards.size()];
+        unique_lock<shared_mutex> lock(shard.mutex);
+        if (mOpenViewCount.load() != 0)
+        {
+            saveVersion(shard, shard.db.getNextEmployeeNumber());
+        }
+        return shard.db.addEmployee(firstName, lastName).getEmployeeNumber();
+    }
+
+    Employee ConcurrentDatabase::getEmployee(int employeeNumber) const
+    {
+        return read(employeeNumber, [](const Employee& employee) { return employee; });
+    }
+
+    bool ConcurrentDatabase::findEmployee(int employeeNumber, Employee& result) const
+    {
+        try
+        {
+            result = getEmployee(employeeNumber);
+            return true;
+        }
+        catch (const logic_error&)
+        {
+            return false;
+        }
+    }
+
+    void ConcurrentDatabase::promote(int employeeNumber, int raiseAmount)
+    {
+        update(employeeNumber, [=](Employee& employee) { employee.promote(raiseAmount); });
+    }
+
+    void ConcurrentDatabase::demote(int employeeNumber, int demeritAmount)
+    {
+        update(employeeNumber, [=](Employee& employee) { employee.demote(demeritAmount); });
+    }
+
+    void ConcurrentDatabase::hire(int employeeNumber)
+    {
+        update(employeeNumber, [](Employee& employee) { employee.hire(); });
+    }
+
+    void ConcurrentDatabase::fire(int employeeNumber)
+    {
+        update(employeeNumber, [](Employee& employee) { employee.fire(); });
+    }
+
+    void ConcurrentDatabase::setSalary(int employeeNumber, int newSalary)
+    {
+        update(employeeNumber, [=](Employee& employee) { employee.setSalary(newSalary); });
+    }
+
+    size_t ConcurrentDatabase::size() const
+    {
+        size_t total = 0;
+        for (const auto& shard : mShards)
+        {
+            shared_lock<shared_mutex> lock(shard->mutex);
+            total += shard->db.size();
+        }
+        return total;
+    }
+
+    size_t ConcurrentDatabase::shardCount() const
+    {
+        return mShards.size();
+    }
+
+    RosterCounters ConcurrentDatabase::getCounters() const
+    {
+        RosterCounters total;
+        for (size_t i = 0; i < mShards.size(); ++i)
+        {
+            shared_lock<shared_mutex> lock(mShards[i]->mutex);
+            if (i == 0)
+            {
+                total = mShards[i]->db.getCounters();
+            }
+            else
+            {
+                total.merge(mShards[i]->db.getCounters());
+            }
+        }
+        return total;
+    }
+
+    void ConcurrentDatabase::setSalaryBuckets(int lowest, int bucketWidth, size_t bucketCount)
+    {
+        for (const auto& shard : mShards)
+        {
+            unique_lock<shared_mutex> lock(shard->mutex);
+            shard->db.setSalaryBuckets(lowest, bucketWidth, bucketCount);
+        }
+    }
+
+    ConcurrentDatabase::View::View(const ConcurrentDatabase* db, uint64_t version)
+        : mDb(db)
+        , mVersion(version)
+    {
+    }
+
+    ConcurrentDatabase::View::View(View&& other) noexcept
+        : mDb(other.mDb)
+        , mVersion(other.mVersion)
+    {
+        other.mDb = nullptr;
+    }
+
+    ConcurrentDatabase::View::~View()
+    {
+        if (mDb != nullptr)
+        {
+            mDb->closeView(mVersion);
+        }
+    }
+
+    bool ConcurrentDatabase::View::findEmployee(int employeeNumber, Employee& result) const
+    {
+        const Shard& shard = mDb->shardFor(employeeNumber);
+        shared_lock<shared_mutex> lock(shard.mutex);
+        if (const PriorVersion* prior = versionFor(shard, employeeNumber, mVersion))
+        {
+            if (prior->existed)
+            {
+                result = prior->employee;
+            }
+            return prior->existed;
+        }
+        return shard.db.findEmployee(employeeNumber, result);
+    }
+
+    ConcurrentDatabase::View ConcurrentDatabase::openView() const
+    {
+        // Writers check the open view count before they number a change,
+        // so it goes up before the version is read.
+        uint64_t version;
+        {
+            lock_guard<mutex> guard(mViewsMutex);
+            ++mOpenViewCount;
+            version = mVersion.load();
+            mOpenViews.insert(version);
+        }
+        // A writer may have checked the count, or numbered its change, just
+        // before that: its change belongs in the view, so wait for it to be
+        // applied. Writers hold their shard's lock until they are done.
+        for (const auto& shard : mShards)
+        {
+            shared_lock<shared_mutex> lock(shard->mutex);
+        }
+        return View(this, version);
+    }
+
+    void ConcurrentDatabase::closeView(uint64_t version) const
+    {
+        // No view still open, nor any opened later, reads versions saved
+        // at or before the oldest open view's.
+        uint64_t obsolete;
+        {
+            lock_guard<mutex> guard(mViewsMutex);
+            mOpenViews.erase(mOpenViews.find(version));
+            --mOpenViewCount;
+            obsolete = mOpenViews.empty() ? mVersion.load() : *mOpenViews.begin();
+        }
+        for (const auto& shard : mShards)
+        {
+            unique_lock<shared_mutex> lock(shard->mutex);
+            for (auto entry = shard->versions.begin(); entry != shard->versions.end(); )
+            {
+                vector<PriorVersion>& chain = entry->second;
+                auto kept = find_if(chain.begin(), chain.end(), [&](const PriorVersion& prior) {
+                    return prior.version > obsolete;
+                });
+                chain.erase(chain.begin(), kept);
+                entry = chain.empty() ? shard->versions.erase(entry) : next(entry);
+            }
+        }
+    }
+
+    void ConcurrentDatabase::saveVersion(Shard& shard, int employeeNumber)
+    {
+        uint64_t version = mVersion.fetch_add(1) + 1;
+        vector<PriorVersion>& chain = shard.versions[employeeNumber];
+        // The change itself brings an archived employee back to the hot
+        // tier, so getEmployee may as well do it now.
+        if (shard.db.contains(employeeNumber))
+        {
+            bool archived = shard.db.isArchived(employeeNumber);
+            chain.push_back({ version, true, archived, shard.db.getEmployee(employeeNumber) });
+        }
+        else
+        {
+            chain.push_back({ version, false, false, Employee() });
+        }
+    }
+
+    const ConcurrentDatabase::PriorVersion* ConcurrentDatabase::versionFor(const Shard& shard, int employeeNumber,
+                                                                           uint64_t version)
+    {
+        if (shard.versions.empty())
+        {
+            return nullptr;
+        }
+        auto found = shard.versions.find(employeeNumber);
+        if (found == shard.versions.end())
+        {
+            return nullptr;
+        }
+        // The first change after the view opened saved the version it sees.
+        const vector<PriorVersion>& chain = found->second;
+        auto first = upper_bound(chain.begin(), chain.end(), version,
+                                 [](uint64_t v, const PriorVersion& prior) { return v < prior.version; });
+        return first == chain.end() ? nullptr : &*first;
+    }
+
+    bool ConcurrentDatabase::readBatch(size_t shardIndex, uint64_t version, Cursor& cursor,
+                                       vector<Employee>& batch) const
+    {
+        batch.clear();
+        const Shard& shard = *mShards[shardIndex];
+        shared_lock<shared_mutex> lock(shard.mutex);
+        if (!cursor.started)
+        {
+            // Records appended later were all added after the view opened.
+            cursor.next = shard.db.begin();
+            cursor.end = shard.db.end();
+            cursor.started = true;
+        }
+        for (; cursor.next != cursor.end && batch.size() < kViewBatch; ++cursor.next)
+        {
+            const PriorVersion* prior = versionFor(shard, cursor.next->getEmployeeNumber(), version);
+            if (prior == nullptr)
+            {
+                batch.push_back(*cursor.next);
+            }
+            // Archived employees brought back since the view opened stay out.
+            else if (prior->existed && !prior->archived)
+            {
+                batch.push_back(prior->employee);
+            }
+        }
+        if (!batch.empty() || cursor.next != cursor.end)
+        {
+            return true;
+        }
+        if (cursor.archiveRead)
+        {
+            return false;
+        }
+        // The archive goes out in one batch. Compaction waits for open
+        // views, so nobody was archived since this one opened; those brought
+        // back since then saved their archived version.
+        shard.db.forEachArchived([&](const Employee& employee) {
+            const PriorVersion* prior = versionFor(shard, employee.getEmployeeNumber(), version);
+            if (prior == nullptr)
+            {
+                batch.push_back(employee);
+            }
+        });
+        for (const auto& saved : shard.versions)
+        {
+            const PriorVersion* prior = versionFor(shard, saved.first, version);
+            if (prior != nullptr && prior->existed && prior->archived)
+            {
+                batch.push_back(prior->employee);
+            }
+        }
+        cursor.archiveRead = true;
+        return true;
+    }
+
+    void ConcurrentDatabase::startCompaction(chrono::milliseconds interval, size_t stepRecords)
+    {
+        if (mCompactor.joinable())
+        {
+            return;
+        }
+        mStopCompactor = false;
+        mCompactor = thread(&ConcurrentDatabase::compactShards, this, interval, stepRecords);
+    }
+
+    void ConcurrentDatabase::stopCompaction()
+    {
+        if (!mCompactor.joinable())
+        {
+            return;
+        }
+        {
+            lock_guard<mutex> guard(mCompactorMutex);
+            mStopCompactor = true;
+        }
+        mCompactorWake.notify_all();
+        mCompactor.join();
+    }
+
+    size_t ConcurrentDatabase::archivedCount() const
+    {
+        size_t total = 0;
+        for (const auto& shard : mShards)
+        {
+            shared_lock<shared_mutex> lock(shard->mutex);
+            total += shard->db.archivedCount();
+        }
+        return total;
+    }
+
+    void ConcurrentDatabase::compactShards(chrono::milliseconds interval, size_t stepRecords)
+    {
+        while (!mStopCompactor)
+        {
+            for (const auto& shard : mShards)
+            {
+                // Unlock between steps so that waiting readers and writers
+                // get in.
+                bool finished = false;
+                while (!finished && !mStopCompactor)
+                {
+                    unique_lock<shared_mutex> lock(shard->mutex);
+                    // Leave the shard for the next pass while a view reads it.
+                    finished = mOpenViewCount.load() != 0 || shard->db.compactStep(stepRecords);
+                }
+            }
+            unique_lock<mutex> guard(mCompactorMutex);
+            mCompactorWake.wait_for(guard, interval, [this] { return mStopCompactor.load(); });
+        }
+    }
+
+    void ConcurrentDatabase::displayAll() const
+    {
+        ReportWriter writer;
+        openView().forEach([&](const Employee& employee) { writer.write(employee); });
+    }
+
+    ConcurrentDatabase::Shard& ConcurrentDatabase::shardFor(int employeeNumber)
+    {
+        return const_cast<Shard&>(static_cast<const ConcurrentDatabase*>(this)->shardFor(employeeNumber));
+    }
+
+    const ConcurrentDatabase::Shard& ConcurrentDatabase::shardFor(int employeeNumber) const
+    {
+        long long offset = static_cast<long long>(employeeNumber) - kDefaultEmployeeNumber;
+        long long count = static_cast<long long>(mShards.size());
+        // Numbers below the first one still land on some shard, which will
+        // report them as missing.
+        return *mShards[static_cast<size_t>(((offset % count) + count) % count)];
+    }
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Database.h"
+
+namespace Records
+{
+    // Thread-safe front end over several Database shards, each behind its
+    // own reader/writer lock. Employee numbers are interleaved across the
+    // shards (shard i owns kDefaultEmployeeNumber + i, + i + shardCount, ...),
+    // so a number maps to its shard with one modulo. Lookups on different
+    // shards never contend, and lookups on the same shard only wait for a
+    // writer on that shard.
+    //
+    // Records never leave the lock that guards them: reads return copies,
+    // and changes go through the member functions below or update().
+    //
+    // A View shows the whole roster as of one instant while writers carry
+    // on. As long as any view is open, every change first saves the
+    // employee's previous version in its shard; a view reads the current
+    // record unless a version saved after the view opened says otherwise.
+    class ConcurrentDatabase
+    {
+        public:
+            static constexpr std::size_t kDefaultShardCount = 64;
+
+            // A consistent view of the roster as of openView(): changes made
+            // afterwards, by any thread, are invisible to it. Closed when
+            // destroyed; must not outlive the database.
+            class View
+            {
+                public:
+                    View(View&& other) noexcept;
+                    View& operator=(const View&) = delete;
+                    ~View();
+
+                    // Calls fn(const Employee&) for every employee as of
+                    // the view, shard by shard, each shard's hot tier before
+                    // its archive. Records are copied out a batch at a time
+                    // under the shard's shared lock and fn runs with no lock
+                    // held, so however slow fn is, a writer waits for one
+                    // batch at most. A shard's archive is one batch.
+                    template <typename Fn>
+                    void forEach(Fn&& fn) const
+                    {
+                        std::vector<Employee> batch;
+                        for (std::size_t shard = 0; shard < mDb->mShards.size(); ++shard)
+                        {
+                            Cursor cursor;
+                            while (mDb->readBatch(shard, mVersion, cursor, batch))
+                            {
+                                for (const Employee& employee : batch)
+                                {
+                                    fn(employee);
+                                }
+                            }
+                        }
+                    }
+                    // Copies the employee as of the view, from either tier,
+                    // into result. Returns false if there was none.
+                    bool findEmployee(int employeeNumber, Employee& result) const;
+
+                private:
+                    friend class ConcurrentDatabase;
+
+                    View(const ConcurrentDatabase* db, std::uint64_t version);
+
+                    const ConcurrentDatabase* mDb;
+                    std::uint64_t mVersion;
+            };
+
+            explicit ConcurrentDatabase(std::size_t shardCount = kDefaultShardCount);
+            // Stops background compaction first.
+            ~ConcurrentDatabase();
+            ConcurrentDatabase(const ConcurrentDatabase&) = delete;
+            ConcurrentDatabase& operator=(const ConcurrentDatabase&) = delete;
+
+            // Returns the new employee's number.
+            int addEmployee(std::string_view firstName, std::string_view lastName);
+
+            // Copy of the employee. Throws logic_error if there is none.
+            Employee getEmployee(int employeeNumber) const;
+            // Copies the employee into result. Returns false if there is none.
+            bool findEmployee(int employeeNumber, Employee& result) const;
+
+            void promote(int employeeNumber, int raiseAmount = 1000);
+            void demote(int employeeNumber, int demeritAmount = 1000);
+            void hire(int employeeNumber);
+            void fire(int employeeNumber);
+            void setSalary(int employeeNumber, int newSalary);
+
+            // Runs fn(const Employee&) under the shard's shared lock and
+            // returns its result.
+            template <typename Fn>
+            auto read(int employeeNumber, Fn&& fn) const
+            {
+                const Shard& shard = shardFor(employeeNumber);
+                std::shared_lock<std::shared_mutex> lock(shard.mutex);
+                // Bringing an archived employee back to the hot tier takes
+                // the exclusive lock, so readers get a copy instead.
+                if (shard.db.isArchived(employeeNumber))
+                {
+                    Employee archived;
+                    shard.db.findEmployee(employeeNumber, archived);
+                    return fn(static_cast<const Employee&>(archived));
+                }
+                return fn(shard.db.getEmployee(employeeNumber));
+            }
+
+            // Runs fn(Employee&) under the shard's exclusive lock and returns
+            // its result. fn must not change the employee number, which
+            // decides the shard.
+            template <typename Fn>
+            auto update(int employeeNumber, Fn&& fn)
+            {
+                Shard& shard = shardFor(employeeNumber);
+                std::unique_lock<std::shared_mutex> lock(shard.mutex);
+                if (mOpenViewCount.load() != 0)
+                {
+                    saveVersion(shard, employeeNumber);
+                }
+                return fn(shard.db.getEmployee(employeeNumber));
+            }
+
+            std::size_t size() const;
+            std::size_t shardCount() const;
+
+            // The shards' counters added up (see Database::getCounters), at
+            // the cost of one shared lock per shard.
+            RosterCounters getCounters() const;
+            // See Database::setSalaryBuckets.
+            void setSalaryBuckets(int lowest, int bucketWidth, std::size_t bucketCount);
+
+            // Opens a view of the roster as it is now. Waits for changes
+            // already under way to finish; writers that start later do not
+            // wait for the view.
+            View openView() const;
+
+            // Starts a thread that compacts the shards (see
+            // Database::compactStep) one step of stepRecords records at a
+            // time, holding a shard's exclusive lock only for the length of
+            // a step. After each pass over every shard it sleeps for
+            // interval. Does nothing if the thread is already running.
+            // Compaction moves records, so it holds off while views are open.
+            void startCompaction(std::chrono::milliseconds interval = std::chrono::milliseconds(1000),
+                                 std::size_t stepRecords = Database::kCompactionStep);
+            // Lets the current step finish and stops the thread.
+            void stopCompaction();
+            std::size_t archivedCount() const;
+
+            // Reports the roster through a view, so it shows one instant
+            // while writers carry on.
+            void displayAll() const;
+
+        private:
+            // Records View::forEach copies out per lock.
+            static constexpr std::size_t kViewBatch = 256;
+
+            // An employee as it was just before the change numbered version.
+            struct PriorVersion
+            {
+                std::uint64_t version;
+                // False if the change added the employee.
+                bool existed;
+                // True if the employee was in the archive, which the change
+                // brought them back from.
+                bool archived;
+                Employee employee;
+            };
+
+            // Each shard sits on its own cache lines so that locking one
+            // does not invalidate its neighbours.
+            struct alignas(64) Shard
+            {
+                Shard(int firstEmployeeNumber, int numberStride)
+                    : db(StorageLayout::Rows, firstEmployeeNumber, numberStride)
+                {
+                }
+
+                mutable std::shared_mutex mutex;
+                Database db;
+                // Versions saved while views are open, oldest first for each
+                // employee number.
+                std::unordered_map<int, std::vector<PriorVersion>> versions;
+            };
+
+            // Where View::forEach has got to in one shard.
+            struct Cursor
+            {
+                bool started = false;
+                bool archiveRead = false;
+                EmployeeStore::const_iterator next;
+                EmployeeStore::const_iterator end;
+            };
+
+            Shard& shardFor(int employeeNumber);
+            const Shard& shardFor(int employeeNumber) const;
+            void compactShards(std::chrono::milliseconds interval, std::size_t stepRecords);
+            // Saves employeeNumber's current version, or that it does not
+            // exist yet, before a change. Needs the shard's exclusive lock.
+            void saveVersion(Shard& shard, int employeeNumber);
+            // The saved version a view at version must read instead of the
+            // current record, or nullptr if it reads the current one.
+            static const PriorVersion* versionFor(const Shard& shard, int employeeNumber,
+                                                  std::uint64_t version);
+            // Fills batch with the next records of a shard as of version.
+            // Returns false once the shard is done.
+            bool readBatch(std::size_t shard, std::uint64_t version, Cursor& cursor,
+                           std::vector<Employee>& batch) const;
+            void closeView(std::uint64_t version) const;
+
+            std::vector<std::unique_ptr<Shard>> mShards;
+            std::atomic<std::size_t> mNextShard{0};
+
+            std::thread mCompactor;
+            std::mutex mCompactorMutex;
+            std::condition_variable mCompactorWake;
+            std::atomic<bool> mStopCompactor{false};
+
+            // Numbers the changes made while views are open.
+            mutable std::atomic<std::uint64_t> mVersion{0};
+            mutable std::atomic<std::size_t> mOpenViewCount{0};
+            mutable std::mutex mViewsMutex;
+            // Versions of the open views.
+            mutable std::multiset<std::uint64_t> mOpenViews;
+    };
+}
@@ -0,0 +1,126 @@
+/*
+ * Mixed lookup/update throughput from 1 to 64 threads: ConcurrentDatabase
+ * against a single Database behind one std::mutex.
+ *
+ * Usage: ConcurrentDatabaseBenchmark [employees] [opsPerThread]
+ *        (default 1000000 employees, 200000 operations per thread)
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ConcurrentDatabase.h"
+
+using namespace std;
+using namespace Records;
+
+// The setup this replaces: one Database and one lock around every call.
+class LockedDatabase
+{
+    public:
+        int addEmployee(const string& firstName, const string& lastName)
+        {
+            lock_guard<mutex> lock(mMutex);
+            return mDb.addEmployee(firstName, lastName).getEmployeeNumber();
+        }
+        int getSalary(int employeeNumber)
+        {
+            lock_guard<mutex> lock(mMutex);
+            return mDb.getEmployee(employeeNumber).getSalary();
+        }
+        void promote(int employeeNumber)
+        {
+            lock_guard<mutex> lock(mMutex);
+            mDb.getEmployee(employeeNumber).promote(1);
+        }
+
+    private:
+        mutex mMutex;
+        Database mDb;
+};
+
+// Runs opsPerThread operations on each of threads threads; readPercent of
+// them are lookups and the rest raises. Returns operations per second.
+template <typename Read, typename Write>
+static double run(size_t threads, size_t opsPerThread, unsigned readPercent,
+                  size_t employees, Read&& read, Write&& write)
+{
+    vector<thread> workers;
+    auto start = Bench::Clock::now();
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t] {
+            mt19937 rng(static_cast<unsigned>(t) + 1);
+            long long sink = 0;
+            for (size_t i = 0; i < opsPerThread; ++i)
+            {
+                int number = kDefaultEmployeeNumber + static_cast<int>(rng() % employees);
+                if (rng() % 100 < readPercent)
+                {
+                    sink += read(number);
+                }
+                else
+                {
+                    write(number);
+                }
+            }
+            Bench::doNotOptimize(sink);
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    chrono::duration<double> elapsed = Bench::Clock::now() - start;
+    return static_cast<double>(threads * opsPerThread) / elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t employees = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t opsPerThread = argc > 2 ? strtoull(argv[2], nullptr, 10) : 200000;
+
+    ConcurrentDatabase sharded;
+    LockedDatabase locked;
+    for (size_t i = 0; i < employees; ++i)
+    {
+        string first = "First" + to_string(i % 1000);
+        string last = "Last" + to_string(i);
+        sharded.addEmployee(first, last);
+        locked.addEmployee(first, last);
+    }
+
+    cout << "hardware threads: " << thread::hardware_concurrency() << endl;
+    cout << setw(8) << "reads" << setw(9) << "threads" << setw(18) << "one mutex op/s"
+         << setw(18) << "sharded op/s" << setw(10) << "ratio" << endl;
+
+    for (unsigned readPercent : { 50u, 90u, 99u })
+    {
+        for (size_t threads = 1; threads <= 64; threads *= 2)
+        {
+            double baseline = run(threads, opsPerThread, readPercent, employees,
+                [&](int number) { return locked.getSalary(number); },
+                [&](int number) { locked.promote(number); });
+            double concurrent = run(threads, opsPerThread, readPercent, employees,
+                [&](int number) {
+                    return sharded.read(number, [](const Employee& employee) {
+                        return employee.getSalary();
+                    });
+                },
+                [&](int number) { sharded.promote(number, 1); });
+
+            cout << setw(7) << readPercent << "%" << setw(9) << threads << fixed
+                 << setprecision(0) << setw(18) << baseline << setw(18) << concurrent
+                 << setw(9) << setprecision(2) << concurrent / baseline << "x" << endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConcurrentDatabase.h"
+#include "TestHelpers.h"
+
+using namespace std;
+using namespace Records;
+
+/*
+ * Hammers a ConcurrentDatabase from several threads and checks that no
+ * hire or raise was lost.
+ */
+int main()
+{
+    const int kThreads = 8;
+    const int kHiresPerThread = 2000;
+    const int kRaisesPerThread = 20000;
+
+    ConcurrentDatabase db(16);
+
+    cout << "Hiring from " << kThreads << " threads." << endl;
+    vector<vector<int>> numbers(kThreads);
+    {
+        vector<thread> workers;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            workers.emplace_back([&, t] {
+                for (int i = 0; i < kHiresPerThread; ++i)
+                {
+                    numbers[t].push_back(db.addEmployee("Worker", "Thread" + to_string(t)));
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+    CHECK(db.size() == static_cast<size_t>(kThreads * kHiresPerThread));
+
+    // Numbers are unique and dense across the shards.
+    vector<bool> seen(kThreads * kHiresPerThread, false);
+    bool unique = true;
+    for (const auto& list : numbers)
+    {
+        for (int number : list)
+        {
+            size_t offset = static_cast<size_t>(number - kDefaultEmployeeNumber);
+            unique = unique && offset < seen.size() && !seen[offset];
+            if (offset < seen.size())
+            {
+                seen[offset] = true;
+            }
+        }
+    }
+    CHECK(unique);
+
+    cout << "Promoting and reading concurrently." << endl;
+    {
+        vector<thread> workers;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            workers.emplace_back([&, t] {
+                for (int i = 0; i < kRaisesPerThread; ++i)
+                {
+                    // Every thread raises the same 100 employees.
+                    int number = kDefaultEmployeeNumber + i % 100;
+                    if (i % 2 == 0)
+                    {
+                        db.promote(number, 1);
+                    }
+                    else
+                    {
+                        db.update(number, [](Employee& employee) {
+                            employee.setSalary(employee.getSalary() + 1);
+                        });
+                    }
+                    Employee copy;
+                    db.findEmployee(kDefaultEmployeeNumber + (i * 7 + t) % 1000, copy);
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+    long long total = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        total += db.getEmployee(kDefaultEmployeeNumber + i).getSalary();
+    }
+    CHECK(total == 100LL * kDefaultStartingSlalary + static_cast<long long>(kThreads) * kRaisesPerThread);
+
+    Employee missing;
+    CHECK(!db.findEmployee(kDefaultEmployeeNumber + kThreads * kHiresPerThread, missing));
+    CHECK(!db.findEmployee(5, missing));
+    CHECK_THROWS(db.promote(-7), logic_error);
+
+    cout << "Interning the same names from every thread." << endl;
+    {
+        const int kNames = 2000;
+        vector<vector<NameId>> ids(kThreads, vector<NameId>(kNames));
+        vector<thread> workers;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            workers.emplace_back([&, t] {
+                for (int i = 0; i < kNames; ++i)
+                {
+                    // Each thread starts at a different name, so they race to add them.
+                    int name = (i + t * kNames / kThreads) % kNames;
+                    ids[t][name] = NamePool::global().intern("Shared" + to_string(name));
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        bool same = true;
+        for (int i = 0; i < kNames; ++i)
+        {
+            NameId found;
+            same = same && NamePool::global().find("Shared" + to_string(i), found) && found == ids[0][i]
+                && NamePool::global().view(found) == "Shared" + to_string(i);
+            for (int t = 1; t < kThreads; ++t)
+            {
+                same = same && ids[t][i] == ids[0][i];
+            }
+        }
+        CHECK(same);
+    }
+
+    return Testing::testResult();
+}
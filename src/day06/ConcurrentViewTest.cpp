@@ -0,0 +1,164 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "ConcurrentDatabase.h"
+#include "TestHelpers.h"
+
+using namespace std;
+using namespace Records;
+
+// What a view shows of one employee.
+using Seen = pair<int, bool>;
+
+static map<int, Seen> collect(const ConcurrentDatabase::View& view)
+{
+    map<int, Seen> seen;
+    view.forEach([&](const Employee& employee) {
+        seen[employee.getEmployeeNumber()] = { employee.getSalary(), employee.isHired() };
+    });
+    return seen;
+}
+
+/*
+ * Checks that views of a ConcurrentDatabase keep showing one instant while
+ * writers hire, raise and fire from several threads.
+ */
+int main()
+{
+    const int kThreads = 4;
+    const int kEmployees = 4000;
+    const int kOpsPerThread = 100000;
+
+    ConcurrentDatabase db(8);
+    for (int i = 0; i < kEmployees; ++i)
+    {
+        db.addEmployee("Worker", "Number" + to_string(i));
+    }
+
+    cout << "Changing the roster behind one view." << endl;
+    {
+        auto view = db.openView();
+        db.promote(kDefaultEmployeeNumber, 500);
+        db.fire(kDefaultEmployeeNumber + 1);
+        int hired = db.addEmployee("Late", "Hire");
+
+        Employee seen;
+        CHECK(view.findEmployee(kDefaultEmployeeNumber, seen));
+        CHECK(seen.getSalary() == kDefaultStartingSlalary);
+        CHECK(db.getEmployee(kDefaultEmployeeNumber).getSalary() == kDefaultStartingSlalary + 500);
+        CHECK(view.findEmployee(kDefaultEmployeeNumber + 1, seen) && seen.isHired());
+        CHECK(!view.findEmployee(hired, seen));
+        CHECK(db.findEmployee(hired, seen));
+
+        // A later view sees the changes; the first one still does not.
+        auto later = db.openView();
+        db.promote(kDefaultEmployeeNumber, 500);
+        CHECK(later.findEmployee(kDefaultEmployeeNumber, seen));
+        CHECK(seen.getSalary() == kDefaultStartingSlalary + 500);
+        CHECK(view.findEmployee(kDefaultEmployeeNumber, seen));
+        CHECK(seen.getSalary() == kDefaultStartingSlalary);
+        CHECK(collect(later).size() == static_cast<size_t>(kEmployees + 1));
+        CHECK(collect(view).size() == static_cast<size_t>(kEmployees));
+    }
+    CHECK(db.size() == static_cast<size_t>(kEmployees + 1));
+
+    cout << "Reading views while " << kThreads << " threads write." << endl;
+    db.startCompaction(chrono::milliseconds(1), 64);
+    atomic<int> running{kThreads};
+    vector<thread> writers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        writers.emplace_back([&, t] {
+            for (int i = 0; i < kOpsPerThread; ++i)
+            {
+                int number = kDefaultEmployeeNumber + (i * 13 + t * 1009) % kEmployees;
+                switch (i % 8)
+                {
+                    case 0:
+                        db.addEmployee("Stress", "Hire" + to_string(t));
+                        break;
+                    case 1:
+                        db.fire(number);
+                        break;
+                    case 2:
+                        db.hire(number);
+                        break;
+                    default:
+                        db.promote(number, 1);
+                        break;
+                }
+            }
+            --running;
+        });
+    }
+
+    bool repeatable = true;
+    bool bounded = true;
+    int views = 0;
+    do
+    {
+        auto view = db.openView();
+        map<int, Seen> first = collect(view);
+        this_thread::sleep_for(chrono::milliseconds(2));
+        map<int, Seen> second = collect(view);
+        repeatable = repeatable && first == second;
+        for (const auto& [number, seen] : first)
+        {
+            Employee found;
+            repeatable = repeatable && view.findEmployee(number, found)
+                      && found.getSalary() == seen.first && found.isHired() == seen.second;
+        }
+        // Hires made since the view opened are not in it.
+        bounded = bounded && first.size() <= db.size();
+        ++views;
+    } while (running > 0);
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+    db.stopCompaction();
+    cout << "Checked " << views << " views." << endl;
+    CHECK(repeatable);
+    CHECK(bounded);
+
+    cout << "Viewing archived employees." << endl;
+    db.startCompaction(chrono::milliseconds(1), 64);
+    for (int waited = 0; db.archivedCount() == 0 && waited < 10000; ++waited)
+    {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    db.stopCompaction();
+    CHECK(db.archivedCount() > 0);
+    {
+        auto view = db.openView();
+        map<int, Seen> before = collect(view);
+        CHECK(before.size() == db.size());
+        // Hiring brings former employees back from the archive; the view
+        // still shows them as they were.
+        for (const auto& [number, seen] : before)
+        {
+            if (!seen.second)
+            {
+                db.hire(number);
+            }
+        }
+        CHECK(db.archivedCount() == 0);
+        CHECK(collect(view) == before);
+    }
+
+    // With no view open, the saved versions are gone and reads are current.
+    auto view = db.openView();
+    long long viewed = 0;
+    long long current = 0;
+    view.forEach([&](const Employee& employee) {
+        viewed += employee.getSalary();
+        current += db.getEmployee(employee.getEmployeeNumber()).getSalary();
+    });
+    CHECK(viewed == current);
+
+    return Testing::testResult();
+}
@@ -0,0 +1,112 @@
+/*
+ * Throughput of exportCsv and importCsv, by parsing thread count, against
+ * a getline-and-split loop around Database::addEmployee.
+ *
+ * Usage: CsvBenchmark [employees]   (default 5000000)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Database.h"
+#include "RosterCsv.h"
+
+using namespace std;
+using namespace Records;
+
+template <typename Fn>
+static double seconds(Fn&& fn)
+{
+    auto start = Bench::Clock::now();
+    fn();
+    chrono::duration<double> elapsed = Bench::Clock::now() - start;
+    return elapsed.count();
+}
+
+// The loop an importer would be written as without importCsv.
+static size_t importWithGetline(Database& db, const string& path)
+{
+    ifstream in(path);
+    string line;
+    getline(in, line);
+    size_t count = 0;
+    while (getline(in, line))
+    {
+        istringstream fields(line);
+        string number, firstName, lastName, salary, hired;
+        getline(fields, number, ',');
+        getline(fields, firstName, ',');
+        getline(fields, lastName, ',');
+        getline(fields, salary, ',');
+        getline(fields, hired, ',');
+        Employee& employee = db.addEmployee(firstName, lastName);
+        employee.setSalary(stoi(salary));
+        if (hired == "0")
+        {
+            employee.fire();
+        }
+        ++count;
+    }
+    return count;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 5000000;
+    const string path = "CsvBenchmark.csv";
+
+    Database db;
+    db.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        Employee& employee = db.addEmployee("First" + to_string(i % 1000),
+                                            "Last" + to_string(i % 50000));
+        employee.setSalary(30000 + static_cast<int>(i % 70000));
+        if (i % 7 == 0)
+        {
+            employee.fire();
+        }
+    }
+
+    double exportSeconds = seconds([&] { exportCsv(db, path); });
+    ifstream sizer(path, ios::binary | ios::ate);
+    double megabytes = static_cast<double>(sizer.tellg()) / 1e6;
+
+    cout << fixed << setprecision(1)
+         << count << " employees, " << megabytes << " MB" << endl
+         << setw(20) << "export" << setw(10) << megabytes / exportSeconds << " MB/s" << endl;
+
+    {
+        Database copy;
+        double elapsed = seconds([&] { Bench::doNotOptimize(importWithGetline(copy, path)); });
+        cout << setw(20) << "getline import" << setw(10) << megabytes / elapsed << " MB/s" << endl;
+    }
+
+    unsigned hardware = max(thread::hardware_concurrency(), 1u);
+    for (unsigned threads = 1; ; threads *= 2)
+    {
+        threads = min(threads, hardware);
+        CsvOptions options;
+        options.threads = threads;
+        Database copy;
+        double elapsed = seconds([&] { Bench::doNotOptimize(importCsv(copy, path, options)); });
+        cout << setw(12) << "importCsv x" << setw(2) << left << threads << right
+             << "    " << setw(10) << megabytes / elapsed << " MB/s" << endl;
+        if (threads == hardware)
+        {
+            break;
+        }
+    }
+
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "Database.h"
+#include "RosterCsv.h"
+#include "TestHelpers.h"
+
+using namespace std;
+using namespace Records;
+
+/*
+ * Round-trips rosters through exportCsv and importCsv, and feeds the
+ * importer hand-written files.
+ */
+
+static void buildRoster(Database& db)
+{
+    db.addEmployee("Greg", "Wallis").fire();
+    db.addEmployee("Marc", "White").setSalary(100000);
+    db.addEmployee("Anne, Jr.", "O\"Brien").setSalary(52000);
+    db.addEmployee("", "Nobody");
+    for (int i = 0; i < 5000; ++i)
+    {
+        Employee& employee = db.addEmployee("First" + to_string(i % 37), "Last" + to_string(i % 101));
+        employee.setSalary(20000 + i);
+        if (i % 5 == 0)
+        {
+            employee.fire();
+        }
+    }
+}
+
+static bool sameRoster(const Database& a, const Database& b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (const Employee& employee : a)
+    {
+        if (!b.contains(employee.getEmployeeNumber()))
+        {
+            return false;
+        }
+        const Employee& copy = b.getEmployee(employee.getEmployeeNumber());
+        if (copy.getFirstName() != employee.getFirstName()
+            || copy.getLastName() != employee.getLastName()
+            || copy.getSalary() != employee.getSalary()
+            || copy.isHired() != employee.isHired())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void writeFile(const string& path, const string& text)
+{
+    ofstream out(path, ios::binary);
+    out << text;
+}
+
+int main()
+{
+    const string path = "CsvTest.csv";
+
+    Database original;
+    buildRoster(original);
+
+    cout << "Round trip, CSV and TSV, with chunks of many sizes." << endl;
+    for (char delimiter : { ',', '\t' })
+    {
+        CsvOptions options;
+        options.delimiter = delimiter;
+        exportCsv(original, path, options);
+        for (size_t chunkBytes : { size_t{1}, size_t{100}, size_t{4096}, size_t{1} << 22 })
+        {
+            for (unsigned threads : { 1u, 3u })
+            {
+                options.chunkBytes = chunkBytes;
+                options.threads = threads;
+                Database copy;
+                CHECK(importCsv(copy, path, options) == original.size());
+                CHECK(sameRoster(original, copy));
+                CHECK(copy.getNextEmployeeNumber() == original.getNextEmployeeNumber());
+            }
+        }
+    }
+
+    cout << "Quoting, CRLF line ends, no header and empty numbers." << endl;
+    {
+        writeFile(path, "5000,\"Smith, \"\"Jo\"\"\",Doe,42000,1\r\n"
+                        "\n"
+                        ",Ann,Lee,31000,0\r\n"
+                        "7,\"Bob\",\"\",30000,\"1\"\n");
+        CsvOptions options;
+        options.header = false;
+        Database db;
+        CHECK(importCsv(db, path, options) == 3);
+        CHECK(db.getEmployee(5000).getFirstName() == "Smith, \"Jo\"");
+        CHECK(db.getEmployee(7).getLastName() == "");
+        // The number-less row was hired after 5000.
+        Employee& ann = db.getEmployee("Ann", "Lee");
+        CHECK(ann.getEmployeeNumber() == 5001);
+        CHECK(!ann.isHired() && ann.getSalary() == 31000);
+    }
+
+    cout << "Malformed files." << endl;
+    {
+        CsvOptions options;
+        options.header = false;
+        const char* badFiles[] = {
+            "1000,A,B,30000\n",
+            "1000,A,B,30000,1,extra\n",
+            "1000,\"A,B,30000,1\n",
+            "1000,\"A\"x,B,30000,1\n",
+            "1000,A,B,lots,1\n",
+            "1000,A,B,30000,yes\n",
+            "1000,A,B,30000,1\n1000,C,D,30000,1\n",
+        };
+        for (const char* text : badFiles)
+        {
+            writeFile(path, text);
+            Database db;
+            CHECK_THROWS(importCsv(db, path, options), runtime_error);
+        }
+        // The offset of the bad line is reported.
+        writeFile(path, "1000,A,B,30000,1\n1001,A,B,oops,1\n");
+        Database db;
+        try
+        {
+            importCsv(db, path, options);
+            CHECK(false);
+        }
+        catch (const runtime_error& e)
+        {
+            CHECK(string(e.what()).find("byte 17") != string::npos);
+        }
+        CHECK(db.size() == 1);
+
+        Database missing;
+        CHECK_THROWS(importCsv(missing, "CsvTest.missing.csv"), runtime_error);
+
+        // A file without the header its options promise is rejected
+        // rather than losing its first row.
+        CsvOptions withHeader;
+        const char* badHeaders[] = {
+            "1000,A,B,30000,1\n1001,C,D,30000,1\n",
+            "employee_number,first_name,last_name,salary\n",
+            "employee_number,first_name,last_name,salary,hired,extra\n",
+            "employee_number\tfirst_name\tlast_name\tsalary\thired\n",
+        };
+        for (const char* text : badHeaders)
+        {
+            writeFile(path, text);
+            Database headerless;
+            CHECK_THROWS(importCsv(headerless, path, withHeader), runtime_error);
+            CHECK(headerless.size() == 0);
+        }
+        writeFile(path, "\"employee_number\",first_name,last_name,salary,hired\r\n1000,A,B,30000,1\n");
+        Database headed;
+        CHECK(importCsv(headed, path, withHeader) == 1);
+    }
+
+    cout << "Names with line breaks cannot be exported." << endl;
+    {
+        Database db;
+        db.addEmployee("Two\nLines", "Name");
+        CHECK_THROWS(exportCsv(db, path), runtime_error);
+    }
+
+    remove(path.c_str());
+    return Testing::testResult();
+}
@@ -1,60 +1,1565 @@
-#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 #include "Database.h"
+#include "OperationStats.h"
+#include "ReportWriter.h"
+#include "Snapshot.h"
 
 using namespace std;
 
 
-namespace Records 
+namespace Records
 {
-    Employee& Database::addEmployee(const string& firstName,
-                                    const string& lastName)
+    namespace
     {
-        Employee theEmployee(firstName, lastName);
-        theEmployee.setEmployeeNumber(mNextEmployeeNumber++);
+        // Workers runInRanges uses for count items on threads threads (0
+        // means one per hardware thread), counting the caller's.
+        size_t workerCount(size_t count, unsigned threads)
+        {
+            size_t workers = threads != 0 ? threads : max(thread::hardware_concurrency(), 1u);
+            return max<size_t>(min(workers, count), 1);
+        }
+
+        // Splits [0, count) into one contiguous range per worker and runs
+        // work(worker, begin, end) for each. Rethrows the first exception,
+        // by range order, once every worker is done.
+        template <typename Work>
+        void runInRanges(size_t count, unsigned threads, Work&& work)
+        {
+            size_t workers = workerCount(count, threads);
+            vector<exception_ptr> errors(workers);
+            auto run = [&](size_t worker) {
+                try
+                {
+                    work(worker, count * worker / workers, count * (worker + 1) / workers);
+                }
+                catch (...)
+                {
+                    errors[worker] = current_exception();
+                }
+            };
+            vector<thread> helpers;
+            for (size_t worker = 1; worker < workers; ++worker)
+            {
+                helpers.emplace_back(run, worker);
+            }
+            run(0);
+            for (auto& helper : helpers)
+            {
+                helper.join();
+            }
+            for (auto& error : errors)
+            {
+                if (error)
+                {
+                    rethrow_exception(error);
+                }
+            }
+        }
+
+        // The count highest keys of index that keep(key) accepts: highest
+        // salary first and, among equal salaries, lowest key first.
+        template <typename Keep>
+        vector<uint64_t> topKeys(const SalaryIndex& index, size_t count, Keep&& keep)
+        {
+            vector<uint64_t> top;
+            index.forEachDescending([&](uint64_t key) {
+                if (keep(key))
+                {
+                    top.push_back(key);
+                }
+                return top.size() < count;
+            });
+            if (top.empty())
+            {
+                return top;
+            }
+            // The walk meets equal salaries highest key first. Reverse each
+            // such run, except the lowest salary taken, which may have been
+            // cut short: take it again in ascending order.
+            int lowest = SalaryIndex::salaryOf(top.back());
+            while (!top.empty() && SalaryIndex::salaryOf(top.back()) == lowest)
+            {
+                top.pop_back();
+            }
+            for (auto run = top.begin(); run != top.end(); )
+            {
+                auto runEnd = find_if(run, top.end(), [&](uint64_t key) {
+                    return SalaryIndex::salaryOf(key) != SalaryIndex::salaryOf(*run);
+                });
+                reverse(run, runEnd);
+                run = runEnd;
+            }
+            index.forEachBetween(lowest, lowest, [&](uint64_t key) {
+                if (keep(key))
+                {
+                    top.push_back(key);
+                }
+                return top.size() < count;
+            });
+            return top;
+        }
+
+        // Adds part's employees to total.
+        void addSummary(PayrollSummary& total, const PayrollSummary& part)
+        {
+            if (part.count == 0)
+            {
+                return;
+            }
+            total.minSalary = total.count == 0 ? part.minSalary : min(total.minSalary, part.minSalary);
+            total.maxSalary = total.count == 0 ? part.maxSalary : max(total.maxSalary, part.maxSalary);
+            total.count += part.count;
+            total.total += part.total;
+        }
+
+        // The employee a snapshot record describes.
+        Employee snapshotEmployee(const Snapshot& snapshot, const SnapshotRecord& record)
+        {
+            Employee employee(snapshot.firstName(record), snapshot.lastName(record));
+            employee.setEmployeeNumber(record.employeeNumber);
+            employee.setSalary(record.salary);
+            if (record.flags & SnapshotRecord::kHired)
+            {
+                employee.hire();
+            }
+            return employee;
+        }
+
+        int checkedSalary(long long salary)
+        {
+            if (salary < INT_MIN || salary > INT_MAX)
+            {
+                throw overflow_error("Salary out of range.");
+            }
+            return static_cast<int>(salary);
+        }
+    }
+
+    Database::Database(StorageLayout layout, int firstEmployeeNumber, int numberStride)
+        : mLayout(layout)
+        , mFirstEmployeeNumber(firstEmployeeNumber)
+        , mNumberStride(numberStride)
+        , mNextEmployeeNumber(firstEmployeeNumber)
+    {
+        if (numberStride < 1)
+        {
+            throw invalid_argument("Employee number stride must be positive.");
+        }
+    }
+
+    Database::~Database() = default;
+
+    Employee& Database::addEmployee(string_view firstName,
+                                    string_view lastName)
+    {
+        buildTiers();
+        RECORDS_TIME_OPERATION(Operation::AddEmployee);
+        // Records are constructed in place and adding more never moves
+        // them; only compaction does (see compactStep).
+        Employee& theEmployee = mEmployees.emplace_back(firstName, lastName);
+        theEmployee.setEmployeeNumber(mNextEmployeeNumber);
+        mNextEmployeeNumber += mNumberStride;
         theEmployee.hire();
-        mEmployees.push_back(theEmployee);
-        return mEmployees[mEmployees.size() - 1];
+        theEmployee.setListener(this);
+        indexEmployee(mEmployees.slotCount() - 1);
+        if (mLayout == StorageLayout::Columnar)
+        {
+            mColumns.append(theEmployee);
+        }
+        if (mLog != nullptr)
+        {
+            logAddition(theEmployee);
+        }
+        return theEmployee;
+    }
+
+    Employee& Database::insertEmployee(const Employee& employee)
+    {
+        buildTiers();
+        if (contains(employee.getEmployeeNumber()))
+        {
+            throw logic_error("Employee number is already in use.");
+        }
+        Employee& theEmployee = restoreEmployee(employee);
+        if (mLog != nullptr)
+        {
+            logAddition(theEmployee);
+        }
+        return theEmployee;
+    }
+
+    void Database::reserve(size_t count)
+    {
+        buildTiers();
+        reserveHot(count);
+    }
+
+    void Database::reserveHot(size_t count)
+    {
+        mEmployees.reserve(count);
+        if (count > mEmployees.size())
+        {
+            // Offsets of the numbers the next (count - size) hires will get.
+            size_t nextOffset;
+            if (numberOffset(mNextEmployeeNumber, nextOffset))
+            {
+                mSlotByNumber.reserve(nextOffset + (count - mEmployees.size()));
+            }
+        }
+        mSlotsByName.reserve(count);
+        if (mLayout == StorageLayout::Columnar)
+        {
+            mColumns.reserve(count);
+        }
+    }
+
+    Employee& Database::restoreEmployee(const Employee& employee)
+    {
+        Employee& theEmployee = mEmployees.emplace_back(employee);
+        theEmployee.setListener(this);
+        indexEmployee(mEmployees.slotCount() - 1);
+        if (mLayout == StorageLayout::Columnar)
+        {
+            mColumns.append(theEmployee);
+        }
+        // Only written when it grows, so building the tiers from a snapshot
+        // (see loadSnapshot) leaves it alone for concurrent readers.
+        int nextNumber = nextNumberAfter(theEmployee.getEmployeeNumber());
+        if (nextNumber > mNextEmployeeNumber)
+        {
+            mNextEmployeeNumber = nextNumber;
+        }
+        return theEmployee;
+    }
+
+    Employee& Database::getEmployee(int employeeNumber)
+    {
+        buildTiers();
+        RECORDS_TIME_OPERATION(Operation::GetEmployeeByNumber);
+        size_t entry = findEntry(employeeNumber);
+        if (entry == kNoSlot)
+        {
+            throw logic_error("No employee found.");
+        }
+        if (entry & kArchivedBit)
+        {
+            return rehydrate(employeeNumber, entry & ~kArchivedBit);
+        }
+        return mEmployees[entry];
+    }
+
+    const Employee& Database::getEmployee(int employeeNumber) const
+    {
+        buildTiers();
+        RECORDS_TIME_OPERATION(Operation::GetEmployeeByNumber);
+        size_t entry = findEntry(employeeNumber);
+        if (entry == kNoSlot)
+        {
+            throw logic_error("No employee found.");
+        }
+        if (entry & kArchivedBit)
+        {
+            // Bringing it back would change the store under a const caller.
+            throw logic_error("Employee is archived.");
+        }
+        return mEmployees[entry];
+    }
+
+    bool Database::findEmployee(int employeeNumber, Employee& result) const
+    {
+        if (readingSnapshot())
+        {
+            const SnapshotRecord* record = mSnapshot->find(employeeNumber);
+            if (record == nullptr)
+            {
+                return false;
+            }
+            result = snapshotEmployee(*mSnapshot, *record);
+            return true;
+        }
+        size_t entry = findEntry(employeeNumber);
+        if (entry == kNoSlot)
+        {
+            return false;
+        }
+        if (entry & kArchivedBit)
+        {
+            return mArchive.find(entry & ~kArchivedBit, employeeNumber, result);
+        }
+        result = mEmployees[entry];
+        return true;
+    }
+
+    bool Database::contains(int employeeNumber) const
+    {
+        if (readingSnapshot())
+        {
+            return mSnapshot->find(employeeNumber) != nullptr;
+        }
+        return findEntry(employeeNumber) != kNoSlot;
+    }
+
+    bool Database::isArchived(int employeeNumber) const
+    {
+        // Loaded records all go to the hot tier.
+        if (readingSnapshot())
+        {
+            return false;
+        }
+        size_t entry = findEntry(employeeNumber);
+        return entry != kNoSlot && (entry & kArchivedBit);
+    }
+
+    Employee& Database::rehydrate(int employeeNumber, size_t block)
+    {
+        Employee employee;
+        mArchive.find(block, employeeNumber, employee);
+        unindexNumber(employeeNumber, kArchivedBit | block);
+        unindexArchived(employee);
+        Employee& theEmployee = restoreEmployee(employee);
+        // It stayed counted while archived.
+        mCounters.remove(employee.getSalary(), employee.isHired());
+        mArchive.remove(block, employeeNumber);
+        return theEmployee;
+    }
+
+    Employee& Database::getEmployee(string_view firstName, string_view lastName)
+    {
+        buildTiers();
+        RECORDS_TIME_OPERATION(Operation::GetEmployeeByName);
+        // A name that was never interned cannot belong to anyone.
+        NameId first;
+        NameId last;
+        size_t earliest = kNoSlot;
+        size_t archived = kNoSlot;
+        if (NamePool::global().find(firstName, first) && NamePool::global().find(lastName, last))
+        {
+            auto range = mSlotsByName.equal_range(nameKey(first, last));
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second & kArchivedBit)
+                {
+                    archived = min(archived, it->second);
+                }
+                else
+                {
+                    earliest = min(earliest, it->second);
+                }
+            }
+        }
+        if (earliest != kNoSlot)
+        {
+            return mEmployees[earliest];
+        }
+        if (archived == kNoSlot)
+        {
+            throw logic_error("No employee found.");
+        }
+        // Not through getEmployee(int), which would time this lookup again.
+        int number = archivedNumber(archived & ~kArchivedBit);
+        return rehydrate(number, findEntry(number) & ~kArchivedBit);
+    }
+
+    vector<int> Database::findEmployees(string_view firstName,
+                                        string_view lastName) const
+    {
+        buildTiers();
+        vector<size_t> slots;
+        vector<size_t> archived;
+        NameId first;
+        NameId last;
+        if (NamePool::global().find(firstName, first) && NamePool::global().find(lastName, last))
+        {
+            auto range = mSlotsByName.equal_range(nameKey(first, last));
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second & kArchivedBit)
+                {
+                    archived.push_back(it->second & ~kArchivedBit);
+                }
+                else
+                {
+                    slots.push_back(it->second);
+                }
+            }
+            sort(slots.begin(), slots.end());
+            sort(archived.begin(), archived.end());
+        }
+
+        vector<int> numbers;
+        numbers.reserve(slots.size() + archived.size());
+        for (size_t slot : slots)
+        {
+            numbers.push_back(mEmployees[slot].getEmployeeNumber());
+        }
+        for (size_t key : archived)
+        {
+            numbers.push_back(archivedNumber(key));
+        }
+        return numbers;
+    }
+
+    uint64_t Database::nameKey(NameId firstName, NameId lastName)
+    {
+        return (static_cast<uint64_t>(lastName) << 32) | firstName;
+    }
+
+    void Database::employeeRenumbering(const Employee& employee, int newNumber)
+    {
+        // Checked before unindexNumber, so a refused number leaves the
+        // index as it was.
+        if (newNumber != employee.getEmployeeNumber() && contains(newNumber))
+        {
+            throw logic_error("Employee number is already in use.");
+        }
+    }
+
+    void Database::employeeChanging(const Employee& employee, EmployeeField field)
+    {
+        if (field == EmployeeField::Salary || field == EmployeeField::HiredStatus)
+        {
+            mCounters.remove(employee.getSalary(), employee.isHired());
+        }
+        switch (field)
+        {
+            case EmployeeField::FirstName:
+            case EmployeeField::LastName:
+                unindexName(slotOf(employee));
+                break;
+            case EmployeeField::EmployeeNumber:
+                mNumberBeforeChange = employee.getEmployeeNumber();
+                unindexNumber(mNumberBeforeChange, slotOf(employee));
+                break;
+            case EmployeeField::Salary:
+                if (mIndexSalaries)
+                {
+                    mSalaryIndex.erase(employee.getSalary(), slotOf(employee));
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void Database::employeeChanged(const Employee& employee, EmployeeField field)
+    {
+        if (field == EmployeeField::Salary || field == EmployeeField::HiredStatus)
+        {
+            mCounters.add(employee.getSalary(), employee.isHired());
+        }
+        switch (field)
+        {
+            case EmployeeField::FirstName:
+            case EmployeeField::LastName:
+                indexName(slotOf(employee));
+                break;
+            case EmployeeField::EmployeeNumber:
+            {
+                indexNumber(employee.getEmployeeNumber(), slotOf(employee));
+                // So addEmployee does not hand the number out again.
+                int nextNumber = nextNumberAfter(employee.getEmployeeNumber());
+                if (nextNumber > mNextEmployeeNumber)
+                {
+                    mNextEmployeeNumber = nextNumber;
+                }
+                break;
+            }
+            case EmployeeField::Salary:
+                if (mIndexSalaries)
+                {
+                    mSalaryIndex.insert(employee.getSalary(), slotOf(employee));
+                }
+                break;
+            default:
+                break;
+        }
+        if (mLayout == StorageLayout::Columnar)
+        {
+            mColumns.update(slotOf(employee), employee, field);
+        }
+        if (mLog != nullptr)
+        {
+            int employeeNumber = employee.getEmployeeNumber();
+            switch (field)
+            {
+                case EmployeeField::FirstName:
+                    logMutation(LogOperation::SetFirstName, employeeNumber, 0, employee.getFirstName());
+                    break;
+                case EmployeeField::LastName:
+                    logMutation(LogOperation::SetLastName, employeeNumber, 0, employee.getLastName());
+                    break;
+                case EmployeeField::EmployeeNumber:
+                    logMutation(LogOperation::SetEmployeeNumber, mNumberBeforeChange, employeeNumber);
+                    break;
+                case EmployeeField::Salary:
+                    logMutation(LogOperation::SetSalary, employeeNumber, employee.getSalary());
+                    break;
+                case EmployeeField::HiredStatus:
+                    logMutation(employee.isHired() ? LogOperation::Hire : LogOperation::Fire,
+                                employeeNumber, 0);
+                    break;
+            }
+        }
+    }
+
+    size_t Database::slotOf(const Employee& employee) const
+    {
+        size_t slot = findSlot(employee.getEmployeeNumber());
+        if (slot != kNoSlot && &mEmployees[slot] == &employee)
+        {
+            return slot;
+        }
+        return mEmployees.indexOf(employee);
+    }
+
+    size_t Database::findSlot(int employeeNumber) const
+    {
+        // kNoSlot has kArchivedBit set too.
+        size_t entry = findEntry(employeeNumber);
+        return (entry & kArchivedBit) ? kNoSlot : entry;
+    }
+
+    size_t Database::findEntry(int employeeNumber) const
+    {
+        // Numbers are handed out densely from mFirstEmployeeNumber, so the
+        // offset table resolves them in O(1).
+        size_t offset;
+        if (numberOffset(employeeNumber, offset) && offset < mSlotByNumber.size()
+            && mSlotByNumber[offset] != kNoSlot)
+        {
+            return mSlotByNumber[offset];
+        }
+        auto found = mSlotByOtherNumber.find(employeeNumber);
+        return found != mSlotByOtherNumber.end() ? found->second : kNoSlot;
+    }
+
+    bool Database::numberOffset(int employeeNumber, size_t& offset) const
+    {
+        if (employeeNumber < mFirstEmployeeNumber)
+        {
+            return false;
+        }
+        long long distance = static_cast<long long>(employeeNumber) - mFirstEmployeeNumber;
+        if (distance % mNumberStride != 0)
+        {
+            return false;
+        }
+        offset = static_cast<size_t>(distance / mNumberStride);
+        return true;
+    }
+
+    int Database::nextNumberAfter(int employeeNumber) const
+    {
+        if (employeeNumber < mFirstEmployeeNumber)
+        {
+            return mFirstEmployeeNumber;
+        }
+        long long steps = (static_cast<long long>(employeeNumber) - mFirstEmployeeNumber) / mNumberStride + 1;
+        return static_cast<int>(mFirstEmployeeNumber + steps * mNumberStride);
+    }
+
+    void Database::indexEmployee(size_t slot)
+    {
+        indexNumber(mEmployees[slot].getEmployeeNumber(), slot);
+        indexName(slot);
+        mCounters.add(mEmployees[slot].getSalary(), mEmployees[slot].isHired());
+        if (mIndexSalaries)
+        {
+            mSalaryIndex.insert(mEmployees[slot].getSalary(), slot);
+        }
+    }
+
+    void Database::indexNumber(int employeeNumber, size_t entry)
+    {
+        size_t offset;
+        // Growing the table to reach a far-off number would cost memory for
+        // every number in between; such numbers go to the hash map instead.
+        if (numberOffset(employeeNumber, offset) && offset < mSlotByNumber.size() + kMaxTableGap)
+        {
+            if (offset >= mSlotByNumber.size())
+            {
+                mSlotByNumber.resize(offset + 1, kNoSlot);
+            }
+            mSlotByNumber[offset] = entry;
+        }
+        else
+        {
+            mSlotByOtherNumber[employeeNumber] = entry;
+        }
+    }
+
+    void Database::unindexNumber(int employeeNumber, size_t entry)
+    {
+        size_t offset;
+        if (numberOffset(employeeNumber, offset) && offset < mSlotByNumber.size()
+            && mSlotByNumber[offset] == entry)
+        {
+            mSlotByNumber[offset] = kNoSlot;
+            return;
+        }
+        auto found = mSlotByOtherNumber.find(employeeNumber);
+        if (found != mSlotByOtherNumber.end() && found->second == entry)
+        {
+            mSlotByOtherNumber.erase(found);
+        }
+    }
+
+    void Database::indexName(size_t slot)
+    {
+        indexName(mEmployees[slot], slot);
+    }
+
+    void Database::unindexName(size_t slot)
+    {
+        unindexName(mEmployees[slot], slot);
+    }
+
+    void Database::indexName(const Employee& employee, size_t entry)
+    {
+        mSlotsByName.emplace(nameKey(employee.getFirstNameId(), employee.getLastNameId()), entry);
+    }
+
+    void Database::unindexName(const Employee& employee, size_t entry)
+    {
+        auto range = mSlotsByName.equal_range(nameKey(employee.getFirstNameId(),
+                                                      employee.getLastNameId()));
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == entry)
+            {
+                mSlotsByName.erase(it);
+                return;
+            }
+        }
+    }
+
+    size_t Database::archivedKey(int employeeNumber)
+    {
+        // Flipping the sign bit makes the unsigned order match int order.
+        return static_cast<uint32_t>(employeeNumber) ^ 0x80000000u;
+    }
+
+    int Database::archivedNumber(size_t key)
+    {
+        return static_cast<int>(static_cast<uint32_t>(key) ^ 0x80000000u);
+    }
+
+    void Database::indexArchived(const Employee& employee)
+    {
+        size_t key = archivedKey(employee.getEmployeeNumber());
+        indexName(employee, kArchivedBit | key);
+        if (mIndexSalaries)
+        {
+            mArchivedSalaries.insert(employee.getSalary(), key);
+        }
+    }
+
+    void Database::unindexArchived(const Employee& employee)
+    {
+        size_t key = archivedKey(employee.getEmployeeNumber());
+        unindexName(employee, kArchivedBit | key);
+        if (mIndexSalaries)
+        {
+            mArchivedSalaries.erase(employee.getSalary(), key);
+        }
+    }
+
+    void Database::adjustSalaries(const vector<SalaryAdjustment>& adjustments, unsigned threads)
+    {
+        buildTiers();
+        // Primary-key entries: slots, or archive blocks for archived
+        // employees, which are checked separately and brought back to the
+        // hot tier only once the whole batch is known to succeed.
+        vector<size_t> slots(adjustments.size());
+        runInRanges(adjustments.size(), threads, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                slots[i] = findEntry(adjustments[i].employeeNumber);
+                if (slots[i] == kNoSlot)
+                {
+                    throw logic_error("No employee found.");
+                }
+            }
+        });
+        vector<pair<int, long long>> archived;
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            if (slots[i] & kArchivedBit)
+            {
+                archived.emplace_back(adjustments[i].employeeNumber, adjustments[i].delta);
+            }
+        }
+
+        // Bring each employee's deltas together, in slot order so the final
+        // pass walks the store sequentially. A batch covering a good part
+        // of the roster is summed into a table indexed by slot; a small one
+        // is sorted instead.
+        vector<pair<size_t, long long>> deltas;
+        if (adjustments.size() >= mEmployees.size() / 8)
+        {
+            vector<long long> totals(mEmployees.slotCount(), 0);
+            vector<uint64_t> touched((mEmployees.slotCount() + 63) / 64, 0);
+            for (size_t i = 0; i < slots.size(); ++i)
+            {
+                if (slots[i] & kArchivedBit)
+                {
+                    continue;
+                }
+                totals[slots[i]] += adjustments[i].delta;
+                touched[slots[i] >> 6] |= uint64_t{1} << (slots[i] & 63);
+            }
+            for (size_t word = 0; word < touched.size(); ++word)
+            {
+                for (uint64_t bits = touched[word]; bits != 0; bits &= bits - 1)
+                {
+                    size_t slot = (word << 6) + static_cast<size_t>(__builtin_ctzll(bits));
+                    deltas.emplace_back(slot, totals[slot]);
+                }
+            }
+        }
+        else
+        {
+            deltas.reserve(slots.size());
+            for (size_t i = 0; i < slots.size(); ++i)
+            {
+                if (!(slots[i] & kArchivedBit))
+                {
+                    deltas.emplace_back(slots[i], adjustments[i].delta);
+                }
+            }
+            sort(deltas.begin(), deltas.end(),
+                 [](const auto& a, const auto& b) { return a.first < b.first; });
+            size_t unique = 0;
+            for (size_t i = 0; i < deltas.size(); ++i)
+            {
+                if (unique != 0 && deltas[unique - 1].first == deltas[i].first)
+                {
+                    deltas[unique - 1].second += deltas[i].second;
+                }
+                else
+                {
+                    deltas[unique++] = deltas[i];
+                }
+            }
+            deltas.resize(unique);
+        }
+
+        vector<pair<size_t, int>> salaries(deltas.size());
+        runInRanges(deltas.size(), threads, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                size_t slot = deltas[i].first;
+                salaries[i] = { slot, checkedSalary(mEmployees[slot].getSalary() + deltas[i].second) };
+            }
+        });
+
+        sort(archived.begin(), archived.end(),
+             [](const auto& a, const auto& b) { return a.first < b.first; });
+        vector<pair<int, int>> archivedSalaries;
+        for (size_t i = 0; i < archived.size(); )
+        {
+            int employeeNumber = archived[i].first;
+            long long delta = 0;
+            for (; i < archived.size() && archived[i].first == employeeNumber; ++i)
+            {
+                delta += archived[i].second;
+            }
+            Employee employee;
+            findEmployee(employeeNumber, employee);
+            archivedSalaries.emplace_back(employeeNumber, checkedSalary(employee.getSalary() + delta));
+        }
+
+        applySalaries(salaries);
+        // Brought back after every existing record, so still in slot order.
+        for (const auto& [employeeNumber, salary] : archivedSalaries)
+        {
+            getEmployee(employeeNumber).setSalary(salary);
+        }
+    }
+
+    size_t Database::adjustSalaries(const function<bool(const Employee&)>& predicate,
+                                    double percent, unsigned threads)
+    {
+        buildTiers();
+        if (!isfinite(percent))
+        {
+            throw invalid_argument("Raise percentage must be finite.");
+        }
+        auto raised = [percent](const Employee& employee) {
+            double salary = employee.getSalary() * (1.0 + percent / 100.0);
+            if (!(salary > LLONG_MIN && salary < LLONG_MAX))
+            {
+                throw overflow_error("Salary out of range.");
+            }
+            return checkedSalary(llround(salary));
+        };
+        size_t count = mEmployees.slotCount();
+        vector<vector<pair<size_t, int>>> selected(workerCount(count, threads));
+        runInRanges(count, threads, [&](size_t worker, size_t begin, size_t end) {
+            for (size_t slot = begin; slot < end; ++slot)
+            {
+                if (mEmployees.isVacant(slot))
+                {
+                    continue;
+                }
+                const Employee& employee = mEmployees[slot];
+                if (predicate(employee))
+                {
+                    selected[worker].emplace_back(slot, raised(employee));
+                }
+            }
+        });
+        // Archived employees are selected from copies, on this thread, and
+        // brought back to the hot tier only if the whole batch succeeds.
+        vector<pair<int, int>> archivedSalaries;
+        mArchive.forEach([&](const Employee& employee) {
+            if (predicate(employee))
+            {
+                archivedSalaries.emplace_back(employee.getEmployeeNumber(), raised(employee));
+            }
+        });
+
+        size_t changed = archivedSalaries.size();
+        for (const auto& salaries : selected)
+        {
+            applySalaries(salaries);
+            changed += salaries.size();
+        }
+        for (const auto& [employeeNumber, salary] : archivedSalaries)
+        {
+            getEmployee(employeeNumber).setSalary(salary);
+        }
+        return changed;
     }
 
-    Employee& Database::getEmployee(int employeeNumber)
+    void Database::applySalaries(const vector<pair<size_t, int>>& salaries)
+    {
+        for (const auto& [slot, salary] : salaries)
+        {
+            mEmployees[slot].setSalary(salary);
+        }
+    }
+
+    const RosterCounters& Database::getCounters() const
+    {
+        buildTiers();
+        return mCounters;
+    }
+
+    void Database::setSalaryBuckets(int lowest, int bucketWidth, size_t bucketCount)
+    {
+        buildTiers();
+        RosterCounters counters(lowest, bucketWidth, bucketCount);
+        for (const auto& employee : mEmployees)
+        {
+            counters.add(employee.getSalary(), employee.isHired());
+        }
+        mArchive.forEach([&](const Employee& employee) { counters.add(employee.getSalary(), false); });
+        mCounters = move(counters);
+    }
+
+    void Database::indexSalaries()
     {
-        for (auto& employee : mEmployees) 
+        buildTiers();
+        vector<uint64_t> keys;
+        keys.reserve(mEmployees.size());
+        for (size_t slot = 0; slot < mEmployees.slotCount(); ++slot)
         {
-            if (employee.getEmployeeNumber() == employeeNumber) 
+            if (mEmployees.isVacant(slot))
             {
-                return employee;
+                continue;
             }
+            keys.push_back(SalaryIndex::key(mEmployees[slot].getSalary(), slot));
         }
-        throw logic_error("No employee found.");
+        mSalaryIndex.assign(move(keys));
+
+        vector<uint64_t> archivedKeys;
+        archivedKeys.reserve(mArchive.size());
+        mArchive.forEach([&](const Employee& employee) {
+            archivedKeys.push_back(SalaryIndex::key(employee.getSalary(), archivedKey(employee.getEmployeeNumber())));
+        });
+        mArchivedSalaries.assign(move(archivedKeys));
+        mIndexSalaries = true;
     }
 
-    void Database::displayAll() const
+    bool Database::hasSalaryIndex() const
+    {
+        return mIndexSalaries;
+    }
+
+    bool Database::covers(size_t slot, StatusFilter filter) const
+    {
+        return filter == StatusFilter::All
+            || mEmployees[slot].isHired() == (filter == StatusFilter::Current);
+    }
+
+    vector<pair<int, int>> Database::archivedBySalary(StatusFilter filter) const
+    {
+        vector<pair<int, int>> archived;
+        // Archived employees are never hired.
+        if (filter != StatusFilter::Current)
+        {
+            archived.reserve(mArchive.size());
+            mArchive.forEach([&](const Employee& employee) {
+                archived.emplace_back(employee.getSalary(), employee.getEmployeeNumber());
+            });
+        }
+        return archived;
+    }
+
+    vector<int> Database::findEmployeesBySalary(int minSalary, int maxSalary, StatusFilter filter) const
+    {
+        buildTiers();
+        // (salary, number) pairs from the hot tier, lowest salary first.
+        vector<pair<int, int>> hot;
+        if (mIndexSalaries)
+        {
+            mSalaryIndex.forEachBetween(minSalary, maxSalary, [&](uint64_t key) {
+                size_t slot = SalaryIndex::slotOf(key);
+                if (covers(slot, filter))
+                {
+                    hot.emplace_back(SalaryIndex::salaryOf(key), mEmployees[slot].getEmployeeNumber());
+                }
+                return true;
+            });
+        }
+        else
+        {
+            vector<uint64_t> matches;
+            for (size_t slot = 0; slot < mEmployees.slotCount(); ++slot)
+            {
+                if (mEmployees.isVacant(slot))
+                {
+                    continue;
+                }
+                int salary = mEmployees[slot].getSalary();
+                if (salary >= minSalary && salary <= maxSalary && covers(slot, filter))
+                {
+                    matches.push_back(SalaryIndex::key(salary, slot));
+                }
+            }
+            sort(matches.begin(), matches.end());
+            for (uint64_t key : matches)
+            {
+                hot.emplace_back(SalaryIndex::salaryOf(key), mEmployees[SalaryIndex::slotOf(key)].getEmployeeNumber());
+            }
+        }
+
+        // The same from the archive, lowest salary and then number first.
+        vector<pair<int, int>> archived;
+        if (mIndexSalaries)
+        {
+            // Archived employees are never hired.
+            if (filter != StatusFilter::Current)
+            {
+                mArchivedSalaries.forEachBetween(minSalary, maxSalary, [&](uint64_t key) {
+                    archived.emplace_back(SalaryIndex::salaryOf(key), archivedNumber(SalaryIndex::slotOf(key)));
+                    return true;
+                });
+            }
+        }
+        else
+        {
+            archived = archivedBySalary(filter);
+            archived.erase(remove_if(archived.begin(), archived.end(), [&](const pair<int, int>& entry) {
+                               return entry.first < minSalary || entry.first > maxSalary;
+                           }),
+                           archived.end());
+            sort(archived.begin(), archived.end());
+        }
+        auto lower = [](const pair<int, int>& a, const pair<int, int>& b) { return a.first < b.first; };
+        // merge takes from the hot tier first among equal salaries.
+        vector<pair<int, int>> merged;
+        merged.reserve(hot.size() + archived.size());
+        merge(hot.begin(), hot.end(), archived.begin(), archived.end(), back_inserter(merged), lower);
+
+        vector<int> numbers;
+        numbers.reserve(merged.size());
+        for (const auto& entry : merged)
+        {
+            numbers.push_back(entry.second);
+        }
+        return numbers;
+    }
+
+    vector<int> Database::getTopEarners(size_t count, StatusFilter filter) const
+    {
+        buildTiers();
+        if (count == 0)
+        {
+            return {};
+        }
+        // Ranked by salary, highest first, then by slot.
+        vector<uint64_t> top;
+        if (mIndexSalaries)
+        {
+            top = topKeys(mSalaryIndex, count, [&](uint64_t key) {
+                return covers(SalaryIndex::slotOf(key), filter);
+            });
+        }
+        else
+        {
+            for (size_t slot = 0; slot < mEmployees.slotCount(); ++slot)
+            {
+                if (!mEmployees.isVacant(slot) && covers(slot, filter))
+                {
+                    top.push_back(SalaryIndex::key(mEmployees[slot].getSalary(), slot));
+                }
+            }
+            size_t kept = min(count, top.size());
+            partial_sort(top.begin(), top.begin() + static_cast<ptrdiff_t>(kept), top.end(),
+                         [](uint64_t a, uint64_t b) {
+                             int salaryA = SalaryIndex::salaryOf(a);
+                             int salaryB = SalaryIndex::salaryOf(b);
+                             return salaryA != salaryB ? salaryA > salaryB : a < b;
+                         });
+            top.resize(kept);
+        }
+        vector<pair<int, int>> hot;
+        hot.reserve(top.size());
+        for (uint64_t key : top)
+        {
+            hot.emplace_back(SalaryIndex::salaryOf(key), mEmployees[SalaryIndex::slotOf(key)].getEmployeeNumber());
+        }
+
+        // The same from the archive, highest salary and then lowest number
+        // first.
+        vector<pair<int, int>> archived;
+        if (mIndexSalaries)
+        {
+            if (filter != StatusFilter::Current)
+            {
+                for (uint64_t key : topKeys(mArchivedSalaries, count, [](uint64_t) { return true; }))
+                {
+                    archived.emplace_back(SalaryIndex::salaryOf(key), archivedNumber(SalaryIndex::slotOf(key)));
+                }
+            }
+        }
+        else
+        {
+            archived = archivedBySalary(filter);
+            size_t kept = min(count, archived.size());
+            partial_sort(archived.begin(), archived.begin() + static_cast<ptrdiff_t>(kept), archived.end(),
+                         [](const pair<int, int>& a, const pair<int, int>& b) {
+                             return a.first != b.first ? a.first > b.first : a.second < b.second;
+                         });
+            archived.resize(kept);
+        }
+        auto higher = [](const pair<int, int>& a, const pair<int, int>& b) { return a.first > b.first; };
+        // merge takes from the hot tier first among equal salaries.
+        vector<pair<int, int>> merged;
+        merged.reserve(hot.size() + archived.size());
+        merge(hot.begin(), hot.end(), archived.begin(), archived.end(), back_inserter(merged), higher);
+        merged.resize(min(merged.size(), count));
+
+        vector<int> numbers;
+        numbers.reserve(merged.size());
+        for (const auto& entry : merged)
+        {
+            numbers.push_back(entry.second);
+        }
+        return numbers;
+    }
+
+    template <typename Query, typename Combine>
+    auto Database::queryPayroll(StatusFilter filter, Query&& query, Combine&& combine) const
     {
-        for (const auto& employee : mEmployees) 
+        buildTiers();
+        auto scanHot = [&]() {
+            if (mLayout == StorageLayout::Columnar)
+            {
+                const int* salaries = mColumns.salaries().data();
+                const uint64_t* hiredBits = mColumns.hiredBits().data();
+                size_t gapBegin = mEmployees.gapBegin();
+                size_t gapEnd = mEmployees.gapEnd();
+                if (gapBegin == gapEnd)
+                {
+                    return query(PayrollScan(salaries, hiredBits, mColumns.size()));
+                }
+                // Compaction is under way: scan the records on either side of
+                // the gap. compactStep leaves its end on a bitmap word boundary.
+                auto result = query(PayrollScan(salaries, hiredBits, gapBegin));
+                combine(result, query(PayrollScan(salaries + gapEnd, hiredBits + gapEnd / 64,
+                                                  mColumns.size() - gapEnd)));
+                return result;
+            }
+            vector<int> salaries;
+            vector<uint64_t> hiredBits((mEmployees.size() + 63) / 64, 0);
+            salaries.reserve(mEmployees.size());
+            for (const auto& employee : mEmployees)
+            {
+                size_t slot = salaries.size();
+                hiredBits[slot >> 6] |= static_cast<uint64_t>(employee.isHired()) << (slot & 63);
+                salaries.push_back(employee.getSalary());
+            }
+            return query(PayrollScan(salaries.data(), hiredBits.data(), salaries.size()));
+        };
+        auto result = scanHot();
+        // Former employees include the archived ones, whose salaries are
+        // decoded into a temporary column. None of them is hired.
+        if (filter != StatusFilter::Current && mArchive.size() != 0)
         {
-            employee.display();
+            vector<int> salaries;
+            salaries.reserve(mArchive.size());
+            mArchive.forEach([&](const Employee& employee) { salaries.push_back(employee.getSalary()); });
+            vector<uint64_t> hiredBits((salaries.size() + 63) / 64, 0);
+            combine(result, query(PayrollScan(salaries.data(), hiredBits.data(), salaries.size())));
         }
+        return result;
+    }
+
+    PayrollSummary Database::getPayroll(StatusFilter filter) const
+    {
+        return queryPayroll(filter, [&](const PayrollScan& scan) { return scan.summarize(filter); },
+                            addSummary);
+    }
+
+    size_t Database::countSalariesAbove(int threshold, StatusFilter filter) const
+    {
+        return queryPayroll(filter, [&](const PayrollScan& scan) { return scan.countAbove(threshold, filter); },
+                            [](size_t& total, size_t part) { total += part; });
+    }
 
+    vector<size_t> Database::getSalaryHistogram(int lowest, int bucketWidth, size_t bucketCount,
+                                                StatusFilter filter) const
+    {
+        return queryPayroll(filter,
+            [&](const PayrollScan& scan) { return scan.histogram(lowest, bucketWidth, bucketCount, filter); },
+            [](vector<size_t>& total, const vector<size_t>& part) {
+                for (size_t bucket = 0; bucket < total.size(); ++bucket)
+                {
+                    total[bucket] += part[bucket];
+                }
+            });
+    }
+
+    void Database::displayAll() const
+    {
+        RECORDS_TIME_OPERATION(Operation::DisplayAll);
+        if (readingSnapshot())
+        {
+            displaySnapshot(StatusFilter::All);
+            return;
+        }
+        ReportWriter writer;
+        for (const auto& employee : mEmployees)
+        {
+            writer.write(employee);
+        }
+        mArchive.forEach([&](const Employee& employee) { writer.write(employee); });
     }
     void Database::displayCurrent() const
     {
-        for (const auto& employee : mEmployees) 
+        RECORDS_TIME_OPERATION(Operation::DisplayCurrent);
+        if (readingSnapshot())
+        {
+            displaySnapshot(StatusFilter::Current);
+            return;
+        }
+        ReportWriter writer;
+        if (mLayout == StorageLayout::Columnar)
+        {
+            mColumns.forEach(true, [&](size_t slot) { writer.write(mEmployees[slot]); });
+            return;
+        }
+        for (const auto& employee : mEmployees)
         {
             if (employee.isHired())
             {
-                employee.display();
+                writer.write(employee);
             }
         }
     }
     void Database::displayFormer() const
     {
-        for (const auto& employee : mEmployees) 
+        RECORDS_TIME_OPERATION(Operation::DisplayFormer);
+        if (readingSnapshot())
+        {
+            displaySnapshot(StatusFilter::Former);
+            return;
+        }
+        ReportWriter writer;
+        if (mLayout == StorageLayout::Columnar)
+        {
+            mColumns.forEach(false, [&](size_t slot) { writer.write(mEmployees[slot]); });
+        }
+        else
+        {
+            for (const auto& employee : mEmployees)
+            {
+                if (!employee.isHired())
+                {
+                    writer.write(employee);
+                }
+            }
+        }
+        mArchive.forEach([&](const Employee& employee) { writer.write(employee); });
+    }
+
+    void Database::displaySnapshot(StatusFilter filter) const
+    {
+        ReportWriter writer;
+        for (size_t index = 0; index < mSnapshot->size(); ++index)
+        {
+            const SnapshotRecord& record = mSnapshot->record(index);
+            bool hired = (record.flags & SnapshotRecord::kHired) != 0;
+            if (filter == StatusFilter::All || hired == (filter == StatusFilter::Current))
+            {
+                writer.write(snapshotEmployee(*mSnapshot, record));
+            }
+        }
+    }
+
+    bool Database::compactStep(size_t maxRecords)
+    {
+        buildTiers();
+        // Whole multiples of 64 slots keep the gap's end on a word boundary
+        // of the columns' hired bitmap between steps.
+        size_t step = (max<size_t>(maxRecords, 1) + 63) & ~size_t{63};
+        size_t end = min(mEmployees.gapEnd() + step, mEmployees.slotCount());
+        while (mEmployees.gapEnd() < end)
+        {
+            if (mEmployees[mEmployees.gapEnd()].isHired())
+            {
+                compactKeep();
+            }
+            else
+            {
+                compactArchive();
+            }
+        }
+        if (mEmployees.gapEnd() < mEmployees.slotCount())
+        {
+            if (mLayout == StorageLayout::Columnar)
+            {
+                mColumns.setGap(mEmployees.gapBegin(), mEmployees.gapEnd());
+            }
+            return false;
+        }
+        mEmployees.closeGap();
+        if (mLayout == StorageLayout::Columnar)
+        {
+            mColumns.truncate(mEmployees.slotCount());
+        }
+        return true;
+    }
+
+    void Database::compact()
+    {
+        while (!compactStep())
+        {
+        }
+    }
+
+    void Database::compactKeep()
+    {
+        size_t from = mEmployees.gapEnd();
+        size_t to = mEmployees.gapBegin();
+        if (from == to)
+        {
+            mEmployees.keepNext();
+            return;
+        }
+        const Employee& employee = mEmployees[from];
+        unindexNumber(employee.getEmployeeNumber(), from);
+        unindexName(from);
+        if (mIndexSalaries)
+        {
+            mSalaryIndex.erase(employee.getSalary(), from);
+        }
+        mEmployees.keepNext();
+
+        Employee& moved = mEmployees[to];
+        moved.setListener(this);
+        indexNumber(moved.getEmployeeNumber(), to);
+        indexName(to);
+        if (mIndexSalaries)
+        {
+            mSalaryIndex.insert(moved.getSalary(), to);
+        }
+        if (mLayout == StorageLayout::Columnar)
+        {
+            mColumns.move(from, to);
+        }
+    }
+
+    void Database::compactArchive()
+    {
+        size_t slot = mEmployees.gapEnd();
+        const Employee& employee = mEmployees[slot];
+        size_t block = mArchive.add(employee);
+        unindexNumber(employee.getEmployeeNumber(), slot);
+        indexNumber(employee.getEmployeeNumber(), kArchivedBit | block);
+        unindexName(slot);
+        if (mIndexSalaries)
+        {
+            mSalaryIndex.erase(employee.getSalary(), slot);
+        }
+        indexArchived(employee);
+        mEmployees.eraseNext();
+    }
+
+    size_t Database::archivedCount() const
+    {
+        return mArchive.size();
+    }
+
+    size_t Database::archivedBytes() const
+    {
+        return mArchive.byteSize();
+    }
+
+    StorageLayout Database::getLayout() const
+    {
+        return mLayout;
+    }
+
+    const EmployeeColumns& Database::getColumns() const
+    {
+        buildTiers();
+        if (mLayout != StorageLayout::Columnar)
+        {
+            throw logic_error("Database does not keep columns.");
+        }
+        return mColumns;
+    }
+
+    void Database::saveSnapshot(const string& path) const
+    {
+        buildTiers();
+        Snapshot::save(*this, path);
+    }
+
+    void Database::loadSnapshot(const string& path)
+    {
+        if (size() != 0)
+        {
+            throw logic_error("Snapshots can only be loaded into an empty database.");
+        }
+        auto snapshot = make_unique<Snapshot>(path);
+        mNextEmployeeNumber = max(mNextEmployeeNumber, snapshot->getNextEmployeeNumber());
+        mLogSequence = snapshot->getLogSequence();
+        if (snapshot->size() != 0)
+        {
+            // Records are sorted by number, so the last one is the highest.
+            int highest = snapshot->record(snapshot->size() - 1).employeeNumber;
+            mNextEmployeeNumber = max(mNextEmployeeNumber, nextNumberAfter(highest));
+            mSnapshot = move(snapshot);
+            mReadingSnapshot.store(true, memory_order_release);
+        }
+    }
+
+    void Database::buildFromSnapshot() const
+    {
+        lock_guard<mutex> lock(mSnapshotMutex);
+        if (!mReadingSnapshot.load(memory_order_relaxed))
+        {
+            return;
+        }
+        // Readers that saw mReadingSnapshot set use only mSnapshot, which
+        // stays mapped, so the tiers can be filled under them.
+        Database* self = const_cast<Database*>(this);
+        self->restoreSnapshot(*mSnapshot);
+        self->mReadingSnapshot.store(false, memory_order_release);
+    }
+
+    void Database::closeSnapshot()
+    {
+        as_const(*this).buildTiers();
+        mSnapshot.reset();
+    }
+
+    void Database::restoreSnapshot(const Snapshot& snapshot)
+    {
+        // Intern each distinct name once; records then map table indexes
+        // straight to NameIds.
+        vector<NameId> ids;
+        ids.reserve(snapshot.nameCount());
+        for (size_t index = 0; index < snapshot.nameCount(); ++index)
+        {
+            ids.push_back(NamePool::global().intern(snapshot.name(static_cast<uint32_t>(index))));
+        }
+
+        // Check every record before adding any, so a damaged file leaves
+        // the tiers empty. restoreEmployee would let a repeated number
+        // overwrite its index entry.
+        for (size_t index = 0; index < snapshot.size(); ++index)
+        {
+            const SnapshotRecord& record = snapshot.record(index);
+            if (record.firstName >= ids.size() || record.lastName >= ids.size())
+            {
+                throw runtime_error("Snapshot record refers to a missing name.");
+            }
+            if (index != 0 && record.employeeNumber <= snapshot.record(index - 1).employeeNumber)
+            {
+                throw runtime_error("Snapshot records are not in increasing number order.");
+            }
+        }
+
+        reserveHot(snapshot.size());
+        for (size_t index = 0; index < snapshot.size(); ++index)
+        {
+            const SnapshotRecord& record = snapshot.record(index);
+            Employee employee(ids[record.firstName], ids[record.lastName]);
+            employee.setEmployeeNumber(record.employeeNumber);
+            employee.setSalary(record.salary);
+            if (record.flags & SnapshotRecord::kHired)
+            {
+                employee.hire();
+            }
+            restoreEmployee(employee);
+        }
+    }
+
+    void Database::attachLog(WriteAheadLog* log)
+    {
+        mLog = log;
+        if (mLog != nullptr)
+        {
+            mLog->resumeAfter(mLogSequence);
+        }
+    }
+
+    void Database::recover(const string& snapshotPath, const string& logPath)
+    {
+        if (size() != 0)
+        {
+            throw logic_error("Recovery needs an empty database.");
+        }
+        if (ifstream(snapshotPath).good())
+        {
+            loadSnapshot(snapshotPath);
+        }
+
+        // Replayed mutations are already in the log; don't append them again.
+        WriteAheadLog* log = mLog;
+        mLog = nullptr;
+        try
+        {
+            mLogSequence = WriteAheadLog::replay(logPath, mLogSequence,
+                [this](const LogEntry& entry) { applyLogEntry(entry); });
+        }
+        catch (...)
+        {
+            mLog = log;
+            throw;
+        }
+        attachLog(log);
+    }
+
+    void Database::checkpoint(const string& snapshotPath)
+    {
+        if (mLog != nullptr)
+        {
+            mLog->commit();
+        }
+        saveSnapshot(snapshotPath);
+        if (mLog != nullptr)
+        {
+            mLog->truncate();
+        }
+    }
+
+    uint64_t Database::getLogSequence() const
+    {
+        return mLogSequence;
+    }
+
+    void Database::logAddition(const Employee& employee)
+    {
+        // Replay recreates an added employee as hired at the default salary.
+        string_view firstName = employee.getFirstName();
+        string names;
+        names.reserve(firstName.size() + employee.getLastName().size());
+        names.append(firstName).append(employee.getLastName());
+        int employeeNumber = employee.getEmployeeNumber();
+        logMutation(LogOperation::AddEmployee, employeeNumber,
+                    static_cast<int>(firstName.size()), names);
+        if (employee.getSalary() != kDefaultStartingSlalary)
+        {
+            logMutation(LogOperation::SetSalary, employeeNumber, employee.getSalary());
+        }
+        if (!employee.isHired())
+        {
+            logMutation(LogOperation::Fire, employeeNumber, 0);
+        }
+    }
+
+    void Database::logMutation(LogOperation operation, int employeeNumber, int value,
+                               string_view text)
+    {
+        mLogSequence = mLog->append(operation, employeeNumber, value, text);
+    }
+
+    void Database::applyLogEntry(const LogEntry& entry)
+    {
+        buildTiers();
+        switch (entry.operation)
         {
-            if (!employee.isHired())
+            case LogOperation::AddEmployee:
             {
-                employee.display();
+                string_view names = entry.text;
+                size_t firstLength = min(static_cast<size_t>(max(entry.value, 0)), names.size());
+                Employee employee(names.substr(0, firstLength), names.substr(firstLength));
+                employee.setEmployeeNumber(entry.employeeNumber);
+                employee.hire();
+                restoreEmployee(employee);
+                break;
             }
+            case LogOperation::SetFirstName:
+                getEmployee(entry.employeeNumber).setFirstName(entry.text);
+                break;
+            case LogOperation::SetLastName:
+                getEmployee(entry.employeeNumber).setLastName(entry.text);
+                break;
+            case LogOperation::SetEmployeeNumber:
+                getEmployee(entry.employeeNumber).setEmployeeNumber(entry.value);
+                break;
+            case LogOperation::SetSalary:
+                getEmployee(entry.employeeNumber).setSalary(entry.value);
+                break;
+            case LogOperation::Hire:
+                getEmployee(entry.employeeNumber).hire();
+                break;
+            case LogOperation::Fire:
+                getEmployee(entry.employeeNumber).fire();
+                break;
+            default:
+                throw runtime_error("Write-ahead log entry has an unknown operation.");
+        }
+    }
+
+    size_t Database::size() const
+    {
+        if (readingSnapshot())
+        {
+            return mSnapshot->size();
         }
+        return mEmployees.size() + mArchive.size();
+    }
+
+    int Database::getNextEmployeeNumber() const
+    {
+        return mNextEmployeeNumber;
+    }
+
+    EmployeeStore::const_iterator Database::begin() const
+    {
+        buildTiers();
+        return mEmployees.begin();
+    }
+
+    EmployeeStore::const_iterator Database::end() const
+    {
+        buildTiers();
+        return mEmployees.end();
     }
 }
\ No newline at end of file
@@ -1,29 +1,399 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "Employee.h"
+#include "EmployeeArchive.h"
+#include "EmployeeColumns.h"
+#include "EmployeeStore.h"
+#include "Payroll.h"
+#include "RosterCounters.h"
+#include "SalaryIndex.h"
+#include "WriteAheadLog.h"
 
-namespace Records 
+namespace Records
 {
+    class Snapshot;
+
     const int kDefaultEmployeeNumber = 1000;
 
-    class Database
+    // A raise for one employee in Database::adjustSalaries; a negative
+    // delta is a cut.
+    struct SalaryAdjustment
+    {
+        int employeeNumber;
+        int delta;
+    };
+
+    enum class StorageLayout
+    {
+        // Employee records only.
+        Rows,
+        // Employee records plus an EmployeeColumns copy kept in sync with
+        // them, which status filters and salary aggregates scan instead.
+        Columnar
+    };
+
+    // A Database binds itself to the employees it owns so that its indexes
+    // follow changes made through the references it hands out. It can
+    // therefore be neither copied nor moved.
+    //
+    // Records live in one of two tiers. New and loaded employees go to the
+    // hot tier, which iteration (begin and end) walks. Compaction moves
+    // former employees from there to a compressed archive (see
+    // EmployeeArchive). Every other query covers both tiers: archived
+    // employees still count, display and match as former employees. Name
+    // lookups, and salary orderings once salaries are indexed, use index
+    // entries kept for archived employees; other queries that ask for them
+    // decode the archive. Current-only queries never touch it. Looking up
+    // an archived employee with the non-const getEmployee moves it back to
+    // the hot tier, after the existing records; changing one does the same.
+    //
+    // A database filled by loadSnapshot reads the mapped file until it
+    // first needs the tiers, and builds them then; see loadSnapshot.
+    class Database : private EmployeeListener
     {
         public:
-            Employee& addEmployee(const std::string& firstName,
-                                   const std::string& lastName);
+            // New employees are numbered firstEmployeeNumber,
+            // firstEmployeeNumber + numberStride, and so on. A stride above
+            // one lets several databases share one number space (see
+            // ConcurrentDatabase).
+            explicit Database(StorageLayout layout = StorageLayout::Rows,
+                              int firstEmployeeNumber = kDefaultEmployeeNumber,
+                              int numberStride = 1);
+            ~Database();
+            Database(const Database&) = delete;
+            Database& operator=(const Database&) = delete;
+
+            Employee& addEmployee(std::string_view firstName,
+                                  std::string_view lastName);
+            // Hires everyone in names, a range of (firstName, lastName) pairs
+            // such as a std::vector<std::pair<std::string, std::string>>.
+            // Storage and indexes are sized once for the whole batch and the
+            // new employees get one contiguous block of numbers, the first of
+            // which is returned.
+            template <typename Range>
+            int addEmployees(const Range& names)
+            {
+                using std::begin;
+                using std::end;
+                reserve(hotSize() + static_cast<std::size_t>(std::distance(begin(names), end(names))));
+                int firstNumber = mNextEmployeeNumber;
+                for (const auto& [firstName, lastName] : names)
+                {
+                    addEmployee(firstName, lastName);
+                }
+                return firstNumber;
+            }
+            // Adds a copy of a complete record, keeping its employee number,
+            // salary and status (importers use this). Throws logic_error if
+            // the number is already taken.
+            Employee& insertEmployee(const Employee& employee);
+            // Sizes storage and indexes for count employees in the hot tier.
+            void reserve(std::size_t count);
+
+            // Brings an archived employee back to the hot tier.
             Employee& getEmployee(int employeeNumber);
-            Employee& getEmployee(const std::string& firstName,  
-                                  const std::string& lastName);
+            // Never changes the database: throws logic_error for an archived
+            // employee as for a missing one. Use findEmployee to read either.
+            const Employee& getEmployee(int employeeNumber) const;
+            // Copies the employee, from either tier, into result without
+            // moving any record. Returns false if there is none.
+            bool findEmployee(int employeeNumber, Employee& result) const;
+            bool contains(int employeeNumber) const;
+            bool isArchived(int employeeNumber) const;
+            // Returns the earliest-added employee with this name in the hot
+            // tier, or else brings back the lowest-numbered archived one.
+            Employee& getEmployee(std::string_view firstName,
+                                  std::string_view lastName);
+            // Numbers of every employee with this name: the hot tier's in the
+            // order added, then the archived ones in number order.
+            std::vector<int> findEmployees(std::string_view firstName,
+                                           std::string_view lastName) const;
+
+            // Applies a batch of raises, all or nothing. Deltas for the same
+            // employee add up. Numbers are resolved and new salaries checked
+            // on threads worker threads (0 means one per hardware thread)
+            // before any salary is touched; if a number is unknown
+            // (logic_error) or a salary would leave the range of int
+            // (overflow_error), nothing changes. The changes themselves are
+            // made in slot order through setSalary, so indexes, columns and
+            // the attached log see them as usual. Archived employees are
+            // brought back to the hot tier to be changed.
+            void adjustSalaries(const std::vector<SalaryAdjustment>& adjustments,
+                                unsigned threads = 1);
+            // Raises the salary of every employee for whom predicate returns
+            // true by percent (negative for a cut), rounded to the nearest
+            // dollar, and returns how many were selected. All or nothing as
+            // above. With more than one thread, predicate is called
+            // concurrently.
+            std::size_t adjustSalaries(const std::function<bool(const Employee&)>& predicate,
+                                       double percent, unsigned threads = 1);
+
+            // Salary statistics over the employees filter selects, computed
+            // by PayrollScan. The Columnar layout scans its salary column in
+            // place; Rows first gathers salaries into a temporary one.
+            PayrollSummary getPayroll(StatusFilter filter = StatusFilter::Current) const;
+            std::size_t countSalariesAbove(int threshold,
+                                           StatusFilter filter = StatusFilter::Current) const;
+            // See PayrollScan::histogram.
+            std::vector<std::size_t> getSalaryHistogram(int lowest, int bucketWidth,
+                                                        std::size_t bucketCount,
+                                                        StatusFilter filter = StatusFilter::Current) const;
+
+            // Headcount, payroll and salary-bucket counts by status over both
+            // tiers, kept up to date on every hire, firing and salary change.
+            const RosterCounters& getCounters() const;
+            // Changes the buckets getCounters() counts salaries into (see
+            // RosterCounters), recounting every employee once.
+            void setSalaryBuckets(int lowest, int bucketWidth, std::size_t bucketCount);
+
+            // Keeps ordered indexes of salaries from now on (see
+            // SalaryIndex), one per tier, which the two queries below then
+            // merge instead of looking at every record. A salary change
+            // usually costs a binary search plus a shift within one block of
+            // at most 128 entries. Splitting a full block or dropping an
+            // empty one shifts the array of blocks, O(size/128), so O(log
+            // size) holds only amortized over the inserts between splits.
+            // Each employee takes 8 bytes, up to 16 while their block's
+            // spare capacity is unused.
+            void indexSalaries();
+            bool hasSalaryIndex() const;
+            // Numbers of the employees filter selects whose salary lies in
+            // [minSalary, maxSalary], lowest salary first. Equal salaries come
+            // hot tier first, in the order added, then archived employees in
+            // number order.
+            std::vector<int> findEmployeesBySalary(int minSalary, int maxSalary,
+                                                   StatusFilter filter = StatusFilter::All) const;
+            // Numbers of the count best-paid employees filter selects,
+            // highest salary first. Equal salaries come as in
+            // findEmployeesBySalary.
+            std::vector<int> getTopEarners(std::size_t count,
+                                           StatusFilter filter = StatusFilter::All) const;
 
             void displayAll() const;
             void displayCurrent() const;
             void displayFormer() const;
 
-        
+            static constexpr std::size_t kCompactionStep = 1024;
+
+            // Compaction walks the hot tier from the first slot, archiving
+            // each former employee and moving current ones down over the
+            // freed slots, so the hot tier keeps its order. One step handles
+            // about maxRecords records (rounded up to a multiple of 64) and
+            // returns true if it finished the pass, at which point the hot
+            // tier holds only current employees and their old slots are
+            // released. The next step starts a new pass.
+            //
+            // Steps invalidate references to the records they move or
+            // archive; look employees up again by number afterwards. The
+            // database stays fully usable between steps.
+            bool compactStep(std::size_t maxRecords = kCompactionStep);
+            // Runs steps until a pass finishes.
+            void compact();
+            std::size_t archivedCount() const;
+            // Encoded size of the archived records.
+            std::size_t archivedBytes() const;
+            // Calls fn(const Employee&) with a copy of every archived record.
+            template <typename Fn>
+            void forEachArchived(Fn&& fn) const
+            {
+                mArchive.forEach(fn);
+            }
+
+            // Writes every record to a snapshot file (see Snapshot.h).
+            void saveSnapshot(const std::string& path) const;
+            // Fills an empty database from a snapshot file. Employee numbers
+            // are preserved. Throws logic_error if the database is not empty
+            // and runtime_error if the file is unusable.
+            //
+            // Loading only maps the file (see Snapshot), whatever its size.
+            // Until the tiers are needed, size, contains, isArchived,
+            // findEmployee and the display calls read the records in place.
+            // Any other call, const or not, first copies every record into
+            // the hot tier and indexes it, several hundred nanoseconds per
+            // employee (see SnapshotBenchmark); concurrent const callers
+            // wait for one copy. The copy checks every record before adding
+            // any and throws runtime_error, adding nothing, if one names a
+            // missing name or the numbers are not strictly increasing. Until
+            // then the mapped reads trust the order: a missing name is
+            // reported by the first call to read it, but out-of-order or
+            // repeated numbers make lookups miss or pick either record.
+            void loadSnapshot(const std::string& path);
+
+            // Appends every later mutation to log, including those made
+            // through returned Employee references; nullptr stops logging.
+            // The log must outlive the attachment. A mutation is applied in
+            // memory before it is logged, so if the append throws, memory
+            // is left ahead of the log.
+            void attachLog(WriteAheadLog* log);
+            // Fills an empty database from the snapshot at snapshotPath, if
+            // there is one, then replays the entries of the log at logPath
+            // that the snapshot does not include.
+            void recover(const std::string& snapshotPath, const std::string& logPath);
+            // Commits the attached log, saves a snapshot and truncates the
+            // log, so recovery no longer has those entries to replay.
+            void checkpoint(const std::string& snapshotPath);
+            // Sequence number of the last logged or replayed mutation.
+            std::uint64_t getLogSequence() const;
+
+            // Employees in both tiers.
+            std::size_t size() const;
+            int getNextEmployeeNumber() const;
+            // Every record in the hot tier, in the order it was added.
+            EmployeeStore::const_iterator begin() const;
+            EmployeeStore::const_iterator end() const;
+
+            StorageLayout getLayout() const;
+            // Throws logic_error unless the layout is Columnar.
+            const EmployeeColumns& getColumns() const;
+
+
         private:
-            std::vector<Employee> mEmployees;
-            int mNextEmployeeNumber = kDefaultEmployeeNumber;
+            static constexpr std::size_t kNoSlot = static_cast<std::size_t>(-1);
+            // How far past its end the offset table may grow for one number.
+            static constexpr std::size_t kMaxTableGap = std::size_t{1} << 20;
+            // Primary-key entries with this bit set hold the archive block of
+            // an archived employee rather than a slot.
+            static constexpr std::size_t kArchivedBit = ~(kNoSlot >> 1);
+
+            static std::uint64_t nameKey(NameId firstName, NameId lastName);
+
+            // Employees in the hot tier, which is what reserve() sizes.
+            std::size_t hotSize() const
+            {
+                buildTiers();
+                return mEmployees.size();
+            }
+
+            // Whether reads still go to the snapshot loadSnapshot mapped.
+            bool readingSnapshot() const
+            {
+                return mReadingSnapshot.load(std::memory_order_acquire);
+            }
+            // Copies the mapped snapshot into the tiers if that has not
+            // happened yet. The roster stays the same, so const callers may.
+            void buildTiers() const
+            {
+                if (readingSnapshot())
+                {
+                    buildFromSnapshot();
+                }
+            }
+            // Also unmaps the snapshot, which const callers leave mapped for
+            // readers that checked readingSnapshot() before the copy.
+            void buildTiers()
+            {
+                if (mSnapshot)
+                {
+                    closeSnapshot();
+                }
+            }
+            void buildFromSnapshot() const;
+            void closeSnapshot();
+            void restoreSnapshot(const Snapshot& snapshot);
+            void reserveHot(std::size_t count);
+            // Reports the snapshot's records that filter selects.
+            void displaySnapshot(StatusFilter filter) const;
+
+            // Throws logic_error if newNumber belongs to another employee.
+            void employeeRenumbering(const Employee& employee, int newNumber) override;
+            void employeeChanging(const Employee& employee, EmployeeField field) override;
+            void employeeChanged(const Employee& employee, EmployeeField field) override;
+
+            // Adds a record that already has its number, salary and status.
+            Employee& restoreEmployee(const Employee& employee);
+            std::size_t slotOf(const Employee& employee) const;
+            // Slot holding employeeNumber, or kNoSlot.
+            std::size_t findSlot(int employeeNumber) const;
+            // Primary-key entry of employeeNumber: its slot, kArchivedBit | its
+            // archive block, or kNoSlot.
+            std::size_t findEntry(int employeeNumber) const;
+            Employee& rehydrate(int employeeNumber, std::size_t block);
+            // Moves the record just past the store's gap to its start.
+            void compactKeep();
+            // Archives the record just past the store's gap.
+            void compactArchive();
+            // Position of employeeNumber in mSlotByNumber, if it lies on the
+            // grid of numbers this database hands out.
+            bool numberOffset(int employeeNumber, std::size_t& offset) const;
+            int nextNumberAfter(int employeeNumber) const;
+            // Returns query(scan) for a PayrollScan over every hot record, and
+            // over the archive too unless filter is Current. When the records
+            // take several scans, each further result is folded into the
+            // first's with combine(first, next).
+            template <typename Query, typename Combine>
+            auto queryPayroll(StatusFilter filter, Query&& query, Combine&& combine) const;
+            // (salary, number) of every archived employee filter selects, in
+            // archive order.
+            std::vector<std::pair<int, int>> archivedBySalary(StatusFilter filter) const;
+            // Sets each (slot, salary) pair, in order.
+            void applySalaries(const std::vector<std::pair<std::size_t, int>>& salaries);
+            void logAddition(const Employee& employee);
+            void logMutation(LogOperation operation, int employeeNumber, int value,
+                             std::string_view text = std::string_view());
+            void applyLogEntry(const LogEntry& entry);
+            bool covers(std::size_t slot, StatusFilter filter) const;
+            void indexEmployee(std::size_t slot);
+            // Points employeeNumber's primary-key entry at entry.
+            void indexNumber(int employeeNumber, std::size_t entry);
+            // Clears employeeNumber's primary-key entry if it is entry.
+            void unindexNumber(int employeeNumber, std::size_t entry);
+            void indexName(std::size_t slot);
+            void unindexName(std::size_t slot);
+            void indexName(const Employee& employee, std::size_t entry);
+            void unindexName(const Employee& employee, std::size_t entry);
+            // An archived employee's entries in the name index (with
+            // kArchivedBit) and in mArchivedSalaries stand for their number,
+            // mapped to 32 bits so that entries sort in number order.
+            static std::size_t archivedKey(int employeeNumber);
+            static int archivedNumber(std::size_t key);
+            void indexArchived(const Employee& employee);
+            void unindexArchived(const Employee& employee);
+
+            StorageLayout mLayout;
+            EmployeeStore mEmployees;
+            EmployeeColumns mColumns;
+            // Primary-key index: entry (see findEntry) of each employee number,
+            // stored at offset (employeeNumber - mFirstEmployeeNumber) / mNumberStride.
+            std::vector<std::size_t> mSlotByNumber;
+            // Entries of numbers the table does not cover: off its grid (set
+            // through setEmployeeNumber or imported) or too far past its end.
+            std::unordered_map<int, std::size_t> mSlotByOtherNumber;
+            // Secondary index: slots keyed by the (last, first) pair of
+            // NameIds, and kArchivedBit | archivedKey(number) for archived
+            // employees. Lookups resolve the caller's views to ids in the
+            // NamePool, so no key strings are stored or built.
+            std::unordered_multimap<std::uint64_t, std::size_t> mSlotsByName;
+            EmployeeArchive mArchive;
+            RosterCounters mCounters;
+            bool mIndexSalaries = false;
+            SalaryIndex mSalaryIndex;
+            // Archived salaries, keyed by archivedKey(number) instead of a
+            // slot, kept alongside mSalaryIndex.
+            SalaryIndex mArchivedSalaries;
+            int mFirstEmployeeNumber;
+            int mNumberStride;
+            int mNextEmployeeNumber;
+            WriteAheadLog* mLog = nullptr;
+            std::uint64_t mLogSequence = 0;
+            // Number of the employee being renumbered, between the
+            // employeeChanging and employeeChanged calls.
+            int mNumberBeforeChange = 0;
+            // Set by loadSnapshot until the first non-const call after the
+            // tiers are built; mReadingSnapshot is cleared once they are.
+            std::unique_ptr<Snapshot> mSnapshot;
+            std::atomic<bool> mReadingSnapshot{ false };
+            mutable std::mutex mSnapshotMutex;
 
     };
 
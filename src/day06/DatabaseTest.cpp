@@ -1,5 +1,7 @@
 #include <iostream>
+#include <stdexcept>
 #include "Database.h"
+#include "TestHelpers.h"
 using namespace std;
 using namespace Records;
 int main()
@@ -18,4 +20,31 @@ int main()
  myDB.displayCurrent();
  cout << endl << "former employees: " << endl << endl;
  myDB.displayFormer();
+ cout << endl << "lookup by name: " << endl << endl;
+ myDB.getEmployee("Marc", "White").display();
+
+ CHECK(myDB.size() == 3);
+ CHECK(myDB.getEmployee("Marc", "White").getSalary() == 100000);
+ CHECK(myDB.getEmployee(emp3.getEmployeeNumber()).getSalary() == 11000);
+ CHECK(!myDB.getEmployee(kDefaultEmployeeNumber).isHired());
+ CHECK(myDB.findEmployees("John", "Doe").size() == 1);
+ CHECK_THROWS(myDB.getEmployee("Nobody", "Here"), logic_error);
+
+ cout << endl << "renumbering: " << endl << endl;
+ // A number held by another employee, hot or archived, is refused.
+ const int doe = kDefaultEmployeeNumber + 2;
+ CHECK_THROWS(emp3.setEmployeeNumber(emp2.getEmployeeNumber()), logic_error);
+ // Compaction moves records, so look them up again afterwards.
+ CHECK(myDB.compactStep(10));
+ CHECK(myDB.isArchived(kDefaultEmployeeNumber));
+ CHECK_THROWS(myDB.getEmployee(doe).setEmployeeNumber(kDefaultEmployeeNumber), logic_error);
+ CHECK(myDB.isArchived(kDefaultEmployeeNumber));
+ CHECK(myDB.getEmployee(kDefaultEmployeeNumber + 1).getLastName() == "White");
+ CHECK(myDB.getEmployee(doe).getLastName() == "Doe");
+ // Later hires skip past a number given out by hand.
+ myDB.getEmployee(doe).setEmployeeNumber(doe + 1);
+ CHECK(myDB.addEmployee("Ann", "New").getEmployeeNumber() == doe + 2);
+ CHECK(myDB.getEmployee(doe + 1).getLastName() == "Doe");
+ CHECK(myDB.size() == 4);
+ return Testing::testResult();
 }
\ No newline at end of file
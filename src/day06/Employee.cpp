@@ -6,23 +6,56 @@
 
 
 
-# include <iostream>
 # include <string>
 
 # include "Employee.h"
+# include "ReportWriter.h"
 
 
 using namespace std;
 
 namespace Records
 {
-    Records::Employee::Employee(const std::string& firstName, 
-                                 const std::string& lastName)
-        : mFirstName(firstName), mLastName(lastName)
+    Records::Employee::Employee(std::string_view firstName, 
+                                 std::string_view lastName)
+        : mFirstName(NamePool::global().intern(firstName))
+        , mLastName(NamePool::global().intern(lastName))
     {
         // Constructor body (optional)
     }   
 
+    Employee::Employee(NameId firstName, NameId lastName)
+        : mFirstName(firstName), mLastName(lastName)
+    {
+    }
+
+    Employee::Employee(const Employee& src)
+        : mFirstName(src.mFirstName), mLastName(src.mLastName)
+        , mEmployeeNumber(src.mEmployeeNumber), mSalary(src.mSalary)
+        , mIsHired(src.mIsHired)
+    {
+    }
+
+    Employee& Employee::operator=(const Employee& rhs)
+    {
+        if (this != &rhs)
+        {
+            setFirstName(rhs.getFirstName());
+            setLastName(rhs.getLastName());
+            setEmployeeNumber(rhs.mEmployeeNumber);
+            setSalary(rhs.mSalary);
+            if (rhs.mIsHired)
+            {
+                hire();
+            }
+            else
+            {
+                fire();
+            }
+        }
+        return *this;
+    }
+
     void Employee::promote(int raiseAmount)
     {
         setSalary(getSalary() + raiseAmount);
@@ -36,47 +69,76 @@ namespace Records
 
     void Employee::hire()
     {
+        notifyChanging(EmployeeField::HiredStatus);
         mIsHired = true;
+        notifyChanged(EmployeeField::HiredStatus);
     }
 
     void Employee::fire()
     {
+        notifyChanging(EmployeeField::HiredStatus);
         mIsHired = false;
+        notifyChanged(EmployeeField::HiredStatus);
     }
 
     void Employee::display() const
     {
-        cout << "Employee: " << getLastName() << ", " << getFirstName() << endl;
-        cout << "------------------------------" << endl;
-        cout << (isHired() ? "Current Employee" : "Former Employee") << endl;
-        cout << "Employee Number: " << getEmployeeNumber() << endl;
-        cout << "Salary: $" << getSalary() << endl;
-        cout << endl;
+        // A one-record batch needs only the writer's small spare buffer,
+        // not the default batch.
+        ReportWriter writer(stdout, 0);
+        writer.write(*this);
+    }
+
+    void Employee::display(ReportWriter& writer) const
+    {
+        writer.write(*this);
     }
 
     // Getters and setters
-    void Employee::setFirstName(const string& firstName)
+    void Employee::setFirstName(string_view firstName)
     {
-        mFirstName = firstName;
+        NameId id = NamePool::global().intern(firstName);
+        notifyChanging(EmployeeField::FirstName);
+        mFirstName = id;
+        notifyChanged(EmployeeField::FirstName);
     }
-    const string& Employee::getFirstName() const
+    string_view Employee::getFirstName() const
+    {
+        return NamePool::global().view(mFirstName);
+    }
+
+    NameId Employee::getFirstNameId() const
     {
         return mFirstName;
     }
 
-    void Employee::setLastName(const string& lastName)
+    void Employee::setLastName(string_view lastName)
     {
-        mLastName = lastName;
+        NameId id = NamePool::global().intern(lastName);
+        notifyChanging(EmployeeField::LastName);
+        mLastName = id;
+        notifyChanged(EmployeeField::LastName);
     }
 
-    const string& Employee::getLastName() const
+    string_view Employee::getLastName() const
+    {
+        return NamePool::global().view(mLastName);
+    }
+
+    NameId Employee::getLastNameId() const
     {
         return mLastName;
     }
 
     void Employee::setEmployeeNumber(int employeeNumber)
     {
+        if (mListener != nullptr)
+        {
+            mListener->employeeRenumbering(*this, employeeNumber);
+        }
+        notifyChanging(EmployeeField::EmployeeNumber);
         mEmployeeNumber = employeeNumber;
+        notifyChanged(EmployeeField::EmployeeNumber);
     }
 
     int Employee::getEmployeeNumber() const
@@ -86,7 +148,9 @@ namespace Records
 
     void Employee::setSalary(int newSalary)
     {
+        notifyChanging(EmployeeField::Salary);
         mSalary = newSalary;
+        notifyChanged(EmployeeField::Salary);
     }
 
     int Employee::getSalary() const
@@ -99,4 +163,25 @@ namespace Records
         return mIsHired;
     }
 
+    void Employee::setListener(EmployeeListener* listener)
+    {
+        mListener = listener;
+    }
+
+    void Employee::notifyChanging(EmployeeField field) const
+    {
+        if (mListener != nullptr)
+        {
+            mListener->employeeChanging(*this, field);
+        }
+    }
+
+    void Employee::notifyChanged(EmployeeField field) const
+    {
+        if (mListener != nullptr)
+        {
+            mListener->employeeChanged(*this, field);
+        }
+    }
+
 }
\ No newline at end of file
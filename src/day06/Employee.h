@@ -1,27 +1,72 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+
+#include "NamePool.h"
 
 namespace Records
 {
     const int kDefaultStartingSlalary = 30000;
+
+    class Employee;
+    class ReportWriter;
+
+    // Fields an owning container may index.
+    enum class EmployeeField
+    {
+        FirstName,
+        LastName,
+        EmployeeNumber,
+        Salary,
+        HiredStatus
+    };
+
+    // Implemented by containers (such as Database) that keep indexes over
+    // their employees. A bound Employee calls employeeChanging() before and
+    // employeeChanged() after it modifies a field. A renumbering is first
+    // offered to employeeRenumbering(), which may throw to refuse it and
+    // leave the employee unchanged.
+    class EmployeeListener
+    {
+        public:
+            virtual ~EmployeeListener() = default;
+            virtual void employeeRenumbering(const Employee& employee, int newNumber) = 0;
+            virtual void employeeChanging(const Employee& employee, EmployeeField field) = 0;
+            virtual void employeeChanged(const Employee& employee, EmployeeField field) = 0;
+    };
+
     class Employee
     {
         public:
             Employee() = default;
-            Employee(const std::string& firstName, 
-                     const std::string& lastName);
+            Employee(std::string_view firstName, 
+                     std::string_view lastName);
+            // Names already interned in NamePool::global().
+            Employee(NameId firstName, NameId lastName);
+            // A copy is not bound to the original's listener.
+            Employee(const Employee& src);
+            // Assigns field by field, so a bound Employee reports each change.
+            Employee& operator=(const Employee& rhs);
 
             void promote(int raiseAmount = 1000);
             void demote(int dementAmount = 1000);
             void hire();
             void fire();
+            // Prints the employee to stdout straight away.
             void display() const;
+            // Adds the same block to writer's batch, for callers printing
+            // many employees.
+            void display(ReportWriter& writer) const;
 
-            void setFirstName(const std::string& firstName);
-            const std::string& getFirstName() const;
-            void setLastName(const std::string& lastName);
-            const std::string& getLastName() const;
+            // Names live in NamePool::global(); the returned views stay
+            // valid for the life of the process.
+            void setFirstName(std::string_view firstName);
+            std::string_view getFirstName() const;
+            NameId getFirstNameId() const;
+            void setLastName(std::string_view lastName);
+            std::string_view getLastName() const;
+            NameId getLastNameId() const;
 
             void setEmployeeNumber(int employeeNumber);
             int getEmployeeNumber() const;
@@ -31,12 +76,18 @@ namespace Records
 
             bool isHired() const;
 
+            void setListener(EmployeeListener* listener);
+
         private:
-            std::string mFirstName;
-            std::string mLastName;
+            void notifyChanging(EmployeeField field) const;
+            void notifyChanged(EmployeeField field) const;
+
+            NameId mFirstName = NamePool::kEmptyName;
+            NameId mLastName = NamePool::kEmptyName;
             int mEmployeeNumber = -1;
             int mSalary = kDefaultStartingSlalary;
             bool mIsHired = false;
+            EmployeeListener* mListener = nullptr;
 
     };
 }
\ No newline at end of file
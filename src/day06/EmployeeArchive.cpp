@@ -0,0 +1,163 @@
+#include "EmployeeArchive.h"
+
+using namespace std;
+
+namespace Records
+{
+    namespace
+    {
+        // Seven bits per byte, low bits first; the top bit marks that more
+        // bytes follow.
+        void writeVarint(uint64_t value, string& out)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        const char* readVarint(const char* in, uint64_t& value)
+        {
+            value = 0;
+            for (int shift = 0; ; shift += 7)
+            {
+                uint8_t byte = static_cast<uint8_t>(*in++);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (byte < 0x80)
+                {
+                    return in;
+                }
+            }
+        }
+
+        // Maps small negative and positive numbers alike to small codes.
+        uint64_t zigzag(int64_t value)
+        {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+
+        int64_t unzigzag(uint64_t code)
+        {
+            return static_cast<int64_t>(code >> 1) ^ -static_cast<int64_t>(code & 1);
+        }
+    }
+
+    size_t EmployeeArchive::add(const Employee& employee)
+    {
+        if (mBlocks.empty() || mOpenCount == kBlockSize)
+        {
+            mBlocks.emplace_back();
+            mOpenCount = 0;
+            mLastNumber = 0;
+        }
+        string& block = mBlocks.back();
+        size_t before = block.size();
+        Record record;
+        record.employeeNumber = employee.getEmployeeNumber();
+        record.firstName = employee.getFirstNameId();
+        record.lastName = employee.getLastNameId();
+        record.salary = employee.getSalary();
+        encode(record, mLastNumber, block);
+        mLastNumber = record.employeeNumber;
+        ++mOpenCount;
+        ++mSize;
+        mBytes += block.size() - before;
+        return mBlocks.size() - 1;
+    }
+
+    bool EmployeeArchive::find(size_t block, int employeeNumber, Employee& result) const
+    {
+        const string& bytes = mBlocks[block];
+        const char* end = bytes.data() + bytes.size();
+        Record record;
+        for (const char* in = bytes.data(); in != end; )
+        {
+            in = decode(in, record);
+            if (record.employeeNumber == employeeNumber)
+            {
+                result = toEmployee(record);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool EmployeeArchive::remove(size_t block, int employeeNumber)
+    {
+        // Re-encode the block without the record; the numbers after it are
+        // stored relative to their predecessor, which has changed.
+        const string& bytes = mBlocks[block];
+        const char* end = bytes.data() + bytes.size();
+        string rewritten;
+        rewritten.reserve(bytes.size());
+        Record record;
+        int previousNumber = 0;
+        bool found = false;
+        for (const char* in = bytes.data(); in != end; )
+        {
+            in = decode(in, record);
+            if (!found && record.employeeNumber == employeeNumber)
+            {
+                found = true;
+                continue;
+            }
+            encode(record, previousNumber, rewritten);
+            previousNumber = record.employeeNumber;
+        }
+        if (!found)
+        {
+            return false;
+        }
+
+        mBytes -= bytes.size() - rewritten.size();
+        --mSize;
+        if (block == mBlocks.size() - 1)
+        {
+            --mOpenCount;
+            mLastNumber = previousNumber;
+        }
+        if (rewritten.empty())
+        {
+            // Let go of the storage; the block keeps its place so the block
+            // numbers handed out for others stay valid.
+            string().swap(mBlocks[block]);
+        }
+        else
+        {
+            mBlocks[block] = move(rewritten);
+        }
+        return true;
+    }
+
+    const char* EmployeeArchive::decode(const char* in, Record& record)
+    {
+        uint64_t value;
+        in = readVarint(in, value);
+        record.employeeNumber = static_cast<int>(record.employeeNumber + unzigzag(value));
+        in = readVarint(in, value);
+        record.firstName = static_cast<NameId>(value);
+        in = readVarint(in, value);
+        record.lastName = static_cast<NameId>(value);
+        in = readVarint(in, value);
+        record.salary = static_cast<int>(unzigzag(value));
+        return in;
+    }
+
+    void EmployeeArchive::encode(const Record& record, int previousNumber, string& out)
+    {
+        writeVarint(zigzag(static_cast<int64_t>(record.employeeNumber) - previousNumber), out);
+        writeVarint(record.firstName, out);
+        writeVarint(record.lastName, out);
+        writeVarint(zigzag(record.salary), out);
+    }
+
+    Employee EmployeeArchive::toEmployee(const Record& record)
+    {
+        Employee employee(record.firstName, record.lastName);
+        employee.setEmployeeNumber(record.employeeNumber);
+        employee.setSalary(record.salary);
+        return employee;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Employee.h"
+
+namespace Records
+{
+    // Cold storage for former employees. Records are packed into blocks of
+    // up to kBlockSize, every field a variable-length integer: the employee
+    // number as the difference from the previous record's, names as their
+    // NamePool ids. A typical record takes six to eight bytes instead of a
+    // full Employee; Database still keeps its name and salary index entries.
+    //
+    // A record is read by decoding its block, so the caller must remember
+    // which block holds which number (Database keeps that in its primary-key
+    // index). Blocks are never edited in place: removing a record rewrites
+    // its block without it, and a block left empty frees its memory.
+    class EmployeeArchive
+    {
+        public:
+            static constexpr std::size_t kBlockSize = 64;
+
+            // Appends a record to the newest block, starting a new one when
+            // that is full, and returns the block it went to.
+            std::size_t add(const Employee& employee);
+            // Copies the record with this number out of block into result.
+            // Returns false if the block does not hold it.
+            bool find(std::size_t block, int employeeNumber, Employee& result) const;
+            // Returns false if the block does not hold the record.
+            bool remove(std::size_t block, int employeeNumber);
+
+            std::size_t size() const { return mSize; }
+            // Encoded size of every record.
+            std::size_t byteSize() const { return mBytes; }
+
+            // Calls fn(const Employee&) with a copy of every record, block by
+            // block. Archived employees are never hired.
+            template <typename Fn>
+            void forEach(Fn&& fn) const
+            {
+                for (const std::string& block : mBlocks)
+                {
+                    Record record;
+                    const char* end = block.data() + block.size();
+                    for (const char* in = block.data(); in != end; )
+                    {
+                        in = decode(in, record);
+                        fn(toEmployee(record));
+                    }
+                }
+            }
+
+        private:
+            struct Record
+            {
+                int employeeNumber = 0;
+                NameId firstName = NamePool::kEmptyName;
+                NameId lastName = NamePool::kEmptyName;
+                int salary = 0;
+            };
+
+            // Reads the record at in, whose number is relative to the one
+            // already in record, and returns where the next one starts.
+            static const char* decode(const char* in, Record& record);
+            static void encode(const Record& record, int previousNumber, std::string& out);
+            static Employee toEmployee(const Record& record);
+
+            std::vector<std::string> mBlocks;
+            // Records in the newest block, and the number of its last one.
+            std::size_t mOpenCount = 0;
+            int mLastNumber = 0;
+            std::size_t mSize = 0;
+            std::size_t mBytes = 0;
+    };
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "EmployeeClient.h"
+
+using namespace std;
+
+namespace Records
+{
+    namespace
+    {
+        const size_t kReadChunk = 64 * 1024;
+
+        runtime_error clientError(const string& path, const string& what)
+        {
+            return runtime_error("Employee client " + path + ": " + what);
+        }
+    }
+
+    EmployeeClient::EmployeeClient(const string& path)
+        : mPath(path)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path))
+        {
+            throw clientError(path, "socket path is empty or too long");
+        }
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        mFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (mFd < 0)
+        {
+            throw clientError(path, strerror(errno));
+        }
+        if (::connect(mFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            string what = strerror(errno);
+            ::close(mFd);
+            throw clientError(path, what);
+        }
+    }
+
+    EmployeeClient::~EmployeeClient()
+    {
+        ::close(mFd);
+    }
+
+    uint32_t EmployeeClient::send(Request request)
+    {
+        request.id = mNextId++;
+        encodeRequest(request, mOutput);
+        return request.id;
+    }
+
+    void EmployeeClient::flush()
+    {
+        size_t sent = 0;
+        while (sent < mOutput.size())
+        {
+            // The server stops reading once its answers back up, so take
+            // them in while sending or both sides wait for ever.
+            pollfd ready{};
+            ready.fd = mFd;
+            ready.events = POLLIN | POLLOUT;
+            if (::poll(&ready, 1, -1) < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw clientError(mPath, strerror(errno));
+            }
+            if (ready.revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                readInput(MSG_DONTWAIT);
+            }
+            if (ready.revents & POLLOUT)
+            {
+                ssize_t written = ::send(mFd, mOutput.data() + sent, mOutput.size() - sent,
+                                         MSG_NOSIGNAL | MSG_DONTWAIT);
+                if (written < 0)
+                {
+                    if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+                    {
+                        continue;
+                    }
+                    throw clientError(mPath, strerror(errno));
+                }
+                sent += static_cast<size_t>(written);
+            }
+        }
+        mOutput.clear();
+    }
+
+    Response EmployeeClient::receive()
+    {
+        flush();
+        Response response;
+        for (;;)
+        {
+            if (size_t taken = decodeResponse(mInput.data() + mConsumed, mInput.size() - mConsumed, response))
+            {
+                mConsumed += taken;
+                return response;
+            }
+            readInput(0);
+        }
+    }
+
+    void EmployeeClient::readInput(int flags)
+    {
+        // Keep only the undecoded answers before reading more.
+        mInput.erase(mInput.begin(), mInput.begin() + static_cast<ptrdiff_t>(mConsumed));
+        mConsumed = 0;
+        size_t old = mInput.size();
+        mInput.resize(old + kReadChunk);
+        ssize_t got = ::recv(mFd, mInput.data() + old, kReadChunk, flags);
+        mInput.resize(old + static_cast<size_t>(max<ssize_t>(got, 0)));
+        if (got == 0)
+        {
+            throw clientError(mPath, "connection closed by server");
+        }
+        if (got < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            throw clientError(mPath, strerror(errno));
+        }
+    }
+
+    Response EmployeeClient::call(Request request)
+    {
+        send(move(request));
+        return receive();
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "EmployeeProtocol.h"
+
+namespace Records
+{
+    // Blocking client for EmployeeServer. Requests are queued by send() and
+    // go out together on the next flush() or receive(), so any number can be
+    // in flight at once; answers come back in the order sent. flush() reads
+    // answers that arrive while it sends and keeps them for receive().
+    //
+    // Throws runtime_error if the connection fails or the server closes it.
+    class EmployeeClient
+    {
+        public:
+            explicit EmployeeClient(const std::string& path);
+            ~EmployeeClient();
+            EmployeeClient(const EmployeeClient&) = delete;
+            EmployeeClient& operator=(const EmployeeClient&) = delete;
+
+            // Numbers the request, queues it and returns its id.
+            std::uint32_t send(Request request);
+            void flush();
+            // Flushes, then waits for the next answer.
+            Response receive();
+            // One request and its answer.
+            Response call(Request request);
+
+        private:
+            // Appends what one recv() returns to mInput. Throws if the
+            // server has closed the connection.
+            void readInput(int flags);
+
+            int mFd = -1;
+            std::string mPath;
+            std::uint32_t mNextId = 1;
+            std::vector<char> mOutput;
+            std::vector<char> mInput;
+            // Bytes of input already decoded.
+            std::size_t mConsumed = 0;
+    };
+}
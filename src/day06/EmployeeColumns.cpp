@@ -0,0 +1,133 @@
+#include "EmployeeColumns.h"
+
+using namespace std;
+
+namespace Records
+{
+    void EmployeeColumns::append(const Employee& employee)
+    {
+        size_t slot = size();
+        mNumbers.push_back(employee.getEmployeeNumber());
+        mSalaries.push_back(employee.getSalary());
+        mFirstNames.push_back(employee.getFirstNameId());
+        mLastNames.push_back(employee.getLastNameId());
+        if ((slot >> 6) >= mHiredBits.size())
+        {
+            mHiredBits.push_back(0);
+        }
+        setHired(slot, employee.isHired());
+    }
+
+    void EmployeeColumns::update(size_t slot, const Employee& employee, EmployeeField field)
+    {
+        switch (field)
+        {
+            case EmployeeField::FirstName:
+                mFirstNames[slot] = employee.getFirstNameId();
+                break;
+            case EmployeeField::LastName:
+                mLastNames[slot] = employee.getLastNameId();
+                break;
+            case EmployeeField::EmployeeNumber:
+                mNumbers[slot] = employee.getEmployeeNumber();
+                break;
+            case EmployeeField::Salary:
+                mSalaries[slot] = employee.getSalary();
+                break;
+            case EmployeeField::HiredStatus:
+                setHired(slot, employee.isHired());
+                break;
+        }
+    }
+
+    void EmployeeColumns::move(size_t from, size_t to)
+    {
+        mNumbers[to] = mNumbers[from];
+        mSalaries[to] = mSalaries[from];
+        mFirstNames[to] = mFirstNames[from];
+        mLastNames[to] = mLastNames[from];
+        setHired(to, isHired(from));
+        setHired(from, false);
+    }
+
+    void EmployeeColumns::truncate(size_t count)
+    {
+        mNumbers.resize(count);
+        mSalaries.resize(count);
+        mFirstNames.resize(count);
+        mLastNames.resize(count);
+        mHiredBits.resize((count + 63) / 64);
+        if ((count & 63) != 0)
+        {
+            // Keep the bits past the last record clear for countHired.
+            mHiredBits.back() &= (uint64_t{1} << (count & 63)) - 1;
+        }
+        mGapBegin = mGapEnd = 0;
+    }
+
+    void EmployeeColumns::setGap(size_t begin, size_t end)
+    {
+        mGapBegin = begin;
+        mGapEnd = end;
+    }
+
+    void EmployeeColumns::reserve(size_t count)
+    {
+        mNumbers.reserve(count);
+        mSalaries.reserve(count);
+        mFirstNames.reserve(count);
+        mLastNames.reserve(count);
+        mHiredBits.reserve((count + 63) / 64);
+    }
+
+    size_t EmployeeColumns::countHired(bool hired) const
+    {
+        size_t count = 0;
+        for (uint64_t word : mHiredBits)
+        {
+            count += static_cast<size_t>(__builtin_popcountll(word));
+        }
+        // Gap slots have their flags clear, so only the former count holds them.
+        return hired ? count : size() - count - (mGapEnd - mGapBegin);
+    }
+
+    long long EmployeeColumns::totalSalary(bool hired) const
+    {
+        // Branch-free: every salary is read, masked by its status bit.
+        long long total = 0;
+        size_t count = size();
+        for (size_t word = 0; word < mHiredBits.size(); ++word)
+        {
+            uint64_t bits = hired ? mHiredBits[word] : ~mHiredBits[word];
+            size_t base = word << 6;
+            size_t end = count - base < 64 ? count - base : 64;
+            for (size_t bit = 0; bit < end; ++bit)
+            {
+                long long mask = -static_cast<long long>((bits >> bit) & 1);
+                total += mSalaries[base + bit] & mask;
+            }
+        }
+        if (!hired)
+        {
+            // The gap's stale salaries were counted as former employees'.
+            for (size_t slot = mGapBegin; slot < mGapEnd; ++slot)
+            {
+                total -= mSalaries[slot];
+            }
+        }
+        return total;
+    }
+
+    void EmployeeColumns::setHired(size_t slot, bool hired)
+    {
+        uint64_t bit = uint64_t{1} << (slot & 63);
+        if (hired)
+        {
+            mHiredBits[slot >> 6] |= bit;
+        }
+        else
+        {
+            mHiredBits[slot >> 6] &= ~bit;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Employee.h"
+
+namespace Records
+{
+    // Struct-of-arrays copy of a roster: one contiguous array per field and
+    // a bitmap for the hired flag, all indexed by the record's slot. Status
+    // filters read one bit per record and salary aggregates read only the
+    // salary array, instead of pulling whole Employee objects (and their
+    // strings) through the cache.
+    class EmployeeColumns
+    {
+        public:
+            void append(const Employee& employee);
+            // Refreshes one field of the record in this slot.
+            void update(std::size_t slot, const Employee& employee, EmployeeField field);
+            // Copies the record in slot from to slot to, and clears the hired
+            // flag left behind in from.
+            void move(std::size_t from, std::size_t to);
+            // Drops every record from slot count on, and clears the gap.
+            void truncate(std::size_t count);
+            // Marks slots [begin, end) as holding no record, as they do while
+            // Database is part-way through a compaction pass. Their hired
+            // flags must be clear; countHired, totalSalary and forEach skip
+            // them.
+            void setGap(std::size_t begin, std::size_t end);
+            void reserve(std::size_t count);
+
+            std::size_t size() const { return mNumbers.size(); }
+
+            const std::vector<int>& employeeNumbers() const { return mNumbers; }
+            const std::vector<int>& salaries() const { return mSalaries; }
+            // Names are NamePool::global() ids.
+            const std::vector<NameId>& firstNames() const { return mFirstNames; }
+            const std::vector<NameId>& lastNames() const { return mLastNames; }
+            // Bit (slot % 64) of word (slot / 64) is set while that employee is hired.
+            const std::vector<std::uint64_t>& hiredBits() const { return mHiredBits; }
+
+            bool isHired(std::size_t slot) const
+            {
+                return (mHiredBits[slot >> 6] >> (slot & 63)) & 1;
+            }
+
+            std::size_t countHired(bool hired) const;
+            long long totalSalary(bool hired) const;
+
+            // Calls fn(slot) for every record whose hired flag equals hired,
+            // in slot order, skipping 64 records at a time where none match.
+            template <typename Fn>
+            void forEach(bool hired, Fn&& fn) const
+            {
+                std::size_t count = size();
+                for (std::size_t word = 0; word < mHiredBits.size(); ++word)
+                {
+                    std::uint64_t bits = hired ? mHiredBits[word] : ~mHiredBits[word];
+                    while (bits != 0)
+                    {
+                        std::size_t slot = (word << 6) + static_cast<std::size_t>(__builtin_ctzll(bits));
+                        if (slot >= count)
+                        {
+                            return;
+                        }
+                        if (slot < mGapBegin || slot >= mGapEnd)
+                        {
+                            fn(slot);
+                        }
+                        bits &= bits - 1;
+                    }
+                }
+            }
+
+        private:
+            void setHired(std::size_t slot, bool hired);
+
+            std::vector<int> mNumbers;
+            std::vector<int> mSalaries;
+            std::vector<NameId> mFirstNames;
+            std::vector<NameId> mLastNames;
+            std::vector<std::uint64_t> mHiredBits;
+            std::size_t mGapBegin = 0;
+            std::size_t mGapEnd = 0;
+    };
+}
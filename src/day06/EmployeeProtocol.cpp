@@ -0,0 +1,139 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "EmployeeProtocol.h"
+
+using namespace std;
+
+namespace Records
+{
+    namespace
+    {
+        const size_t kLengthBytes = 4;
+        // id, opcode, employeeNumber, value
+        const size_t kRequestFixedBytes = 4 + 1 + 4 + 4;
+        // id, status, employeeNumber, value, hired, first name length
+        const size_t kResponseFixedBytes = 4 + 1 + 4 + 8 + 1 + 4;
+
+        template <typename T>
+        void put(vector<char>& out, T value)
+        {
+            const char* bytes = reinterpret_cast<const char*>(&value);
+            out.insert(out.end(), bytes, bytes + sizeof(T));
+        }
+
+        template <typename T>
+        T get(const char*& in)
+        {
+            T value;
+            memcpy(&value, in, sizeof(T));
+            in += sizeof(T);
+            return value;
+        }
+
+        // Length of the payload after the length field, or 0 if the frame
+        // is incomplete.
+        uint32_t payloadLength(const char* data, size_t bytes, size_t fixedBytes)
+        {
+            if (bytes < kLengthBytes)
+            {
+                return 0;
+            }
+            uint32_t length = get<uint32_t>(data);
+            if (length < fixedBytes || length > kMaxMessageBytes)
+            {
+                throw runtime_error("Malformed message: bad length " + to_string(length) + ".");
+            }
+            return bytes - kLengthBytes < length ? 0 : length;
+        }
+
+        void putFrame(vector<char>& out, size_t length)
+        {
+            if (length > kMaxMessageBytes)
+            {
+                throw length_error("Message is too large.");
+            }
+            put<uint32_t>(out, static_cast<uint32_t>(length));
+        }
+    }
+
+    string_view Response::firstName() const
+    {
+        return string_view(text).substr(0, firstNameLength);
+    }
+
+    string_view Response::lastName() const
+    {
+        return firstNameLength > text.size() ? string_view() : string_view(text).substr(firstNameLength);
+    }
+
+    Request addEmployeeRequest(string_view firstName, string_view lastName)
+    {
+        Request request;
+        request.opcode = Opcode::AddEmployee;
+        request.value = static_cast<int32_t>(firstName.size());
+        request.text.reserve(firstName.size() + lastName.size());
+        request.text.append(firstName).append(lastName);
+        return request;
+    }
+
+    void encodeRequest(const Request& request, vector<char>& out)
+    {
+        putFrame(out, kRequestFixedBytes + request.text.size());
+        put<uint32_t>(out, request.id);
+        put<uint8_t>(out, static_cast<uint8_t>(request.opcode));
+        put<int32_t>(out, request.employeeNumber);
+        put<int32_t>(out, request.value);
+        out.insert(out.end(), request.text.begin(), request.text.end());
+    }
+
+    void encodeResponse(const Response& response, vector<char>& out)
+    {
+        putFrame(out, kResponseFixedBytes + response.text.size());
+        put<uint32_t>(out, response.id);
+        put<uint8_t>(out, static_cast<uint8_t>(response.status));
+        put<int32_t>(out, response.employeeNumber);
+        put<int64_t>(out, response.value);
+        put<uint8_t>(out, response.hired ? 1 : 0);
+        put<uint32_t>(out, response.firstNameLength);
+        out.insert(out.end(), response.text.begin(), response.text.end());
+    }
+
+    size_t decodeRequest(const char* data, size_t bytes, Request& request)
+    {
+        uint32_t length = payloadLength(data, bytes, kRequestFixedBytes);
+        if (length == 0)
+        {
+            return 0;
+        }
+        const char* cursor = data + kLengthBytes;
+        request.id = get<uint32_t>(cursor);
+        request.opcode = static_cast<Opcode>(get<uint8_t>(cursor));
+        request.employeeNumber = get<int32_t>(cursor);
+        request.value = get<int32_t>(cursor);
+        request.text.assign(cursor, length - kRequestFixedBytes);
+        return kLengthBytes + length;
+    }
+
+    size_t decodeResponse(const char* data, size_t bytes, Response& response)
+    {
+        uint32_t length = payloadLength(data, bytes, kResponseFixedBytes);
+        if (length == 0)
+        {
+            return 0;
+        }
+        const char* cursor = data + kLengthBytes;
+        response.id = get<uint32_t>(cursor);
+        response.status = static_cast<ResponseStatus>(get<uint8_t>(cursor));
+        response.employeeNumber = get<int32_t>(cursor);
+        response.value = get<int64_t>(cursor);
+        response.hired = get<uint8_t>(cursor) != 0;
+        response.firstNameLength = get<uint32_t>(cursor);
+        response.text.assign(cursor, length - kResponseFixedBytes);
+        if (response.firstNameLength > response.text.size())
+        {
+            throw runtime_error("Malformed message: first name runs past the text.");
+        }
+        return kLengthBytes + length;
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Records
+{
+    // Messages between EmployeeServer and its clients, in native byte order
+    // since both ends share a machine. Each is framed as
+    //
+    //   uint32 payload length | payload
+    //
+    // A request's payload is
+    //
+    //   uint32 id | uint8 opcode | int32 employeeNumber | int32 value | text
+    //
+    // and a response's
+    //
+    //   uint32 id | uint8 status | int32 employeeNumber | int64 value |
+    //   uint8 hired | uint32 first name length | text
+    //
+    // The server answers every request on a connection in order, echoing its
+    // id, so clients may send many requests before reading any answer.
+    // Requests that change an employee answer with the employee's number,
+    // salary (in value) and status.
+    enum class Opcode : std::uint8_t
+    {
+        // text holds first name then last name; value is the first name's
+        // length. Answers with the new employee's number.
+        AddEmployee = 1,
+        // Answers with the employee: salary in value, names in text.
+        GetEmployee,
+        // value is the raise.
+        Promote,
+        // value is the demerit.
+        Demote,
+        Hire,
+        Fire,
+        // value is the new salary.
+        SetSalary,
+        // Answers with the number of employees, in both tiers, in value.
+        Size
+    };
+
+    enum class ResponseStatus : std::uint8_t
+    {
+        Ok = 0,
+        // No employee has the request's number.
+        NotFound,
+        // Unknown opcode or malformed fields.
+        Invalid,
+        // The database rejected the change; text holds the reason.
+        Failed
+    };
+
+    struct Request
+    {
+        std::uint32_t id = 0;
+        Opcode opcode = Opcode::Size;
+        std::int32_t employeeNumber = 0;
+        std::int32_t value = 0;
+        std::string text;
+    };
+
+    struct Response
+    {
+        std::uint32_t id = 0;
+        ResponseStatus status = ResponseStatus::Ok;
+        std::int32_t employeeNumber = 0;
+        std::int64_t value = 0;
+        bool hired = false;
+        std::uint32_t firstNameLength = 0;
+        std::string text;
+
+        std::string_view firstName() const;
+        std::string_view lastName() const;
+    };
+
+    // Largest payload either side accepts.
+    const std::uint32_t kMaxMessageBytes = 1 << 16;
+
+    Request addEmployeeRequest(std::string_view firstName, std::string_view lastName);
+
+    // Appends one framed message to out. Throws length_error if it would be
+    // larger than kMaxMessageBytes.
+    void encodeRequest(const Request& request, std::vector<char>& out);
+    void encodeResponse(const Response& response, std::vector<char>& out);
+    // Decodes the message at the start of the bytes bytes at data. Returns
+    // the bytes it takes, or 0 if it is not all there yet. Throws
+    // runtime_error if it is malformed.
+    std::size_t decodeRequest(const char* data, std::size_t bytes, Request& request);
+    std::size_t decodeResponse(const char* data, std::size_t bytes, Response& response);
+}
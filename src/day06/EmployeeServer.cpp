@@ -0,0 +1,416 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Database.h"
+#include "EmployeeServer.h"
+
+using namespace std;
+
+namespace Records
+{
+    namespace
+    {
+        const int kMaxEvents = 64;
+
+        runtime_error serverError(const string& path, const string& what)
+        {
+            return runtime_error("Employee server " + path + ": " + what);
+        }
+
+        // Removes path if it is a socket, and never anything else, so a
+        // mistyped path cannot delete a file.
+        void unlinkSocket(const string& path)
+        {
+            struct stat info;
+            if (::lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+            {
+                ::unlink(path.c_str());
+            }
+        }
+
+        Response describe(const Request& request, const Employee& employee)
+        {
+            Response response;
+            response.id = request.id;
+            response.employeeNumber = employee.getEmployeeNumber();
+            response.value = employee.getSalary();
+            response.hired = employee.isHired();
+            return response;
+        }
+    }
+
+    EmployeeServer::EmployeeServer(Database& db, const string& path)
+        : mDb(db)
+        , mPath(path)
+        , mReadBuffer(kReadChunk)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path))
+        {
+            throw serverError(path, "socket path is empty or too long");
+        }
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        struct stat info;
+        if (::lstat(path.c_str(), &info) == 0 && !S_ISSOCK(info.st_mode))
+        {
+            throw serverError(path, "path exists and is not a socket");
+        }
+
+        mListenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        mEpollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        mWakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (mListenFd < 0 || mEpollFd < 0 || mWakeFd < 0)
+        {
+            string what = strerror(errno);
+            release();
+            throw serverError(path, what);
+        }
+        // A socket file left by an earlier run would make bind fail.
+        unlinkSocket(path);
+        epoll_event listenEvent{};
+        listenEvent.events = EPOLLIN;
+        listenEvent.data.fd = mListenFd;
+        epoll_event wakeEvent{};
+        wakeEvent.events = EPOLLIN;
+        wakeEvent.data.fd = mWakeFd;
+        if (::bind(mListenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+            || ::listen(mListenFd, SOMAXCONN) != 0
+            || ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mListenFd, &listenEvent) != 0
+            || ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mWakeFd, &wakeEvent) != 0)
+        {
+            string what = strerror(errno);
+            release();
+            unlinkSocket(path);
+            throw serverError(path, what);
+        }
+    }
+
+    EmployeeServer::~EmployeeServer()
+    {
+        while (!mConnections.empty())
+        {
+            closeConnection(mConnections.begin()->first);
+        }
+        release();
+        unlinkSocket(mPath);
+    }
+
+    void EmployeeServer::run()
+    {
+        epoll_event events[kMaxEvents];
+        bool running = true;
+        while (running)
+        {
+            int count = ::epoll_wait(mEpollFd, events, kMaxEvents, -1);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw serverError(mPath, strerror(errno));
+            }
+            for (int i = 0; i < count; ++i)
+            {
+                int fd = events[i].data.fd;
+                if (fd == mWakeFd)
+                {
+                    running = false;
+                    continue;
+                }
+                if (fd == mListenFd)
+                {
+                    acceptClients();
+                    continue;
+                }
+                auto found = mConnections.find(fd);
+                if (found == mConnections.end())
+                {
+                    continue;
+                }
+                Connection& connection = found->second;
+                bool open = (events[i].events & EPOLLERR) == 0;
+                if (open && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP)) != 0)
+                {
+                    open = readRequests(connection);
+                }
+                if (open && connection.sent < connection.output.size())
+                {
+                    open = writeResponses(connection);
+                }
+                if (open)
+                {
+                    watch(connection);
+                }
+                else
+                {
+                    closeConnection(fd);
+                }
+            }
+        }
+        // Rearm for another call to run().
+        uint64_t wakeups;
+        ssize_t drained = ::read(mWakeFd, &wakeups, sizeof(wakeups));
+        (void) drained;
+    }
+
+    void EmployeeServer::stop()
+    {
+        uint64_t one = 1;
+        ssize_t written = ::write(mWakeFd, &one, sizeof(one));
+        (void) written;
+    }
+
+    Response EmployeeServer::handle(Database& db, const Request& request)
+    {
+        Response response;
+        response.id = request.id;
+        try
+        {
+            switch (request.opcode)
+            {
+                case Opcode::AddEmployee:
+                {
+                    if (request.value < 0 || static_cast<size_t>(request.value) > request.text.size())
+                    {
+                        response.status = ResponseStatus::Invalid;
+                        return response;
+                    }
+                    string_view text(request.text);
+                    size_t split = static_cast<size_t>(request.value);
+                    return describe(request, db.addEmployee(text.substr(0, split), text.substr(split)));
+                }
+                case Opcode::GetEmployee:
+                {
+                    // A copy leaves an archived employee where they are.
+                    Employee employee;
+                    if (!db.findEmployee(request.employeeNumber, employee))
+                    {
+                        response.status = ResponseStatus::NotFound;
+                        return response;
+                    }
+                    response = describe(request, employee);
+                    response.firstNameLength = static_cast<uint32_t>(employee.getFirstName().size());
+                    response.text.append(employee.getFirstName()).append(employee.getLastName());
+                    return response;
+                }
+                case Opcode::Promote:
+                case Opcode::Demote:
+                case Opcode::Hire:
+                case Opcode::Fire:
+                case Opcode::SetSalary:
+                    break;
+                case Opcode::Size:
+                    response.value = static_cast<int64_t>(db.size());
+                    return response;
+                default:
+                    response.status = ResponseStatus::Invalid;
+                    return response;
+            }
+
+            if (!db.contains(request.employeeNumber))
+            {
+                response.status = ResponseStatus::NotFound;
+                return response;
+            }
+            Employee& employee = db.getEmployee(request.employeeNumber);
+            switch (request.opcode)
+            {
+                case Opcode::Promote:
+                    employee.promote(request.value);
+                    break;
+                case Opcode::Demote:
+                    employee.demote(request.value);
+                    break;
+                case Opcode::Hire:
+                    employee.hire();
+                    break;
+                case Opcode::Fire:
+                    employee.fire();
+                    break;
+                default:
+                    employee.setSalary(request.value);
+                    break;
+            }
+            return describe(request, employee);
+        }
+        catch (const exception& error)
+        {
+            response = Response();
+            response.id = request.id;
+            response.status = ResponseStatus::Failed;
+            response.text = error.what();
+            return response;
+        }
+    }
+
+    void EmployeeServer::acceptClients()
+    {
+        for (;;)
+        {
+            int fd = ::accept4(mListenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                {
+                    continue;
+                }
+                // EAGAIN once the backlog is empty; anything else (such as
+                // running out of descriptors) leaves the rest queued.
+                return;
+            }
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP;
+            event.data.fd = fd;
+            if (::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+            {
+                ::close(fd);
+                continue;
+            }
+            Connection& connection = mConnections[fd];
+            connection.fd = fd;
+            connection.events = event.events;
+        }
+    }
+
+    bool EmployeeServer::readRequests(Connection& connection)
+    {
+        bool peerClosed = false;
+        size_t budget = kReadBudget;
+        while (budget > 0)
+        {
+            ssize_t got = ::read(connection.fd, mReadBuffer.data(), mReadBuffer.size());
+            if (got > 0)
+            {
+                connection.input.insert(connection.input.end(), mReadBuffer.data(), mReadBuffer.data() + got);
+                budget -= min(budget, static_cast<size_t>(got));
+                continue;
+            }
+            if (got == 0)
+            {
+                peerClosed = true;
+                break;
+            }
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            return false;
+        }
+
+        // Every complete request is answered now; a partial one waits for
+        // the rest of its bytes.
+        size_t consumed = 0;
+        Request request;
+        try
+        {
+            while (size_t taken = decodeRequest(connection.input.data() + consumed,
+                                                connection.input.size() - consumed, request))
+            {
+                consumed += taken;
+                encodeResponse(handle(mDb, request), connection.output);
+            }
+        }
+        catch (const runtime_error&)
+        {
+            // Past a malformed frame the stream cannot be resynchronised.
+            return false;
+        }
+        connection.input.erase(connection.input.begin(), connection.input.begin() + consumed);
+
+        if (peerClosed)
+        {
+            // The client may only have shut down its side; answer what it sent.
+            writeResponses(connection);
+            return false;
+        }
+        return true;
+    }
+
+    bool EmployeeServer::writeResponses(Connection& connection)
+    {
+        while (connection.sent < connection.output.size())
+        {
+            ssize_t written = ::send(connection.fd, connection.output.data() + connection.sent,
+                                     connection.output.size() - connection.sent, MSG_NOSIGNAL);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    break;
+                }
+                return false;
+            }
+            connection.sent += static_cast<size_t>(written);
+        }
+        if (connection.sent == connection.output.size())
+        {
+            connection.output.clear();
+            connection.sent = 0;
+        }
+        else if (connection.sent > connection.output.size() / 2)
+        {
+            connection.output.erase(connection.output.begin(),
+                                    connection.output.begin() + static_cast<ptrdiff_t>(connection.sent));
+            connection.sent = 0;
+        }
+        return true;
+    }
+
+    void EmployeeServer::watch(Connection& connection)
+    {
+        size_t unsent = connection.output.size() - connection.sent;
+        unsigned events = (unsent < kMaxPendingOutput ? unsigned{EPOLLIN | EPOLLRDHUP} : 0u)
+                        | (unsent > 0 ? unsigned{EPOLLOUT} : 0u);
+        if (events == connection.events)
+        {
+            return;
+        }
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = connection.fd;
+        if (::epoll_ctl(mEpollFd, EPOLL_CTL_MOD, connection.fd, &event) == 0)
+        {
+            connection.events = events;
+        }
+    }
+
+    void EmployeeServer::closeConnection(int fd)
+    {
+        ::epoll_ctl(mEpollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        mConnections.erase(fd);
+    }
+
+    void EmployeeServer::release()
+    {
+        for (int* fd : { &mListenFd, &mEpollFd, &mWakeFd })
+        {
+            if (*fd >= 0)
+            {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+}
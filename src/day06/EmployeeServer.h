@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "EmployeeProtocol.h"
+
+namespace Records
+{
+    class Database;
+
+    // Serves a Database to local clients over a Unix domain socket, in the
+    // protocol of EmployeeProtocol.h.
+    //
+    // One thread runs an epoll loop over every connection, so requests reach
+    // the Database one at a time and need no locking. Each time a connection
+    // is readable, the server reads all it can, answers every complete
+    // request in it, and sends the answers back with one write.
+    class EmployeeServer
+    {
+        public:
+            // Listens at path, replacing any socket file already there.
+            // Throws runtime_error if the socket cannot be set up or path
+            // exists and is not a socket, which is left alone.
+            EmployeeServer(Database& db, const std::string& path);
+            // Closes every connection and removes the socket file.
+            ~EmployeeServer();
+            EmployeeServer(const EmployeeServer&) = delete;
+            EmployeeServer& operator=(const EmployeeServer&) = delete;
+
+            // Serves until stop() is called. Throws runtime_error if epoll
+            // fails; a failing connection is only closed.
+            void run();
+            // Makes run() return after its current round of events. Safe to
+            // call from any thread and from a signal handler.
+            void stop();
+
+            // Answers one request against db. Database errors become
+            // response statuses rather than exceptions.
+            static Response handle(Database& db, const Request& request);
+
+        private:
+            // Bytes one connection may read per wakeup, so a busy client
+            // cannot starve the others.
+            static constexpr std::size_t kReadBudget = 256 * 1024;
+            // A connection whose unsent answers pass this is not read from
+            // until the client catches up.
+            static constexpr std::size_t kMaxPendingOutput = 1024 * 1024;
+            static constexpr std::size_t kReadChunk = 64 * 1024;
+
+            struct Connection
+            {
+                int fd = -1;
+                std::vector<char> input;
+                std::vector<char> output;
+                // Bytes of output already sent.
+                std::size_t sent = 0;
+                // Events epoll currently reports for the connection.
+                unsigned events = 0;
+            };
+
+            void acceptClients();
+            // Each returns false if the connection is finished with.
+            bool readRequests(Connection& connection);
+            bool writeResponses(Connection& connection);
+            // Asks epoll for reads unless output is backed up, and for
+            // writes while any is unsent.
+            void watch(Connection& connection);
+            void closeConnection(int fd);
+            // Closes the server's own descriptors.
+            void release();
+
+            Database& mDb;
+            std::string mPath;
+            int mListenFd = -1;
+            int mEpollFd = -1;
+            // Readable once stop() has been called.
+            int mWakeFd = -1;
+            std::unordered_map<int, Connection> mConnections;
+            std::vector<char> mReadBuffer;
+    };
+}
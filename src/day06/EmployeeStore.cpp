@@ -0,0 +1,155 @@
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+#include "EmployeeStore.h"
+
+using namespace std;
+
+namespace Records
+{
+    namespace
+    {
+        // Recycles raw employee blocks between stores, so a process that
+        // builds and drops databases (tests, benchmarks, reloads) reuses the
+        // same memory instead of going back to the system allocator.
+        class BlockPool
+        {
+            public:
+                static constexpr size_t kBlockBytes = EmployeeStore::kBlockSize * sizeof(Employee);
+                static constexpr size_t kMaxCachedBlocks = 64;
+                static_assert(alignof(Employee) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                              "blocks come from plain operator new");
+
+                Employee* allocate()
+                {
+                    {
+                        lock_guard<mutex> lock(mMutex);
+                        if (!mFree.empty())
+                        {
+                            void* block = mFree.back();
+                            mFree.pop_back();
+                            return static_cast<Employee*>(block);
+                        }
+                    }
+                    return static_cast<Employee*>(::operator new(kBlockBytes));
+                }
+
+                void release(Employee* block)
+                {
+                    {
+                        lock_guard<mutex> lock(mMutex);
+                        if (mFree.size() < kMaxCachedBlocks)
+                        {
+                            mFree.push_back(block);
+                            return;
+                        }
+                    }
+                    ::operator delete(block);
+                }
+
+            private:
+                mutex mMutex;
+                vector<void*> mFree;
+        };
+
+        BlockPool& blockPool()
+        {
+            // Never destroyed, so stores with static lifetime can still hand
+            // their blocks back during shutdown.
+            static BlockPool* pool = new BlockPool;
+            return *pool;
+        }
+    }
+
+    EmployeeStore::~EmployeeStore()
+    {
+        for (size_t slot = 0; slot < mSize; ++slot)
+        {
+            if (!isVacant(slot))
+            {
+                slotAt(slot).~Employee();
+            }
+        }
+        for (Employee* block : mBlocks)
+        {
+            blockPool().release(block);
+        }
+    }
+
+    void EmployeeStore::reserve(size_t count)
+    {
+        count += mGapEnd - mGapBegin;
+        mBlocks.reserve((count + kBlockSize - 1) >> kBlockShift);
+        while (mBlocks.size() * kBlockSize < count)
+        {
+            addBlock();
+        }
+    }
+
+    size_t EmployeeStore::indexOf(const Employee& employee) const
+    {
+        for (size_t block = 0; block < mBlocks.size(); ++block)
+        {
+            const Employee* first = mBlocks[block];
+            if (&employee >= first && &employee < first + kBlockSize)
+            {
+                size_t slot = (block << kBlockShift) + static_cast<size_t>(&employee - first);
+                if (slot < mSize && !isVacant(slot))
+                {
+                    return slot;
+                }
+            }
+        }
+        throw logic_error("Employee is not stored here.");
+    }
+
+    void EmployeeStore::keepNext()
+    {
+        if (mGapBegin != mGapEnd)
+        {
+            Employee& record = slotAt(mGapEnd);
+            new (&slotAt(mGapBegin)) Employee(record);
+            record.~Employee();
+        }
+        ++mGapBegin;
+        ++mGapEnd;
+    }
+
+    void EmployeeStore::eraseNext()
+    {
+        slotAt(mGapEnd).~Employee();
+        ++mGapEnd;
+    }
+
+    void EmployeeStore::closeGap()
+    {
+        if (mGapEnd != mSize)
+        {
+            throw logic_error("Only a gap at the end of the store can be closed.");
+        }
+        mSize = mGapBegin;
+        mGapBegin = 0;
+        mGapEnd = 0;
+        size_t blocksNeeded = (mSize + kBlockSize - 1) >> kBlockShift;
+        while (mBlocks.size() > blocksNeeded)
+        {
+            blockPool().release(mBlocks.back());
+            mBlocks.pop_back();
+        }
+    }
+
+    void EmployeeStore::addBlock()
+    {
+        Employee* block = blockPool().allocate();
+        try
+        {
+            mBlocks.push_back(block);
+        }
+        catch (...)
+        {
+            blockPool().release(block);
+            throw;
+        }
+    }
+}
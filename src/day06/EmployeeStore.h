@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Employee.h"
+
+namespace Records
+{
+    // Append-only storage for Employee records, kept in fixed-size blocks
+    // that are never reallocated. Adding a record never moves the existing
+    // ones, so references handed out earlier stay valid for the lifetime of
+    // the store and growth costs one block allocation instead of a copy of
+    // the whole roster.
+    //
+    // The one exception is compaction. While Database compacts a store, a
+    // gap of vacant slots, [gapBegin(), gapEnd()), may lie among the
+    // records: each step either moves the record just past the gap down to
+    // its start or erases it, and once the gap reaches the end it is closed
+    // by shrinking the store. Records keep their order, but a moved record
+    // has a new address. Iteration skips the gap.
+    class EmployeeStore
+    {
+        public:
+            static constexpr std::size_t kBlockShift = 12;
+            static constexpr std::size_t kBlockSize = std::size_t{1} << kBlockShift;
+
+            template <typename Value>
+            class Iterator;
+            using iterator = Iterator<Employee>;
+            using const_iterator = Iterator<const Employee>;
+
+            EmployeeStore() = default;
+            ~EmployeeStore();
+            EmployeeStore(const EmployeeStore&) = delete;
+            EmployeeStore& operator=(const EmployeeStore&) = delete;
+
+            template <typename... Args>
+            Employee& emplace_back(Args&&... args)
+            {
+                if (mSize == mBlocks.size() * kBlockSize)
+                {
+                    addBlock();
+                }
+                Employee* slot = &slotAt(mSize);
+                new (slot) Employee(std::forward<Args>(args)...);
+                ++mSize;
+                return *slot;
+            }
+
+            // Allocates enough blocks up front to hold count records.
+            void reserve(std::size_t count);
+
+            // Slot of a record stored here. Scans the block table, so callers
+            // should prefer an index when they have one.
+            std::size_t indexOf(const Employee& employee) const;
+
+            std::size_t gapBegin() const { return mGapBegin; }
+            std::size_t gapEnd() const { return mGapEnd; }
+            bool isVacant(std::size_t slot) const { return slot >= mGapBegin && slot < mGapEnd; }
+            // Moves the record at gapEnd() to gapBegin(), shifting the gap up
+            // by one; with no gap open, just steps past the record. The moved
+            // record is a copy, so it is no longer bound to a listener.
+            void keepNext();
+            // Destroys the record at gapEnd(), which widens the gap by one.
+            void eraseNext();
+            // Drops a gap that has reached the end of the store, along with
+            // any blocks the remaining records do not need. The next
+            // compaction starts again from slot 0.
+            void closeGap();
+
+            Employee& operator[](std::size_t slot) { return slotAt(slot); }
+            const Employee& operator[](std::size_t slot) const
+            {
+                return const_cast<EmployeeStore*>(this)->slotAt(slot);
+            }
+
+            // Records held, not counting the gap.
+            std::size_t size() const { return mSize - (mGapEnd - mGapBegin); }
+            bool empty() const { return size() == 0; }
+            // One past the highest slot in use.
+            std::size_t slotCount() const { return mSize; }
+
+            iterator begin() { return iterator(this, firstSlot()); }
+            iterator end() { return iterator(this, mSize); }
+            const_iterator begin() const { return const_iterator(this, firstSlot()); }
+            const_iterator end() const { return const_iterator(this, mSize); }
+
+            template <typename Value>
+            class Iterator
+            {
+                public:
+                    using iterator_category = std::forward_iterator_tag;
+                    using value_type = Employee;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = Value*;
+                    using reference = Value&;
+
+                    using Store = std::conditional_t<std::is_const_v<Value>,
+                                                     const EmployeeStore, EmployeeStore>;
+
+                    Iterator() = default;
+                    Iterator(Store* store, std::size_t slot) : mStore(store), mSlot(slot) {}
+
+                    reference operator*() const { return (*mStore)[mSlot]; }
+                    pointer operator->() const { return &(*mStore)[mSlot]; }
+                    Iterator& operator++()
+                    {
+                        if (++mSlot == mStore->mGapBegin)
+                        {
+                            mSlot = mStore->mGapEnd;
+                        }
+                        return *this;
+                    }
+                    Iterator operator++(int) { Iterator old = *this; ++*this; return old; }
+                    bool operator==(const Iterator& rhs) const { return mSlot == rhs.mSlot; }
+                    bool operator!=(const Iterator& rhs) const { return mSlot != rhs.mSlot; }
+
+                private:
+                    Store* mStore = nullptr;
+                    std::size_t mSlot = 0;
+            };
+
+        private:
+            Employee& slotAt(std::size_t slot)
+            {
+                return mBlocks[slot >> kBlockShift][slot & (kBlockSize - 1)];
+            }
+
+            std::size_t firstSlot() const { return mGapBegin == 0 ? mGapEnd : 0; }
+
+            void addBlock();
+
+            // Only this table of block pointers ever grows by reallocation.
+            std::vector<Employee*> mBlocks;
+            std::size_t mSize = 0;
+            std::size_t mGapBegin = 0;
+            std::size_t mGapEnd = 0;
+    };
+}
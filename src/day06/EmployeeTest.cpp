@@ -1,5 +1,9 @@
+#include <cstdio>
 #include <iostream>
+#include <string>
 #include "Employee.h"
+#include "ReportWriter.h"
+#include "TestHelpers.h"
 
 using namespace std;
 using namespace Records;
@@ -20,6 +24,33 @@ int main()
     emp.promote(50);
     emp.hire();
     emp.display();
-    
-    return 0;
+
+    CHECK(emp.getFirstName() == "John");
+    CHECK(emp.getLastName() == "Doe");
+    CHECK(emp.getEmployeeNumber() == 71);
+    CHECK(emp.getSalary() == 51050);
+    CHECK(emp.isHired());
+    emp.demote(2000);
+    emp.fire();
+    CHECK(emp.getSalary() == 49050);
+    CHECK(!emp.isHired());
+
+    // Several employees can share one writer's batch.
+    FILE* out = tmpfile();
+    CHECK(out != nullptr);
+    {
+        ReportWriter writer(out);
+        emp.display(writer);
+        emp.display(writer);
+        CHECK(ftell(out) == 0);
+    }
+    string expected = "Employee: Doe, John\n------------------------------\nFormer Employee\n"
+                      "Employee Number: 71\nSalary: $49050\n\n";
+    string written(static_cast<size_t>(ftell(out)), '\0');
+    rewind(out);
+    CHECK(fread(written.data(), 1, written.size(), out) == written.size());
+    CHECK(written == expected + expected);
+    fclose(out);
+
+    return Testing::testResult();
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+/*
+ * Bulk hiring: mean and worst-case latency of appending to EmployeeStore
+ * compared with a std::vector<Employee>, whose growth copies the roster.
+ * Database::addEmployee adds index maintenance on top of the store.
+ *
+ * Usage: HireBenchmark [employees]   (default 10000000)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Database.h"
+
+using namespace std;
+using namespace Records;
+
+struct Latency
+{
+    double meanNanos = 0;
+    double worstNanos = 0;
+};
+
+template <typename Add>
+static Latency measure(size_t count, const vector<string>& names, Add&& add)
+{
+    Latency result;
+    auto start = Bench::Clock::now();
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto before = Bench::Clock::now();
+        add(names[i % names.size()], names[(i * 7) % names.size()]);
+        chrono::duration<double, nano> took = Bench::Clock::now() - before;
+        result.worstNanos = max(result.worstNanos, took.count());
+    }
+    chrono::duration<double, nano> total = Bench::Clock::now() - start;
+    result.meanNanos = total.count() / static_cast<double>(count);
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+
+    vector<string> names;
+    for (int i = 0; i < 4096; ++i)
+    {
+        names.push_back("Name" + to_string(i));
+    }
+
+    Latency vectorAdds;
+    {
+        vector<Employee> employees;
+        vectorAdds = measure(count, names, [&](const string& first, const string& last) {
+            employees.push_back(Employee(first, last));
+        });
+    }
+
+    Latency storeAdds;
+    {
+        EmployeeStore employees;
+        storeAdds = measure(count, names, [&](const string& first, const string& last) {
+            employees.emplace_back(first, last);
+        });
+    }
+
+    Latency databaseAdds;
+    {
+        Database db;
+        databaseAdds = measure(count, names, [&](const string& first, const string& last) {
+            Bench::doNotOptimize(db.addEmployee(first, last).getEmployeeNumber());
+        });
+    }
+
+    cout << fixed << setprecision(1);
+    cout << setw(24) << "" << setw(14) << "mean ns" << setw(14) << "worst us" << endl;
+    cout << setw(24) << "vector<Employee>" << setw(14) << vectorAdds.meanNanos
+         << setw(14) << vectorAdds.worstNanos / 1000 << endl;
+    cout << setw(24) << "EmployeeStore" << setw(14) << storeAdds.meanNanos
+         << setw(14) << storeAdds.worstNanos / 1000 << endl;
+    cout << setw(24) << "Database::addEmployee" << setw(14) << databaseAdds.meanNanos
+         << setw(14) << databaseAdds.worstNanos / 1000 << endl;
+    return 0;
+}
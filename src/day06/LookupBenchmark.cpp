@@ -0,0 +1,77 @@
+/*
+ * Compares Database::getEmployee(int) against the linear scan it replaced.
+ *
+ * Usage: LookupBenchmark [maxEmployees]   (default 10000000)
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Database.h"
+
+using namespace std;
+using namespace Records;
+
+// The lookup Database::getEmployee used before the offset table.
+static Employee& scanForEmployee(vector<Employee>& employees, int employeeNumber)
+{
+    for (auto& employee : employees)
+    {
+        if (employee.getEmployeeNumber() == employeeNumber)
+        {
+            return employee;
+        }
+    }
+    throw logic_error("No employee found.");
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxEmployees = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+
+    cout << setw(12) << "employees" << setw(16) << "index ns/op"
+         << setw(16) << "scan ns/op" << setw(12) << "speedup" << endl;
+
+    for (size_t count = 1000; count <= maxEmployees; count *= 10)
+    {
+        Database db;
+        vector<Employee> flat;
+        flat.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            flat.push_back(db.addEmployee("First" + to_string(i % 1000),
+                                          "Last" + to_string(i)));
+        }
+
+        mt19937 rng(42);
+        uniform_int_distribution<int> pick(kDefaultEmployeeNumber,
+                                           kDefaultEmployeeNumber + static_cast<int>(count) - 1);
+        vector<int> keys(1 << 16);
+        for (auto& key : keys)
+        {
+            key = pick(rng);
+        }
+        size_t mask = keys.size() - 1;
+
+        double indexed = Bench::nanosPerOp(1000000, [&](size_t i) {
+            Bench::doNotOptimize(db.getEmployee(keys[i & mask]).getSalary());
+        });
+
+        // A scan touches every record, so keep its total work bounded.
+        size_t scanOps = count >= 100000000 ? 1 : 100000000 / count;
+        double scanned = Bench::nanosPerOp(scanOps, [&](size_t i) {
+            Bench::doNotOptimize(scanForEmployee(flat, keys[i & mask]).getSalary());
+        });
+
+        cout << setw(12) << count << setw(16) << fixed << setprecision(1) << indexed
+             << setw(16) << scanned << setw(11) << setprecision(0) << scanned / indexed
+             << "x" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Measures Database::getEmployee(firstName, lastName) on rosters with many
+ * shared surnames and first names.
+ *
+ * Usage: NameLookupBenchmark [maxEmployees]   (default 10000000)
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Database.h"
+
+using namespace std;
+using namespace Records;
+
+int main(int argc, char* argv[])
+{
+    size_t maxEmployees = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+
+    // 2000 first names x 5000 surnames, so most full names occur only a few
+    // times while each part is heavily shared.
+    vector<string> firstNames;
+    vector<string> lastNames;
+    for (int i = 0; i < 2000; ++i)
+    {
+        firstNames.push_back("First" + to_string(i));
+    }
+    for (int i = 0; i < 5000; ++i)
+    {
+        lastNames.push_back("Surname" + to_string(i));
+    }
+
+    cout << setw(12) << "employees" << setw(14) << "hit ns/op"
+         << setw(14) << "miss ns/op" << endl;
+
+    for (size_t count = 1000; count <= maxEmployees; count *= 10)
+    {
+        Database db;
+        mt19937 rng(7);
+        vector<pair<int, int>> names(count);
+        for (auto& name : names)
+        {
+            name = { static_cast<int>(rng() % firstNames.size()),
+                     static_cast<int>(rng() % lastNames.size()) };
+            db.addEmployee(firstNames[name.first], lastNames[name.second]);
+        }
+
+        vector<pair<int, int>> keys(1 << 16);
+        for (auto& key : keys)
+        {
+            key = names[rng() % names.size()];
+        }
+        size_t mask = keys.size() - 1;
+
+        double hit = Bench::nanosPerOp(1000000, [&](size_t i) {
+            const auto& key = keys[i & mask];
+            Bench::doNotOptimize(
+                db.getEmployee(firstNames[key.first], lastNames[key.second]).getSalary());
+        });
+
+        string unknown = "Nobody";
+        double miss = Bench::nanosPerOp(1000000, [&](size_t i) {
+            const auto& key = keys[i & mask];
+            Bench::doNotOptimize(db.findEmployees(unknown, lastNames[key.second]).size());
+        });
+
+        cout << setw(12) << count << setw(14) << fixed << setprecision(1) << hit
+             << setw(14) << miss << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Bytes per employee on a synthetic roster, with names held as two
+ * std::string members (the old Employee layout) and as NamePool ids.
+ *
+ * Usage: NameMemoryReport [employees]   (default 10000000)
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "EmployeeStore.h"
+
+using namespace std;
+using namespace Records;
+
+// Every allocation in this program goes through these, so the live heap
+// size can be read before and after building each roster.
+static atomic<size_t> gLiveBytes{0};
+
+void* operator new(size_t size)
+{
+    void* block = malloc(size + 16);
+    if (block == nullptr)
+    {
+        throw bad_alloc();
+    }
+    *static_cast<size_t*>(block) = size;
+    gLiveBytes += size;
+    return static_cast<char*>(block) + 16;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+    {
+        void* block = static_cast<char*>(ptr) - 16;
+        gLiveBytes -= *static_cast<size_t*>(block);
+        free(block);
+    }
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+// The fields of Employee before names were interned.
+struct StringEmployee
+{
+    string mFirstName;
+    string mLastName;
+    int mEmployeeNumber = -1;
+    int mSalary = kDefaultStartingSlalary;
+    bool mIsHired = false;
+};
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+
+    // 5000 first names and 50000 surnames of 4 to 24 characters, drawn with
+    // a skew so common names repeat heavily.
+    mt19937 rng(2024);
+    auto makeName = [&](const string& stem, size_t i) {
+        string name = stem + to_string(i);
+        name.resize(4 + rng() % 21, 'x');
+        return name;
+    };
+    vector<string> firstNames;
+    vector<string> lastNames;
+    for (size_t i = 0; i < 5000; ++i)
+    {
+        firstNames.push_back(makeName("F", i));
+    }
+    for (size_t i = 0; i < 50000; ++i)
+    {
+        lastNames.push_back(makeName("L", i));
+    }
+    auto pick = [&](const vector<string>& names) -> const string& {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return names[static_cast<size_t>(u * u * u * static_cast<double>(names.size()))];
+    };
+
+    size_t before = gLiveBytes;
+    double stringBytes = 0;
+    {
+        vector<StringEmployee> roster(count);
+        for (auto& employee : roster)
+        {
+            employee.mFirstName = pick(firstNames);
+            employee.mLastName = pick(lastNames);
+        }
+        stringBytes = static_cast<double>(gLiveBytes - before) / static_cast<double>(count);
+    }
+
+    rng.seed(2024);
+    before = gLiveBytes;
+    double internedBytes = 0;
+    {
+        EmployeeStore roster;
+        roster.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            roster.emplace_back(pick(firstNames), pick(lastNames));
+        }
+        internedBytes = static_cast<double>(gLiveBytes - before) / static_cast<double>(count);
+    }
+
+    cout << "employees: " << count << endl;
+    cout << "distinct names in pool: " << NamePool::global().size() << endl;
+    cout << fixed << setprecision(1);
+    cout << setw(28) << "std::string names" << setw(10) << stringBytes << " bytes/employee"
+         << "  (sizeof " << sizeof(StringEmployee) << ")" << endl;
+    cout << setw(28) << "NamePool ids" << setw(10) << internedBytes << " bytes/employee"
+         << "  (sizeof " << sizeof(Employee) << ", pool "
+         << NamePool::global().bytesUsed() / (1024 * 1024) << " MiB)" << endl;
+    return 0;
+}
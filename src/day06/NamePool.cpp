@@ -0,0 +1,139 @@
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+#include "NamePool.h"
+
+using namespace std;
+
+namespace Records
+{
+    NamePool::NamePool()
+        : mEntries(new unique_ptr<Entry[]>[kMaxEntryChunks])
+    {
+        intern(string_view());
+    }
+
+    NamePool& NamePool::global()
+    {
+        // Never destroyed, so employees with static lifetime can still read
+        // their names during shutdown.
+        static NamePool* pool = new NamePool;
+        return *pool;
+    }
+
+    NamePool::IndexShard& NamePool::shardFor(string_view name)
+    {
+        return mShards[hash<string_view>()(name) % kIndexShards];
+    }
+
+    const NamePool::IndexShard& NamePool::shardFor(string_view name) const
+    {
+        return mShards[hash<string_view>()(name) % kIndexShards];
+    }
+
+    NameId NamePool::intern(string_view name)
+    {
+        IndexShard& shard = shardFor(name);
+        {
+            shared_lock<shared_mutex> lock(shard.mutex);
+            auto found = shard.ids.find(name);
+            if (found != shard.ids.end())
+            {
+                return found->second;
+            }
+        }
+        unique_lock<shared_mutex> lock(shard.mutex);
+        // Another thread may have added it between the two locks.
+        auto found = shard.ids.find(name);
+        if (found != shard.ids.end())
+        {
+            return found->second;
+        }
+        NameId id = add(name);
+        shard.ids.emplace(view(id), id);
+        return id;
+    }
+
+    NameId NamePool::add(string_view name)
+    {
+        lock_guard<mutex> lock(mStoreMutex);
+        if (mSize == kMaxEntryChunks * kEntriesPerChunk)
+        {
+            throw length_error("Name pool is full.");
+        }
+
+        NameId id = static_cast<NameId>(mSize);
+        unique_ptr<Entry[]>& chunk = mEntries[id >> kEntryShift];
+        if (!chunk)
+        {
+            chunk.reset(new Entry[kEntriesPerChunk]);
+        }
+        const char* data = store(name);
+        chunk[id & (kEntriesPerChunk - 1)] = { data, static_cast<uint32_t>(name.size()) };
+        ++mSize;
+        return id;
+    }
+
+    bool NamePool::find(string_view name, NameId& id) const
+    {
+        const IndexShard& shard = shardFor(name);
+        shared_lock<shared_mutex> lock(shard.mutex);
+        auto found = shard.ids.find(name);
+        if (found == shard.ids.end())
+        {
+            return false;
+        }
+        id = found->second;
+        return true;
+    }
+
+    size_t NamePool::size() const
+    {
+        lock_guard<mutex> lock(mStoreMutex);
+        return mSize;
+    }
+
+    size_t NamePool::bytesUsed() const
+    {
+        size_t index = 0;
+        for (const IndexShard& shard : mShards)
+        {
+            shared_lock<shared_mutex> lock(shard.mutex);
+            index += shard.ids.bucket_count() * sizeof(void*)
+                   + shard.ids.size() * (sizeof(pair<const string_view, NameId>) + 2 * sizeof(void*));
+        }
+        lock_guard<mutex> lock(mStoreMutex);
+        size_t chunks = (mSize + kEntriesPerChunk - 1) / kEntriesPerChunk;
+        size_t table = kMaxEntryChunks * sizeof(unique_ptr<Entry[]>)
+                     + chunks * kEntriesPerChunk * sizeof(Entry);
+        return mArenaBytes + table + index;
+    }
+
+    const char* NamePool::store(string_view name)
+    {
+        if (name.empty())
+        {
+            return "";
+        }
+        if (name.size() > kArenaChunkBytes / 4)
+        {
+            // Oversized names get their own allocation rather than wasting
+            // the rest of an arena chunk.
+            mLargeNames.emplace_back(new char[name.size()]);
+            mArenaBytes += name.size();
+            memcpy(mLargeNames.back().get(), name.data(), name.size());
+            return mLargeNames.back().get();
+        }
+        if (mArenaUsed + name.size() > kArenaChunkBytes)
+        {
+            mArena.emplace_back(new char[kArenaChunkBytes]);
+            mArenaBytes += kArenaChunkBytes;
+            mArenaUsed = 0;
+        }
+        char* data = mArena.back().get() + mArenaUsed;
+        memcpy(data, name.data(), name.size());
+        mArenaUsed += name.size();
+        return data;
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Records
+{
+    // Compact handle for a string stored in a NamePool.
+    using NameId = std::uint32_t;
+
+    // Append-only table of distinct strings. Each distinct name is stored
+    // once and referred to by a 32-bit id, so a roster where thousands of
+    // employees share a surname keeps a single copy of it. Strings are never
+    // removed or moved: a view returned by view() stays valid for the life of
+    // the pool.
+    //
+    // intern() and find() may be called from several threads. The index is
+    // split by hash into shards with a reader-writer lock each: looking up a
+    // name that is already there takes its shard's shared lock, and only
+    // adding a new name takes the exclusive one (and the storage lock), so
+    // hires and name lookups on different threads do not serialize. view()
+    // takes no lock; it is safe for any id the calling thread has obtained.
+    class NamePool
+    {
+        public:
+            // Id of the empty string, which every pool contains.
+            static constexpr NameId kEmptyName = 0;
+
+            NamePool();
+            NamePool(const NamePool&) = delete;
+            NamePool& operator=(const NamePool&) = delete;
+
+            // The pool shared by every Employee in the process.
+            static NamePool& global();
+
+            // Id of name, adding it if it is not in the pool yet.
+            NameId intern(std::string_view name);
+            // Looks name up without adding it. Returns false if it is unknown.
+            bool find(std::string_view name, NameId& id) const;
+
+            std::string_view view(NameId id) const
+            {
+                const Entry& entry = mEntries[id >> kEntryShift][id & (kEntriesPerChunk - 1)];
+                return std::string_view(entry.data, entry.length);
+            }
+
+            std::size_t size() const;
+            // Heap bytes held by the string arena, entry table and hash index.
+            std::size_t bytesUsed() const;
+
+        private:
+            struct Entry
+            {
+                const char* data;
+                std::uint32_t length;
+            };
+
+            static constexpr std::size_t kEntryShift = 16;
+            static constexpr std::size_t kEntriesPerChunk = std::size_t{1} << kEntryShift;
+            static constexpr std::size_t kMaxEntryChunks = std::size_t{1} << (32 - kEntryShift);
+            static constexpr std::size_t kArenaChunkBytes = std::size_t{1} << 20;
+            static constexpr std::size_t kIndexShards = 16;
+
+            // Each shard sits on its own cache lines so that readers of one
+            // do not invalidate their neighbours.
+            struct alignas(64) IndexShard
+            {
+                mutable std::shared_mutex mutex;
+                std::unordered_map<std::string_view, NameId> ids;
+            };
+
+            IndexShard& shardFor(std::string_view name);
+            const IndexShard& shardFor(std::string_view name) const;
+            // Copies name into the arena and gives it the next id. Needs
+            // mStoreMutex.
+            NameId add(std::string_view name);
+            const char* store(std::string_view name);
+
+            IndexShard mShards[kIndexShards];
+            // Guards the entry table and the arena, which only new names
+            // touch.
+            mutable std::mutex mStoreMutex;
+            // Fixed table of entry chunks: publishing a new chunk never moves
+            // the existing ones, which is what lets view() skip the lock.
+            std::unique_ptr<std::unique_ptr<Entry[]>[]> mEntries;
+            std::size_t mSize = 0;
+            std::vector<std::unique_ptr<char[]>> mArena;
+            std::vector<std::unique_ptr<char[]>> mLargeNames;
+            std::size_t mArenaUsed = kArenaChunkBytes;
+            std::size_t mArenaBytes = 0;
+    };
+}
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "OperationStats.h"
+
+using namespace std;
+
+namespace Records
+{
+    namespace
+    {
+        // One thread's counts. Only that thread writes them, so each update
+        // is a plain load and store; the atomics only make the reads from
+        // collect() well defined.
+        struct OperationBuffer
+        {
+            array<atomic<uint64_t>, LatencyHistogram::kBucketCount> counts;
+            atomic<uint64_t> count;
+            atomic<uint64_t> failures;
+            atomic<uint64_t> total;
+            atomic<uint64_t> min{UINT64_MAX};
+            atomic<uint64_t> max;
+        };
+
+        struct ThreadBuffer
+        {
+            array<OperationBuffer, kOperationCount> operations;
+        };
+
+        void add(atomic<uint64_t>& counter, uint64_t amount)
+        {
+            counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+        }
+
+        struct Registry
+        {
+            mutex lock;
+            vector<ThreadBuffer*> live;
+            // Counts of threads that have exited.
+            StatsReport retired;
+        };
+
+        // Never destroyed, so threads that exit after main still find it.
+        Registry& registry()
+        {
+            static Registry* theRegistry = new Registry;
+            return *theRegistry;
+        }
+
+        // Owns the calling thread's buffer for as long as the thread runs.
+        class LocalBuffer
+        {
+            public:
+                LocalBuffer() : mBuffer(new ThreadBuffer())
+                {
+                    Registry& shared = registry();
+                    lock_guard<mutex> guard(shared.lock);
+                    shared.live.push_back(mBuffer.get());
+                }
+                ~LocalBuffer();
+
+                ThreadBuffer& buffer() { return *mBuffer; }
+
+            private:
+                unique_ptr<ThreadBuffer> mBuffer;
+        };
+
+        thread_local LocalBuffer tLocalBuffer;
+    }
+
+    // Copies thread buffers into histograms, whose fields it reaches as a
+    // friend.
+    class OperationStatsAccess
+    {
+        public:
+            static void fold(const ThreadBuffer& buffer, StatsReport& report);
+    };
+
+    const char* operationName(Operation operation)
+    {
+        switch (operation)
+        {
+            case Operation::AddEmployee:
+                return "addEmployee";
+            case Operation::GetEmployeeByNumber:
+                return "getEmployeeByNumber";
+            case Operation::GetEmployeeByName:
+                return "getEmployeeByName";
+            case Operation::DisplayAll:
+                return "displayAll";
+            case Operation::DisplayCurrent:
+                return "displayCurrent";
+            case Operation::DisplayFormer:
+                return "displayFormer";
+        }
+        return "unknown";
+    }
+
+    size_t LatencyHistogram::bucketOf(uint64_t nanos)
+    {
+        if (nanos < kSubBuckets)
+        {
+            return static_cast<size_t>(nanos);
+        }
+        // The top kSubBucketBits bits after the leading one pick the bucket.
+        unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(nanos));
+        unsigned shift = exponent - kSubBucketBits;
+        size_t sub = static_cast<size_t>(nanos >> shift) & (kSubBuckets - 1);
+        return (shift + 1) * kSubBuckets + sub;
+    }
+
+    uint64_t LatencyHistogram::bucketLimit(size_t bucket)
+    {
+        if (bucket < kSubBuckets)
+        {
+            return bucket;
+        }
+        unsigned shift = static_cast<unsigned>(bucket / kSubBuckets) - 1;
+        uint64_t sub = bucket % kSubBuckets;
+        uint64_t lowest = (kSubBuckets + sub) << shift;
+        return lowest + ((uint64_t{1} << shift) - 1);
+    }
+
+    void LatencyHistogram::record(uint64_t nanos, bool failed)
+    {
+        ++mCounts[bucketOf(nanos)];
+        ++mCount;
+        mFailures += failed ? 1 : 0;
+        mTotal += nanos;
+        mMin = std::min(mMin, nanos);
+        mMax = std::max(mMax, nanos);
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other)
+    {
+        for (size_t bucket = 0; bucket < kBucketCount; ++bucket)
+        {
+            mCounts[bucket] += other.mCounts[bucket];
+        }
+        mCount += other.mCount;
+        mFailures += other.mFailures;
+        mTotal += other.mTotal;
+        mMin = std::min(mMin, other.mMin);
+        mMax = std::max(mMax, other.mMax);
+    }
+
+    double LatencyHistogram::meanNanos() const
+    {
+        return mCount == 0 ? 0.0 : static_cast<double>(mTotal) / static_cast<double>(mCount);
+    }
+
+    uint64_t LatencyHistogram::percentile(double fraction) const
+    {
+        if (mCount == 0)
+        {
+            return 0;
+        }
+        double wanted = ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(mCount));
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(wanted));
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < kBucketCount; ++bucket)
+        {
+            seen += mCounts[bucket];
+            if (seen >= rank)
+            {
+                return std::min(bucketLimit(bucket), mMax);
+            }
+        }
+        return mMax;
+    }
+
+    void StatsReport::writeText(ostream& out) const
+    {
+        if (!OperationStats::kEnabled)
+        {
+            out << "Operation statistics are not compiled into this build." << endl;
+            return;
+        }
+        out << left << setw(22) << "operation" << right << setw(10) << "calls" << setw(10) << "failed"
+            << setw(12) << "mean us" << setw(12) << "p50 us" << setw(12) << "p99 us"
+            << setw(12) << "max us" << endl;
+        out << fixed << setprecision(2);
+        for (size_t i = 0; i < kOperationCount; ++i)
+        {
+            const LatencyHistogram& histogram = operations[i];
+            if (histogram.count() == 0)
+            {
+                continue;
+            }
+            out << left << setw(22) << operationName(static_cast<Operation>(i)) << right
+                << setw(10) << histogram.count() << setw(10) << histogram.failures()
+                << setw(12) << histogram.meanNanos() / 1000.0
+                << setw(12) << static_cast<double>(histogram.percentile(0.50)) / 1000.0
+                << setw(12) << static_cast<double>(histogram.percentile(0.99)) / 1000.0
+                << setw(12) << static_cast<double>(histogram.maxNanos()) / 1000.0 << endl;
+        }
+        out << defaultfloat;
+    }
+
+    void StatsReport::writeJson(ostream& out) const
+    {
+        out << "{\"enabled\":" << (OperationStats::kEnabled ? "true" : "false") << ",\"operations\":{";
+        for (size_t i = 0; i < kOperationCount; ++i)
+        {
+            const LatencyHistogram& histogram = operations[i];
+            out << (i == 0 ? "" : ",") << '"' << operationName(static_cast<Operation>(i)) << "\":{"
+                << "\"count\":" << histogram.count()
+                << ",\"failures\":" << histogram.failures()
+                << ",\"totalNanos\":" << histogram.totalNanos()
+                << ",\"minNanos\":" << histogram.minNanos()
+                << ",\"maxNanos\":" << histogram.maxNanos()
+                << ",\"p50Nanos\":" << histogram.percentile(0.50)
+                << ",\"p90Nanos\":" << histogram.percentile(0.90)
+                << ",\"p99Nanos\":" << histogram.percentile(0.99)
+                << ",\"p999Nanos\":" << histogram.percentile(0.999) << '}';
+        }
+        out << "}}" << endl;
+    }
+
+    void OperationStatsAccess::fold(const ThreadBuffer& buffer, StatsReport& report)
+    {
+        for (size_t i = 0; i < kOperationCount; ++i)
+        {
+            const OperationBuffer& from = buffer.operations[i];
+            LatencyHistogram part;
+            for (size_t bucket = 0; bucket < LatencyHistogram::kBucketCount; ++bucket)
+            {
+                part.mCounts[bucket] = from.counts[bucket].load(memory_order_relaxed);
+            }
+            part.mCount = from.count.load(memory_order_relaxed);
+            part.mFailures = from.failures.load(memory_order_relaxed);
+            part.mTotal = from.total.load(memory_order_relaxed);
+            part.mMin = from.min.load(memory_order_relaxed);
+            part.mMax = from.max.load(memory_order_relaxed);
+            report.operations[i].merge(part);
+        }
+    }
+
+    LocalBuffer::~LocalBuffer()
+    {
+        Registry& shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        OperationStatsAccess::fold(*mBuffer, shared.retired);
+        shared.live.erase(find(shared.live.begin(), shared.live.end(), mBuffer.get()));
+    }
+
+    void OperationStats::record(Operation operation, uint64_t nanos, bool failed)
+    {
+        OperationBuffer& counts = tLocalBuffer.buffer().operations[static_cast<size_t>(operation)];
+        add(counts.counts[LatencyHistogram::bucketOf(nanos)], 1);
+        add(counts.count, 1);
+        add(counts.failures, failed ? 1 : 0);
+        add(counts.total, nanos);
+        if (nanos < counts.min.load(memory_order_relaxed))
+        {
+            counts.min.store(nanos, memory_order_relaxed);
+        }
+        if (nanos > counts.max.load(memory_order_relaxed))
+        {
+            counts.max.store(nanos, memory_order_relaxed);
+        }
+    }
+
+    StatsReport OperationStats::collect()
+    {
+        Registry& shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        StatsReport report = shared.retired;
+        for (const ThreadBuffer* buffer : shared.live)
+        {
+            OperationStatsAccess::fold(*buffer, report);
+        }
+        return report;
+    }
+
+    void OperationStats::reset()
+    {
+        Registry& shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        shared.retired = StatsReport();
+        for (ThreadBuffer* buffer : shared.live)
+        {
+            for (OperationBuffer& counts : buffer->operations)
+            {
+                for (auto& bucket : counts.counts)
+                {
+                    bucket.store(0, memory_order_relaxed);
+                }
+                counts.count.store(0, memory_order_relaxed);
+                counts.failures.store(0, memory_order_relaxed);
+                counts.total.store(0, memory_order_relaxed);
+                counts.min.store(UINT64_MAX, memory_order_relaxed);
+                counts.max.store(0, memory_order_relaxed);
+            }
+        }
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <ostream>
+
+namespace Records
+{
+    // Database operations whose calls are counted and timed.
+    enum class Operation : std::uint8_t
+    {
+        AddEmployee,
+        GetEmployeeByNumber,
+        GetEmployeeByName,
+        DisplayAll,
+        DisplayCurrent,
+        DisplayFormer
+    };
+    const std::size_t kOperationCount = 6;
+
+    const char* operationName(Operation operation);
+
+    class OperationStatsAccess;
+
+    // Latency histogram with HDR-style log-linear buckets: every power of
+    // two is split into kSubBuckets buckets, so a recorded value is known to
+    // within 1/kSubBuckets of itself, and values below kSubBuckets
+    // nanoseconds exactly. Covers the whole uint64_t range in 976 buckets.
+    class LatencyHistogram
+    {
+        public:
+            static constexpr unsigned kSubBucketBits = 4;
+            static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+            static constexpr std::size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+            static std::size_t bucketOf(std::uint64_t nanos);
+            // Largest value that falls into bucket.
+            static std::uint64_t bucketLimit(std::size_t bucket);
+
+            void record(std::uint64_t nanos, bool failed = false);
+            void merge(const LatencyHistogram& other);
+
+            std::uint64_t count() const { return mCount; }
+            // Calls that ended by throwing.
+            std::uint64_t failures() const { return mFailures; }
+            std::uint64_t totalNanos() const { return mTotal; }
+            std::uint64_t minNanos() const { return mCount == 0 ? 0 : mMin; }
+            std::uint64_t maxNanos() const { return mMax; }
+            double meanNanos() const;
+            // Upper limit of the bucket holding the value below which
+            // fraction of the recorded values lie; 0 if there are none.
+            std::uint64_t percentile(double fraction) const;
+
+            std::uint64_t bucketCount(std::size_t bucket) const { return mCounts[bucket]; }
+
+        private:
+            friend class OperationStatsAccess;
+
+            std::array<std::uint64_t, kBucketCount> mCounts{};
+            std::uint64_t mCount = 0;
+            std::uint64_t mFailures = 0;
+            std::uint64_t mTotal = 0;
+            std::uint64_t mMin = UINT64_MAX;
+            std::uint64_t mMax = 0;
+    };
+
+    // Counts and latencies of every operation, as merged by
+    // OperationStats::collect().
+    struct StatsReport
+    {
+        std::array<LatencyHistogram, kOperationCount> operations;
+
+        const LatencyHistogram& operator[](Operation operation) const
+        {
+            return operations[static_cast<std::size_t>(operation)];
+        }
+
+        // One line per operation that was called, for people.
+        void writeText(std::ostream& out) const;
+        // A JSON object with one entry per operation, for tools.
+        void writeJson(std::ostream& out) const;
+    };
+
+    // Records Database operations when the library is built with
+    // RECORDS_STATS defined (CMake option RECORDS_ENABLE_STATS). Without it
+    // RECORDS_TIME_OPERATION expands to nothing and the hot paths carry no
+    // trace of it.
+    //
+    // Each thread records into its own buffer, a single writer per counter,
+    // so recording takes no lock and shares no cache line with other
+    // threads. collect() merges every buffer on demand; a buffer whose
+    // thread has exited is folded into a shared total first.
+    class OperationStats
+    {
+        public:
+#ifdef RECORDS_STATS
+            static constexpr bool kEnabled = true;
+#else
+            static constexpr bool kEnabled = false;
+#endif
+
+            static void record(Operation operation, std::uint64_t nanos, bool failed);
+            // Counts so far, from every thread. Empty if stats are compiled out.
+            static StatsReport collect();
+            // Zeroes every count. Calls recorded while it runs may be kept
+            // in part.
+            static void reset();
+    };
+
+    // Times its own lifetime and records it under operation, as a failure
+    // if it ends by an exception unwinding the stack.
+    class OperationTimer
+    {
+        public:
+            explicit OperationTimer(Operation operation)
+                : mOperation(operation)
+                , mExceptions(std::uncaught_exceptions())
+                , mStart(std::chrono::steady_clock::now())
+            {
+            }
+            ~OperationTimer()
+            {
+                std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - mStart;
+                OperationStats::record(mOperation, static_cast<std::uint64_t>(elapsed.count()),
+                                       std::uncaught_exceptions() > mExceptions);
+            }
+            OperationTimer(const OperationTimer&) = delete;
+            OperationTimer& operator=(const OperationTimer&) = delete;
+
+        private:
+            Operation mOperation;
+            int mExceptions;
+            std::chrono::steady_clock::time_point mStart;
+    };
+}
+
+#ifdef RECORDS_STATS
+#define RECORDS_TIME_OPERATION(operation) ::Records::OperationTimer recordsOperationTimer(operation)
+#else
+#define RECORDS_TIME_OPERATION(operation) ((void) 0)
+#endif
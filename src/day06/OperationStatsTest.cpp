@@ -0,0 +1,118 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "Database.h"
+#include "OperationStats.h"
+#include "TestHelpers.h"
+
+using namespace std;
+using namespace Records;
+
+/*
+ * Checks the latency histogram's buckets and percentiles, then that
+ * Database operations are counted from several threads when stats are
+ * compiled in, and not at all when they are not.
+ */
+int main()
+{
+    cout << "Bucketing latencies." << endl;
+    for (uint64_t nanos : { 0ull, 7ull, 15ull, 16ull, 31ull, 32ull, 1000ull, 123456789ull, ~0ull })
+    {
+        size_t bucket = LatencyHistogram::bucketOf(nanos);
+        CHECK(bucket < LatencyHistogram::kBucketCount);
+        CHECK(LatencyHistogram::bucketLimit(bucket) >= nanos);
+        // Within one sub-bucket of the value.
+        CHECK(LatencyHistogram::bucketLimit(bucket) - nanos <= nanos / LatencyHistogram::kSubBuckets);
+        CHECK(bucket == 0 || LatencyHistogram::bucketLimit(bucket - 1) < nanos);
+    }
+
+    LatencyHistogram histogram;
+    for (uint64_t nanos = 1; nanos <= 1000; ++nanos)
+    {
+        histogram.record(nanos, nanos % 100 == 0);
+    }
+    CHECK(histogram.count() == 1000);
+    CHECK(histogram.failures() == 10);
+    CHECK(histogram.minNanos() == 1 && histogram.maxNanos() == 1000);
+    CHECK(histogram.percentile(0.5) >= 500 && histogram.percentile(0.5) <= 500 + 500 / 16);
+    CHECK(histogram.percentile(0.99) >= 990 && histogram.percentile(1.0) == 1000);
+    LatencyHistogram doubled = histogram;
+    doubled.merge(histogram);
+    CHECK(doubled.count() == 2000 && doubled.totalNanos() == 2 * histogram.totalNanos());
+    CHECK(LatencyHistogram().percentile(0.5) == 0);
+
+    cout << "Counting Database operations." << endl;
+    OperationStats::reset();
+    const int kThreads = 4;
+    const int kHires = 500;
+    vector<thread> workers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        workers.emplace_back([&] {
+            Database db;
+            for (int i = 0; i < kHires; ++i)
+            {
+                db.addEmployee("Stats", "Worker" + to_string(i));
+                db.getEmployee(kDefaultEmployeeNumber + i);
+            }
+            db.getEmployee("Stats", "Worker0");
+            try
+            {
+                db.getEmployee(5);
+            }
+            catch (const logic_error&)
+            {
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    // Counts from a thread still running are included too.
+    Database db;
+    db.addEmployee("Main", "Thread");
+
+    StatsReport report = OperationStats::collect();
+    if (OperationStats::kEnabled)
+    {
+        CHECK(report[Operation::AddEmployee].count() == kThreads * kHires + 1);
+        CHECK(report[Operation::GetEmployeeByNumber].count() == kThreads * (kHires + 1));
+        CHECK(report[Operation::GetEmployeeByNumber].failures() == kThreads);
+        CHECK(report[Operation::GetEmployeeByName].count() == kThreads);
+        CHECK(report[Operation::DisplayAll].count() == 0);
+        CHECK(report[Operation::AddEmployee].maxNanos() >= report[Operation::AddEmployee].minNanos());
+    }
+    else
+    {
+        CHECK(report[Operation::AddEmployee].count() == 0);
+    }
+
+    cout << "Counting a name lookup that brings an employee back." << endl;
+    {
+        Database archived;
+        archived.addEmployee("Archived", "Worker").fire();
+        archived.compact();
+        CHECK(archived.archivedCount() == 1);
+        OperationStats::reset();
+        archived.getEmployee("Archived", "Worker");
+        StatsReport lookups = OperationStats::collect();
+        if (OperationStats::kEnabled)
+        {
+            CHECK(lookups[Operation::GetEmployeeByName].count() == 1);
+            CHECK(lookups[Operation::GetEmployeeByNumber].count() == 0);
+        }
+        CHECK(archived.archivedCount() == 0);
+    }
+
+    ostringstream json;
+    report.writeJson(json);
+    CHECK(json.str().find("\"addEmployee\":{\"count\":") != string::npos);
+
+    OperationStats::reset();
+    CHECK(OperationStats::collect()[Operation::AddEmployee].count() == 0);
+
+    return Testing::testResult();
+}
@@ -0,0 +1,424 @@
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RECORDS_PAYROLL_X86 1
+#endif
+
+#include "Payroll.h"
+
+using namespace std;
+
+namespace Records
+{
+    namespace
+    {
+        // The inputs of one query.
+        struct Columns
+        {
+            Columns(const int* salaries, const uint64_t* hiredBits, size_t count, StatusFilter filter)
+                : salaries(salaries), hiredBits(hiredBits), count(count),
+                  flip(filter == StatusFilter::Former ? ~uint64_t{0} : 0),
+                  all(filter == StatusFilter::All ? ~uint64_t{0} : 0)
+            {
+            }
+
+            // Bits of the slots [64 * word, 64 * word + 64) that the query
+            // covers, without branching on the filter.
+            uint64_t selectedWord(size_t word) const
+            {
+                return (hiredBits[word] ^ flip) | all;
+            }
+
+            // Bits of the width slots from slot, which must not cross a word.
+            unsigned selected(size_t slot, unsigned width) const
+            {
+                return static_cast<unsigned>(selectedWord(slot >> 6) >> (slot & 63)) & ((1u << width) - 1);
+            }
+
+            bool isSelected(size_t slot) const
+            {
+                return selected(slot, 1) != 0;
+            }
+
+            const int* salaries;
+            const uint64_t* hiredBits;
+            size_t count;
+            uint64_t flip;
+            uint64_t all;
+        };
+
+        void summarizeScalar(const Columns& columns, size_t begin, PayrollSummary& summary)
+        {
+            for (size_t slot = begin; slot < columns.count; ++slot)
+            {
+                if (columns.isSelected(slot))
+                {
+                    int salary = columns.salaries[slot];
+                    ++summary.count;
+                    summary.total += salary;
+                    summary.minSalary = min(summary.minSalary, salary);
+                    summary.maxSalary = max(summary.maxSalary, salary);
+                }
+            }
+        }
+
+        size_t countAboveScalar(const Columns& columns, size_t begin, int threshold)
+        {
+            size_t count = 0;
+            for (size_t slot = begin; slot < columns.count; ++slot)
+            {
+                count += columns.isSelected(slot) && columns.salaries[slot] > threshold;
+            }
+            return count;
+        }
+
+        // Buckets are described by lowest and bucketWidth; counts holds one
+        // per bucket.
+        void histogramScalar(const Columns& columns, size_t begin, int lowest, int bucketWidth,
+                             vector<size_t>& counts)
+        {
+            for (size_t slot = begin; slot < columns.count; ++slot)
+            {
+                if (columns.isSelected(slot))
+                {
+                    long long offset = static_cast<long long>(columns.salaries[slot]) - lowest;
+                    size_t bucket = offset < 0 ? 0 : static_cast<size_t>(offset / bucketWidth);
+                    ++counts[min(bucket, counts.size() - 1)];
+                }
+            }
+        }
+
+        // The vector histograms find buckets for several lanes at once and
+        // count them in a separate row per lane, plus a spare bucket for
+        // the lanes the filter rejects, so that consecutive increments of
+        // one bucket do not wait on each other. This adds the rows up.
+        void foldLaneCounts(const vector<size_t>& laneCounts, size_t lanes, vector<size_t>& counts)
+        {
+            size_t stride = counts.size() + 1;
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                for (size_t bucket = 0; bucket < counts.size(); ++bucket)
+                {
+                    counts[bucket] += laneCounts[lane * stride + bucket];
+                }
+            }
+        }
+
+#ifdef RECORDS_PAYROLL_X86
+        __attribute__((target("avx2,popcnt")))
+        inline __m256i laneMask8(unsigned bits)
+        {
+            const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+            return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits)), lanes), lanes);
+        }
+
+        __attribute__((target("avx2,popcnt")))
+        void summarizeAvx2(const Columns& columns, PayrollSummary& summary)
+        {
+            size_t end = columns.count & ~size_t{7};
+            __m256i totals = _mm256_setzero_si256();
+            __m256i minimum = _mm256_set1_epi32(INT_MAX);
+            __m256i maximum = _mm256_set1_epi32(INT_MIN);
+            size_t count = 0;
+            for (size_t slot = 0; slot < end; slot += 8)
+            {
+                unsigned bits = columns.selected(slot, 8);
+                __m256i mask = laneMask8(bits);
+                __m256i salaries = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.salaries + slot));
+                __m256i kept = _mm256_and_si256(salaries, mask);
+                totals = _mm256_add_epi64(totals, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(kept)));
+                totals = _mm256_add_epi64(totals, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(kept, 1)));
+                minimum = _mm256_min_epi32(minimum, _mm256_blendv_epi8(_mm256_set1_epi32(INT_MAX), salaries, mask));
+                maximum = _mm256_max_epi32(maximum, _mm256_blendv_epi8(_mm256_set1_epi32(INT_MIN), salaries, mask));
+                count += static_cast<size_t>(__builtin_popcount(bits));
+            }
+
+            alignas(32) long long totalLanes[4];
+            alignas(32) int minimumLanes[8];
+            alignas(32) int maximumLanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(totalLanes), totals);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(minimumLanes), minimum);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(maximumLanes), maximum);
+            summary.count += count;
+            summary.total += totalLanes[0] + totalLanes[1] + totalLanes[2] + totalLanes[3];
+            summary.minSalary = min(summary.minSalary, *min_element(minimumLanes, minimumLanes + 8));
+            summary.maxSalary = max(summary.maxSalary, *max_element(maximumLanes, maximumLanes + 8));
+            summarizeScalar(columns, end, summary);
+        }
+
+        __attribute__((target("avx2,popcnt")))
+        size_t countAboveAvx2(const Columns& columns, int threshold)
+        {
+            size_t end = columns.count & ~size_t{7};
+            __m256i limit = _mm256_set1_epi32(threshold);
+            size_t count = 0;
+            for (size_t slot = 0; slot < end; slot += 8)
+            {
+                __m256i salaries = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.salaries + slot));
+                unsigned above = static_cast<unsigned>(_mm256_movemask_ps(
+                    _mm256_castsi256_ps(_mm256_cmpgt_epi32(salaries, limit))));
+                count += static_cast<size_t>(__builtin_popcount(above & columns.selected(slot, 8)));
+            }
+            return count + countAboveScalar(columns, end, threshold);
+        }
+
+        __attribute__((target("avx2,popcnt")))
+        void histogramAvx2(const Columns& columns, int lowest, int bucketWidth, vector<size_t>& counts)
+        {
+            size_t end = columns.count & ~size_t{3};
+            size_t stride = counts.size() + 1;
+            vector<size_t> laneCounts(4 * stride, 0);
+            const __m256i lanes = _mm256_setr_epi64x(1, 2, 4, 8);
+            const __m256d base = _mm256_set1_pd(lowest);
+            const __m256d width = _mm256_set1_pd(bucketWidth);
+            const __m256d scale = _mm256_set1_pd(1.0 / bucketWidth);
+            const __m256d one = _mm256_set1_pd(1.0);
+            const __m256d first = _mm256_setzero_pd();
+            const __m256d last = _mm256_set1_pd(static_cast<double>(counts.size() - 1));
+            const __m256d spare = _mm256_set1_pd(static_cast<double>(counts.size()));
+            const __m128i rows = _mm_setr_epi32(0, static_cast<int>(stride), static_cast<int>(2 * stride),
+                                                static_cast<int>(3 * stride));
+            for (size_t slot = 0; slot < end; slot += 4)
+            {
+                unsigned bits = columns.selected(slot, 4);
+                __m256d selected = _mm256_castsi256_pd(_mm256_cmpeq_epi64(
+                    _mm256_and_si256(_mm256_set1_epi64x(bits), lanes), lanes));
+                // Offsets from lowest are exact in a double.
+                __m256d offset = _mm256_sub_pd(_mm256_cvtepi32_pd(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.salaries + slot))), base);
+                __m256d bucket = _mm256_floor_pd(_mm256_mul_pd(offset, scale));
+                // Multiplying by the rounded reciprocal can land one bucket
+                // off near an edge; the bucket's exact start settles it.
+                __m256d start = _mm256_mul_pd(bucket, width);
+                bucket = _mm256_sub_pd(bucket, _mm256_and_pd(_mm256_cmp_pd(offset, start, _CMP_LT_OQ), one));
+                bucket = _mm256_add_pd(bucket, _mm256_and_pd(
+                    _mm256_cmp_pd(offset, _mm256_add_pd(start, width), _CMP_GE_OQ), one));
+                bucket = _mm256_min_pd(_mm256_max_pd(bucket, first), last);
+                bucket = _mm256_blendv_pd(spare, bucket, selected);
+                alignas(16) int index[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(index),
+                                _mm_add_epi32(_mm256_cvttpd_epi32(bucket), rows));
+                ++laneCounts[static_cast<size_t>(index[0])];
+                ++laneCounts[static_cast<size_t>(index[1])];
+                ++laneCounts[static_cast<size_t>(index[2])];
+                ++laneCounts[static_cast<size_t>(index[3])];
+            }
+            foldLaneCounts(laneCounts, 4, counts);
+            histogramScalar(columns, end, lowest, bucketWidth, counts);
+        }
+
+        __attribute__((target("sse4.1,popcnt")))
+        inline __m128i laneMask4(unsigned bits)
+        {
+            const __m128i lanes = _mm_setr_epi32(1, 2, 4, 8);
+            return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<int>(bits)), lanes), lanes);
+        }
+
+        __attribute__((target("sse4.1,popcnt")))
+        void summarizeSse41(const Columns& columns, PayrollSummary& summary)
+        {
+            size_t end = columns.count & ~size_t{3};
+            __m128i totals = _mm_setzero_si128();
+            __m128i minimum = _mm_set1_epi32(INT_MAX);
+            __m128i maximum = _mm_set1_epi32(INT_MIN);
+            size_t count = 0;
+            for (size_t slot = 0; slot < end; slot += 4)
+            {
+                unsigned bits = columns.selected(slot, 4);
+                __m128i mask = laneMask4(bits);
+                __m128i salaries = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.salaries + slot));
+                __m128i kept = _mm_and_si128(salaries, mask);
+                totals = _mm_add_epi64(totals, _mm_cvtepi32_epi64(kept));
+                totals = _mm_add_epi64(totals, _mm_cvtepi32_epi64(_mm_srli_si128(kept, 8)));
+                minimum = _mm_min_epi32(minimum, _mm_blendv_epi8(_mm_set1_epi32(INT_MAX), salaries, mask));
+                maximum = _mm_max_epi32(maximum, _mm_blendv_epi8(_mm_set1_epi32(INT_MIN), salaries, mask));
+                count += static_cast<size_t>(__builtin_popcount(bits));
+            }
+
+            alignas(16) long long totalLanes[2];
+            alignas(16) int minimumLanes[4];
+            alignas(16) int maximumLanes[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(totalLanes), totals);
+            _mm_store_si128(reinterpret_cast<__m128i*>(minimumLanes), minimum);
+            _mm_store_si128(reinterpret_cast<__m128i*>(maximumLanes), maximum);
+            summary.count += count;
+            summary.total += totalLanes[0] + totalLanes[1];
+            summary.minSalary = min(summary.minSalary, *min_element(minimumLanes, minimumLanes + 4));
+            summary.maxSalary = max(summary.maxSalary, *max_element(maximumLanes, maximumLanes + 4));
+            summarizeScalar(columns, end, summary);
+        }
+
+        __attribute__((target("sse4.1,popcnt")))
+        size_t countAboveSse41(const Columns& columns, int threshold)
+        {
+            size_t end = columns.count & ~size_t{3};
+            __m128i limit = _mm_set1_epi32(threshold);
+            size_t count = 0;
+            for (size_t slot = 0; slot < end; slot += 4)
+            {
+                __m128i salaries = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.salaries + slot));
+                unsigned above = static_cast<unsigned>(_mm_movemask_ps(
+                    _mm_castsi128_ps(_mm_cmpgt_epi32(salaries, limit))));
+                count += static_cast<size_t>(__builtin_popcount(above & columns.selected(slot, 4)));
+            }
+            return count + countAboveScalar(columns, end, threshold);
+        }
+
+        __attribute__((target("sse4.1,popcnt")))
+        void histogramSse41(const Columns& columns, int lowest, int bucketWidth, vector<size_t>& counts)
+        {
+            size_t end = columns.count & ~size_t{1};
+            size_t stride = counts.size() + 1;
+            vector<size_t> laneCounts(2 * stride, 0);
+            const __m128i lanes = _mm_set_epi64x(2, 1);
+            const __m128d base = _mm_set1_pd(lowest);
+            const __m128d width = _mm_set1_pd(bucketWidth);
+            const __m128d scale = _mm_set1_pd(1.0 / bucketWidth);
+            const __m128d one = _mm_set1_pd(1.0);
+            const __m128d first = _mm_setzero_pd();
+            const __m128d last = _mm_set1_pd(static_cast<double>(counts.size() - 1));
+            const __m128d spare = _mm_set1_pd(static_cast<double>(counts.size()));
+            const __m128i rows = _mm_setr_epi32(0, static_cast<int>(stride), 0, 0);
+            for (size_t slot = 0; slot < end; slot += 2)
+            {
+                unsigned bits = columns.selected(slot, 2);
+                __m128d selected = _mm_castsi128_pd(_mm_cmpeq_epi64(
+                    _mm_and_si128(_mm_set1_epi64x(bits), lanes), lanes));
+                __m128d offset = _mm_sub_pd(_mm_cvtepi32_pd(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i*>(columns.salaries + slot))), base);
+                __m128d bucket = _mm_floor_pd(_mm_mul_pd(offset, scale));
+                __m128d start = _mm_mul_pd(bucket, width);
+                bucket = _mm_sub_pd(bucket, _mm_and_pd(_mm_cmplt_pd(offset, start), one));
+                bucket = _mm_add_pd(bucket, _mm_and_pd(_mm_cmpge_pd(offset, _mm_add_pd(start, width)), one));
+                bucket = _mm_min_pd(_mm_max_pd(bucket, first), last);
+                bucket = _mm_blendv_pd(spare, bucket, selected);
+                __m128i index = _mm_add_epi32(_mm_cvttpd_epi32(bucket), rows);
+                ++laneCounts[static_cast<size_t>(_mm_cvtsi128_si32(index))];
+                ++laneCounts[static_cast<size_t>(_mm_extract_epi32(index, 1))];
+            }
+            foldLaneCounts(laneCounts, 2, counts);
+            histogramScalar(columns, end, lowest, bucketWidth, counts);
+        }
+#endif
+    }
+
+    PayrollScan::PayrollScan(const int* salaries, const uint64_t* hiredBits, size_t count, Kernel kernel)
+        : mSalaries(salaries), mHiredBits(hiredBits), mCount(count), mKernel(kernel)
+    {
+        if (!isSupported(kernel))
+        {
+            throw invalid_argument(string(name(kernel)) + " is not supported on this CPU.");
+        }
+    }
+
+    PayrollSummary PayrollScan::summarize(StatusFilter filter) const
+    {
+        Columns columns(mSalaries, mHiredBits, mCount, filter);
+        PayrollSummary summary;
+        summary.minSalary = INT_MAX;
+        summary.maxSalary = INT_MIN;
+        switch (mKernel)
+        {
+#ifdef RECORDS_PAYROLL_X86
+            case Kernel::Avx2:
+                summarizeAvx2(columns, summary);
+                break;
+            case Kernel::Sse41:
+                summarizeSse41(columns, summary);
+                break;
+#endif
+            default:
+                summarizeScalar(columns, 0, summary);
+                break;
+        }
+        if (summary.count == 0)
+        {
+            summary.minSalary = 0;
+            summary.maxSalary = 0;
+        }
+        return summary;
+    }
+
+    size_t PayrollScan::countAbove(int threshold, StatusFilter filter) const
+    {
+        Columns columns(mSalaries, mHiredBits, mCount, filter);
+        switch (mKernel)
+        {
+#ifdef RECORDS_PAYROLL_X86
+            case Kernel::Avx2:
+                return countAboveAvx2(columns, threshold);
+            case Kernel::Sse41:
+                return countAboveSse41(columns, threshold);
+#endif
+            default:
+                return countAboveScalar(columns, 0, threshold);
+        }
+    }
+
+    vector<size_t> PayrollScan::histogram(int lowest, int bucketWidth, size_t bucketCount,
+                                          StatusFilter filter) const
+    {
+        if (bucketWidth <= 0 || bucketCount == 0)
+        {
+            throw invalid_argument("A histogram needs a positive bucket width and count.");
+        }
+        Columns columns(mSalaries, mHiredBits, mCount, filter);
+        vector<size_t> counts(bucketCount, 0);
+        switch (mKernel)
+        {
+#ifdef RECORDS_PAYROLL_X86
+            case Kernel::Avx2:
+                histogramAvx2(columns, lowest, bucketWidth, counts);
+                break;
+            case Kernel::Sse41:
+                histogramSse41(columns, lowest, bucketWidth, counts);
+                break;
+#endif
+            default:
+                histogramScalar(columns, 0, lowest, bucketWidth, counts);
+                break;
+        }
+        return counts;
+    }
+
+    bool PayrollScan::isSupported(Kernel kernel)
+    {
+        switch (kernel)
+        {
+            case Kernel::Scalar:
+                return true;
+#ifdef RECORDS_PAYROLL_X86
+            case Kernel::Sse41:
+                return __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("popcnt");
+            case Kernel::Avx2:
+                return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+            default:
+                return false;
+        }
+    }
+
+    PayrollScan::Kernel PayrollScan::bestKernel()
+    {
+        static const Kernel best = isSupported(Kernel::Avx2) ? Kernel::Avx2
+                                 : isSupported(Kernel::Sse41) ? Kernel::Sse41
+                                 : Kernel::Scalar;
+        return best;
+    }
+
+    const char* PayrollScan::name(Kernel kernel)
+    {
+        switch (kernel)
+        {
+            case Kernel::Sse41:
+                return "SSE4.1";
+            case Kernel::Avx2:
+                return "AVX2";
+            default:
+                return "scalar";
+        }
+    }
+}
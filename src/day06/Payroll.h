@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Records
+{
+    // Which employees a payroll query covers.
+    enum class StatusFilter
+    {
+        Current,
+        Former,
+        All
+    };
+
+    struct PayrollSummary
+    {
+        std::size_t count = 0;
+        // Summed in 64 bits, so it cannot overflow for any roster that fits
+        // in memory.
+        long long total = 0;
+        // Both 0 when count is 0.
+        int minSalary = 0;
+        int maxSalary = 0;
+
+        double mean() const
+        {
+            return count == 0 ? 0.0 : static_cast<double>(total) / static_cast<double>(count);
+        }
+    };
+
+    // Aggregates over a salary array and hired bitmap laid out as in
+    // EmployeeColumns. Each query is one pass over the arrays, eight
+    // salaries at a time with AVX2 or four with SSE4.1 where the CPU has
+    // them (chosen at run time), one at a time otherwise. Every kernel
+    // returns the same results.
+    class PayrollScan
+    {
+        public:
+            enum class Kernel
+            {
+                Scalar,
+                Sse41,
+                Avx2
+            };
+
+            // Bit (slot % 64) of hiredBits[slot / 64] is set while the
+            // employee in that slot is hired. The arrays must outlive the scan.
+            PayrollScan(const int* salaries, const std::uint64_t* hiredBits,
+                        std::size_t count, Kernel kernel = bestKernel());
+
+            PayrollSummary summarize(StatusFilter filter) const;
+            // Number of covered employees earning more than threshold.
+            std::size_t countAbove(int threshold, StatusFilter filter) const;
+            // Counts of covered salaries in bucketCount buckets of
+            // bucketWidth, the first starting at lowest. Salaries below
+            // lowest are counted in the first bucket and those past the end
+            // in the last. Throws invalid_argument unless both are positive.
+            std::vector<std::size_t> histogram(int lowest, int bucketWidth, std::size_t bucketCount,
+                                               StatusFilter filter) const;
+
+            static bool isSupported(Kernel kernel);
+            // The widest kernel this CPU supports.
+            static Kernel bestKernel();
+            static const char* name(Kernel kernel);
+
+        private:
+            const int* mSalaries;
+            const std::uint64_t* mHiredBits;
+            std::size_t mCount;
+            Kernel mKernel;
+    };
+}
@@ -0,0 +1,100 @@
+/*
+ * Payroll queries through each PayrollScan kernel, against a loop over
+ * Employee::getSalary() and isHired().
+ *
+ * Usage: PayrollBenchmark [employees]   (default 10000000)
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Database.h"
+
+using namespace std;
+using namespace Records;
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+
+    Database db(StorageLayout::Columnar);
+    db.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        Employee& employee = db.addEmployee("First" + to_string(i % 1000), "Last" + to_string(i % 5000));
+        employee.setSalary(20000 + static_cast<int>((i * 7919) % 100000));
+        if (i % 3 == 0)
+        {
+            employee.fire();
+        }
+    }
+    const EmployeeColumns& columns = db.getColumns();
+
+    // Repeat small rosters so every measurement covers ~10^8 records.
+    size_t repeats = count >= 100000000 ? 1 : 100000000 / count;
+    auto perEmployee = [&](double nanosPerRepeat) { return nanosPerRepeat / static_cast<double>(count); };
+
+    cout << count << " employees, ns per employee" << endl
+         << setw(10) << "kernel" << setw(12) << "summary" << setw(12) << "above"
+         << setw(12) << "hist 16" << setw(12) << "hist 64" << endl;
+    cout << fixed << setprecision(3);
+
+    {
+        double summary = Bench::nanosPerOp(repeats, [&](size_t) {
+            PayrollSummary result;
+            result.minSalary = INT32_MAX;
+            result.maxSalary = INT32_MIN;
+            for (const Employee& employee : db)
+            {
+                if (employee.isHired())
+                {
+                    ++result.count;
+                    result.total += employee.getSalary();
+                    result.minSalary = min(result.minSalary, employee.getSalary());
+                    result.maxSalary = max(result.maxSalary, employee.getSalary());
+                }
+            }
+            Bench::doNotOptimize(result);
+        });
+        double above = Bench::nanosPerOp(repeats, [&](size_t) {
+            size_t result = 0;
+            for (const Employee& employee : db)
+            {
+                result += employee.isHired() && employee.getSalary() > 75000;
+            }
+            Bench::doNotOptimize(result);
+        });
+        cout << setw(10) << "Employee" << setw(12) << perEmployee(summary)
+             << setw(12) << perEmployee(above) << endl;
+    }
+
+    for (auto kernel : { PayrollScan::Kernel::Scalar, PayrollScan::Kernel::Sse41, PayrollScan::Kernel::Avx2 })
+    {
+        if (!PayrollScan::isSupported(kernel))
+        {
+            cout << setw(10) << PayrollScan::name(kernel) << "  not supported" << endl;
+            continue;
+        }
+        PayrollScan scan(columns.salaries().data(), columns.hiredBits().data(), columns.size(), kernel);
+        double summary = Bench::nanosPerOp(repeats, [&](size_t) {
+            Bench::doNotOptimize(scan.summarize(StatusFilter::Current));
+        });
+        double above = Bench::nanosPerOp(repeats, [&](size_t) {
+            Bench::doNotOptimize(scan.countAbove(75000, StatusFilter::Current));
+        });
+        double histogram16 = Bench::nanosPerOp(repeats, [&](size_t) {
+            Bench::doNotOptimize(scan.histogram(20000, 6250, 16, StatusFilter::Current).back());
+        });
+        double histogram64 = Bench::nanosPerOp(repeats, [&](size_t) {
+            Bench::doNotOptimize(scan.histogram(20000, 1563, 64, StatusFilter::Current).back());
+        });
+        cout << setw(10) << PayrollScan::name(kernel) << setw(12) << perEmployee(summary)
+             << setw(12) << perEmployee(above) << setw(12) << perEmployee(histogram16)
+             << setw(12) << perEmployee(histogram64) << endl;
+    }
+    return 0;
+}
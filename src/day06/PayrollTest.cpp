@@ -0,0 +1,171 @@
+#include <climits>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "Database.h"
+#include "Payroll.h"
+#include "TestHelpers.h"
+
+using namespace std;
+using namespace Records;
+
+/*
+ * Checks every payroll kernel this CPU supports, and the Database queries
+ * in both layouts, against plain loops over getSalary() and isHired().
+ */
+
+static bool covers(const Employee& employee, StatusFilter filter)
+{
+    return filter == StatusFilter::All || employee.isHired() == (filter == StatusFilter::Current);
+}
+
+static PayrollSummary naiveSummary(const Database& db, StatusFilter filter)
+{
+    PayrollSummary summary;
+    for (const Employee& employee : db)
+    {
+        if (covers(employee, filter))
+        {
+            int salary = employee.getSalary();
+            summary.minSalary = summary.count == 0 ? salary : min(summary.minSalary, salary);
+            summary.maxSalary = summary.count == 0 ? salary : max(summary.maxSalary, salary);
+            summary.total += salary;
+            ++summary.count;
+        }
+    }
+    return summary;
+}
+
+static size_t naiveCountAbove(const Database& db, int threshold, StatusFilter filter)
+{
+    size_t count = 0;
+    for (const Employee& employee : db)
+    {
+        count += covers(employee, filter) && employee.getSalary() > threshold;
+    }
+    return count;
+}
+
+static vector<size_t> naiveHistogram(const Database& db, int lowest, int width, size_t buckets,
+                                     StatusFilter filter)
+{
+    vector<size_t> counts(buckets, 0);
+    for (const Employee& employee : db)
+    {
+        if (covers(employee, filter))
+        {
+            long long bucket = (static_cast<long long>(employee.getSalary()) - lowest) / width;
+            if (employee.getSalary() < lowest)
+            {
+                bucket = 0;
+            }
+            ++counts[static_cast<size_t>(min<long long>(bucket, static_cast<long long>(buckets) - 1))];
+        }
+    }
+    return counts;
+}
+
+static bool sameSummary(const PayrollSummary& a, const PayrollSummary& b)
+{
+    return a.count == b.count && a.total == b.total
+        && a.minSalary == b.minSalary && a.maxSalary == b.maxSalary;
+}
+
+static void checkQueries(const Database& db, const vector<int>& salaries,
+                         const vector<uint64_t>& hiredBits)
+{
+    const StatusFilter filters[] = { StatusFilter::Current, StatusFilter::Former, StatusFilter::All };
+    const PayrollScan::Kernel kernels[] = {
+        PayrollScan::Kernel::Scalar, PayrollScan::Kernel::Sse41, PayrollScan::Kernel::Avx2
+    };
+    for (PayrollScan::Kernel kernel : kernels)
+    {
+        if (!PayrollScan::isSupported(kernel))
+        {
+            continue;
+        }
+        PayrollScan scan(salaries.data(), hiredBits.data(), salaries.size(), kernel);
+        for (StatusFilter filter : filters)
+        {
+            CHECK(sameSummary(scan.summarize(filter), naiveSummary(db, filter)));
+            for (int threshold : { INT_MIN, -1, 0, 45000, 99999, INT_MAX })
+            {
+                CHECK(scan.countAbove(threshold, filter) == naiveCountAbove(db, threshold, filter));
+            }
+            CHECK(scan.histogram(20000, 10000, 10, filter) == naiveHistogram(db, 20000, 10000, 10, filter));
+            CHECK(scan.histogram(INT_MIN, INT_MAX, 3, filter) == naiveHistogram(db, INT_MIN, INT_MAX, 3, filter));
+            CHECK(scan.histogram(0, 1000, 200, filter) == naiveHistogram(db, 0, 1000, 200, filter));
+            CHECK(scan.histogram(0, 1, 1, filter) == naiveHistogram(db, 0, 1, 1, filter));
+        }
+    }
+}
+
+int main()
+{
+    cout << "Kernels available: ";
+    for (auto kernel : { PayrollScan::Kernel::Sse41, PayrollScan::Kernel::Avx2 })
+    {
+        cout << PayrollScan::name(kernel) << (PayrollScan::isSupported(kernel) ? " yes  " : " no  ");
+    }
+    cout << endl;
+
+    cout << "Rosters of assorted sizes, with and without partial vectors." << endl;
+    mt19937 rng(7);
+    uniform_int_distribution<int> pickSalary(15000, 120000);
+    for (size_t count : { 0, 1, 3, 4, 7, 8, 9, 63, 64, 65, 127, 200, 10007 })
+    {
+        Database rows;
+        Database columnar(StorageLayout::Columnar);
+        for (size_t i = 0; i < count; ++i)
+        {
+            int salary = pickSalary(rng);
+            bool hired = rng() % 3 != 0;
+            for (Database* db : { &rows, &columnar })
+            {
+                Employee& employee = db->addEmployee("First", "Last");
+                employee.setSalary(salary);
+                if (!hired)
+                {
+                    employee.fire();
+                }
+            }
+        }
+        const EmployeeColumns& columns = columnar.getColumns();
+        checkQueries(rows, columns.salaries(), columns.hiredBits());
+
+        CHECK(sameSummary(rows.getPayroll(), naiveSummary(rows, StatusFilter::Current)));
+        CHECK(sameSummary(columnar.getPayroll(StatusFilter::Former), naiveSummary(rows, StatusFilter::Former)));
+        CHECK(rows.countSalariesAbove(50000) == columnar.countSalariesAbove(50000));
+        CHECK(rows.getSalaryHistogram(0, 25000, 6) == columnar.getSalaryHistogram(0, 25000, 6));
+    }
+
+    cout << "Extreme salaries sum in 64 bits." << endl;
+    {
+        Database db(StorageLayout::Columnar);
+        for (int i = 0; i < 1000; ++i)
+        {
+            db.addEmployee("Rich", "Person").setSalary(i % 2 == 0 ? INT_MAX : INT_MIN + 1);
+        }
+        db.addEmployee("Poor", "Person").setSalary(INT_MIN);
+        const EmployeeColumns& columns = db.getColumns();
+        checkQueries(db, columns.salaries(), columns.hiredBits());
+        PayrollSummary summary = db.getPayroll();
+        CHECK(summary.total == 500LL * INT_MAX + 500LL * (INT_MIN + 1) + INT_MIN);
+        CHECK(summary.minSalary == INT_MIN && summary.maxSalary == INT_MAX);
+    }
+
+    cout << "Empty selections and bad histograms." << endl;
+    {
+        Database db;
+        db.addEmployee("Only", "Current").setSalary(50000);
+        PayrollSummary former = db.getPayroll(StatusFilter::Former);
+        CHECK(former.count == 0 && former.total == 0 && former.mean() == 0.0);
+        CHECK(former.minSalary == 0 && former.maxSalary == 0);
+        CHECK(db.getPayroll().mean() == 50000.0);
+        CHECK_THROWS(db.getSalaryHistogram(0, 0, 4), invalid_argument);
+        CHECK_THROWS(db.getSalaryHistogram(0, 100, 0), invalid_argument);
+    }
+
+    return Testing::testResult();
+}
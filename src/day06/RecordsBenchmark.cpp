@@ -0,0 +1,194 @@
+/*
+ * Google Benchmark suite for the core Database operations over rosters of
+ * 1k to 1M employees: hiring, lookup by number and by name, payroll scans
+ * in both storage layouts, and displayAll.
+ *
+ * Usage: RecordsBenchmark [--benchmark_filter=regex]
+ *                         [--benchmark_out=file --benchmark_out_format=json]
+ *
+ * The benchmark_json build target runs it and keeps the JSON results.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "Database.h"
+
+using namespace std;
+using namespace Records;
+
+namespace
+{
+    const int64_t kSmallestRoster = 1000;
+    const int64_t kLargestRoster = 1000000;
+
+    string firstName(size_t i)
+    {
+        return "First" + to_string(i % 1000);
+    }
+
+    string lastName(size_t i)
+    {
+        return "Last" + to_string(i);
+    }
+
+    // Hires count employees; every tenth one is then fired, so the status
+    // filters have something to skip.
+    void fill(Database& db, size_t count)
+    {
+        db.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Employee& employee = db.addEmployee(firstName(i), lastName(i));
+            employee.setSalary(30000 + static_cast<int>(i % 70000));
+            if (i % 10 == 0)
+            {
+                employee.fire();
+            }
+        }
+    }
+
+    // Points stdout at /dev/null for as long as it lives.
+    class SilencedStdout
+    {
+        public:
+            SilencedStdout()
+            {
+                fflush(stdout);
+                mSaved = ::dup(STDOUT_FILENO);
+                int null = ::open("/dev/null", O_WRONLY);
+                ::dup2(null, STDOUT_FILENO);
+                ::close(null);
+            }
+            ~SilencedStdout()
+            {
+                fflush(stdout);
+                ::dup2(mSaved, STDOUT_FILENO);
+                ::close(mSaved);
+            }
+            SilencedStdout(const SilencedStdout&) = delete;
+            SilencedStdout& operator=(const SilencedStdout&) = delete;
+
+        private:
+            int mSaved;
+    };
+}
+
+static void BM_AddEmployee(benchmark::State& state)
+{
+    size_t count = static_cast<size_t>(state.range(0));
+    vector<pair<string, string>> names;
+    for (size_t i = 0; i < count; ++i)
+    {
+        names.emplace_back(firstName(i), lastName(i));
+    }
+    for (auto _ : state)
+    {
+        Database db;
+        for (const auto& [first, last] : names)
+        {
+            benchmark::DoNotOptimize(&db.addEmployee(first, last));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AddEmployee)->RangeMultiplier(10)->Range(kSmallestRoster, kLargestRoster)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_GetEmployeeByNumber(benchmark::State& state)
+{
+    size_t count = static_cast<size_t>(state.range(0));
+    Database db;
+    fill(db, count);
+    mt19937 rng(1);
+    for (auto _ : state)
+    {
+        int number = kDefaultEmployeeNumber + static_cast<int>(rng() % count);
+        benchmark::DoNotOptimize(db.getEmployee(number).getSalary());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetEmployeeByNumber)->RangeMultiplier(10)->Range(kSmallestRoster, kLargestRoster);
+
+static void BM_GetEmployeeByName(benchmark::State& state)
+{
+    size_t count = static_cast<size_t>(state.range(0));
+    Database db;
+    fill(db, count);
+    // A fixed set of keys, so building strings stays out of the loop.
+    vector<pair<string, string>> keys;
+    mt19937 rng(1);
+    for (size_t i = 0; i < 4096; ++i)
+    {
+        size_t index = rng() % count;
+        keys.emplace_back(firstName(index), lastName(index));
+    }
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        const auto& [first, last] = keys[next++ % keys.size()];
+        benchmark::DoNotOptimize(db.getEmployee(first, last).getSalary());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetEmployeeByName)->RangeMultiplier(10)->Range(kSmallestRoster, kLargestRoster);
+
+// Second argument: 0 for StorageLayout::Rows, 1 for Columnar.
+static void BM_Payroll(benchmark::State& state)
+{
+    size_t count = static_cast<size_t>(state.range(0));
+    Database db(state.range(1) == 0 ? StorageLayout::Rows : StorageLayout::Columnar);
+    fill(db, count);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(db.getPayroll(StatusFilter::Current));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Payroll)->ArgsProduct({ benchmark::CreateRange(kSmallestRoster, kLargestRoster, 10), { 0, 1 } })
+    ->ArgNames({ "employees", "columnar" });
+
+// Walks every record the way reports and exports do.
+static void BM_IterateRoster(benchmark::State& state)
+{
+    size_t count = static_cast<size_t>(state.range(0));
+    Database db;
+    fill(db, count);
+    for (auto _ : state)
+    {
+        long long total = 0;
+        for (const Employee& employee : db)
+        {
+            total += employee.getSalary();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IterateRoster)->RangeMultiplier(10)->Range(kSmallestRoster, kLargestRoster);
+
+static void BM_DisplayAll(benchmark::State& state)
+{
+    size_t count = static_cast<size_t>(state.range(0));
+    Database db;
+    fill(db, count);
+    SilencedStdout silenced;
+    for (auto _ : state)
+    {
+        db.displayAll();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DisplayAll)->RangeMultiplier(10)->Range(kSmallestRoster, kLargestRoster)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
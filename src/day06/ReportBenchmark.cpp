@@ -0,0 +1,90 @@
+/*
+ * Dumps a roster to /dev/null with the old per-field `<< endl` display code
+ * and with ReportWriter.
+ *
+ * Usage: ReportBenchmark [employees]   (default 1000000)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "Benchmark.h"
+#include "Database.h"
+#include "ReportWriter.h"
+
+using namespace std;
+using namespace Records;
+
+// What Employee::display() did before ReportWriter, aimed at any stream.
+static void displayWithEndl(ostream& out, const Employee& employee)
+{
+    out << "Employee: " << employee.getLastName() << ", " << employee.getFirstName() << endl;
+    out << "------------------------------" << endl;
+    out << (employee.isHired() ? "Current Employee" : "Former Employee") << endl;
+    out << "Employee Number: " << employee.getEmployeeNumber() << endl;
+    out << "Salary: $" << employee.getSalary() << endl;
+    out << endl;
+}
+
+template <typename Fn>
+static double seconds(Fn&& fn)
+{
+    auto start = Bench::Clock::now();
+    fn();
+    chrono::duration<double> elapsed = Bench::Clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+
+    Database db;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Employee& employee = db.addEmployee("First" + to_string(i % 3000),
+                                            "Last" + to_string(i % 40000));
+        employee.setSalary(30000 + static_cast<int>(i % 70000));
+        if (i % 4 == 0)
+        {
+            employee.fire();
+        }
+    }
+    int first = kDefaultEmployeeNumber;
+    int last = kDefaultEmployeeNumber + static_cast<int>(count);
+
+    double endlSeconds = seconds([&] {
+        ofstream out("/dev/null");
+        for (int number = first; number < last; ++number)
+        {
+            displayWithEndl(out, db.getEmployee(number));
+        }
+    });
+
+    double writerSeconds = seconds([&] {
+        FILE* out = fopen("/dev/null", "w");
+        {
+            ReportWriter writer(out);
+            for (int number = first; number < last; ++number)
+            {
+                writer.write(db.getEmployee(number));
+            }
+        }
+        fclose(out);
+    });
+
+    auto report = [&](const char* name, double elapsed) {
+        cout << setw(18) << name << setw(10) << fixed << setprecision(3) << elapsed << " s"
+             << setw(14) << setprecision(0) << static_cast<double>(count) / elapsed
+             << " records/s" << endl;
+    };
+    cout << "employees: " << count << endl;
+    report("iostream + endl", endlSeconds);
+    report("ReportWriter", writerSeconds);
+    return 0;
+}
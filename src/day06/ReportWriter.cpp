@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+#include "ReportWriter.h"
+
+using namespace std;
+
+namespace Records
+{
+    ReportWriter::ReportWriter(FILE* out, size_t batchBytes)
+        : mOut(out), mBatchBytes(batchBytes), mBuffer(batchBytes + 256)
+    {
+    }
+
+    ReportWriter::~ReportWriter()
+    {
+        try
+        {
+            flush();
+        }
+        catch (const runtime_error&)
+        {
+            // Nowhere to report it from a destructor; the stream keeps its
+            // error flag for the caller to inspect.
+        }
+    }
+
+    void ReportWriter::write(const Employee& employee)
+    {
+        append("Employee: ");
+        append(employee.getLastName());
+        append(", ");
+        append(employee.getFirstName());
+        append("\n------------------------------\n");
+        append(employee.isHired() ? "Current Employee\n" : "Former Employee\n");
+        append("Employee Number: ");
+        append(employee.getEmployeeNumber());
+        append("\nSalary: $");
+        append(employee.getSalary());
+        append("\n\n");
+        endRecord();
+    }
+
+    void ReportWriter::endRecord()
+    {
+        if (mUsed >= mBatchBytes)
+        {
+            flush();
+        }
+    }
+
+    void ReportWriter::append(string_view text)
+    {
+        memcpy(reserve(text.size()), text.data(), text.size());
+        mUsed += text.size();
+    }
+
+    void ReportWriter::append(long long value)
+    {
+        char* first = reserve(24);
+        auto result = to_chars(first, first + 24, value);
+        mUsed += static_cast<size_t>(result.ptr - first);
+    }
+
+    void ReportWriter::flush()
+    {
+        if (mUsed == 0)
+        {
+            return;
+        }
+        size_t pending = mUsed;
+        mUsed = 0;
+        if (fwrite(mBuffer.data(), 1, pending, mOut) != pending || fflush(mOut) != 0)
+        {
+            throw runtime_error("Unable to write report.");
+        }
+    }
+
+    char* ReportWriter::reserve(size_t bytes)
+    {
+        if (mUsed + bytes > mBuffer.size())
+        {
+            mBuffer.resize(max(mBuffer.size() * 2, mUsed + bytes));
+        }
+        return mBuffer.data() + mUsed;
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include "Employee.h"
+
+namespace Records
+{
+    // Formats employee reports into a reusable buffer and hands it to the
+    // output in one large write per batch. Numbers go through std::to_chars,
+    // so there is no locale or iostream formatting on the hot path, and
+    // nothing is flushed per line.
+    //
+    // Output goes through the C stdio stream, so it stays ordered with
+    // std::cout as long as cout is synchronized with stdio (the default).
+    class ReportWriter
+    {
+        public:
+            static constexpr std::size_t kDefaultBatchBytes = std::size_t{1} << 16;
+
+            // A batchBytes of 0 writes each record as soon as it ends.
+            explicit ReportWriter(std::FILE* out = stdout,
+                                  std::size_t batchBytes = kDefaultBatchBytes);
+            // Flushes whatever is still buffered.
+            ~ReportWriter();
+            ReportWriter(const ReportWriter&) = delete;
+            ReportWriter& operator=(const ReportWriter&) = delete;
+
+            // Appends the block Employee::display() prints for this employee.
+            void write(const Employee& employee);
+
+            void append(std::string_view text);
+            void append(long long value);
+            // Call between records built from append(): writes the batch
+            // once it reaches batchBytes, as write() does.
+            void endRecord();
+
+            // Writes the buffered batch now. Throws runtime_error if the
+            // stream rejects it.
+            void flush();
+
+        private:
+            char* reserve(std::size_t bytes);
+
+            std::FILE* mOut;
+            std::size_t mBatchBytes;
+            std::vector<char> mBuffer;
+            std::size_t mUsed = 0;
+    };
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "RosterCounters.h"
+
+using namespace std;
+
+namespace Records
+{
+    RosterCounters::RosterCounters(int lowest, int bucketWidth, size_t bucketCount)
+        : mLowest(lowest), mBucketWidth(bucketWidth)
+    {
+        if (bucketWidth <= 0 || bucketCount == 0)
+        {
+            throw invalid_argument("Salary buckets need a positive width and count.");
+        }
+        mBuckets[0].assign(bucketCount, 0);
+        mBuckets[1].assign(bucketCount, 0);
+    }
+
+    void RosterCounters::add(int salary, bool hired)
+    {
+        ++mHeadcount[hired];
+        mPayroll[hired] += salary;
+        ++mBuckets[hired][bucketOf(salary)];
+    }
+
+    void RosterCounters::remove(int salary, bool hired)
+    {
+        --mHeadcount[hired];
+        mPayroll[hired] -= salary;
+        --mBuckets[hired][bucketOf(salary)];
+    }
+
+    void RosterCounters::merge(const RosterCounters& other)
+    {
+        if (other.mLowest != mLowest || other.mBucketWidth != mBucketWidth
+            || other.getBucketCount() != getBucketCount())
+        {
+            throw invalid_argument("Salary buckets differ.");
+        }
+        for (int hired = 0; hired < 2; ++hired)
+        {
+            mHeadcount[hired] += other.mHeadcount[hired];
+            mPayroll[hired] += other.mPayroll[hired];
+            for (size_t bucket = 0; bucket < getBucketCount(); ++bucket)
+            {
+                mBuckets[hired][bucket] += other.mBuckets[hired][bucket];
+            }
+        }
+    }
+
+    size_t RosterCounters::headcount(StatusFilter filter) const
+    {
+        switch (filter)
+        {
+            case StatusFilter::Current:
+                return mHeadcount[1];
+            case StatusFilter::Former:
+                return mHeadcount[0];
+            default:
+                return mHeadcount[0] + mHeadcount[1];
+        }
+    }
+
+    long long RosterCounters::payroll(StatusFilter filter) const
+    {
+        switch (filter)
+        {
+            case StatusFilter::Current:
+                return mPayroll[1];
+            case StatusFilter::Former:
+                return mPayroll[0];
+            default:
+                return mPayroll[0] + mPayroll[1];
+        }
+    }
+
+    double RosterCounters::meanSalary(StatusFilter filter) const
+    {
+        size_t count = headcount(filter);
+        return count == 0 ? 0.0 : static_cast<double>(payroll(filter)) / static_cast<double>(count);
+    }
+
+    size_t RosterCounters::bucketEmployees(size_t bucket, StatusFilter filter) const
+    {
+        switch (filter)
+        {
+            case StatusFilter::Current:
+                return mBuckets[1].at(bucket);
+            case StatusFilter::Former:
+                return mBuckets[0].at(bucket);
+            default:
+                return mBuckets[0].at(bucket) + mBuckets[1].at(bucket);
+        }
+    }
+
+    size_t RosterCounters::bucketOf(int salary) const
+    {
+        long long offset = static_cast<long long>(salary) - mLowest;
+        if (offset < 0)
+        {
+            return 0;
+        }
+        return min(static_cast<size_t>(offset / mBucketWidth), getBucketCount() - 1);
+    }
+}
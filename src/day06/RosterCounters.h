@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Payroll.h"
+
+namespace Records
+{
+    // Running headcount, payroll and salary-bucket counts for a roster,
+    // kept separately for current and former employees. The owner reports
+    // every employee as added and, around each salary or status change,
+    // removed and added again; every read is then O(1).
+    class RosterCounters
+    {
+        public:
+            // Buckets are laid out as in PayrollScan::histogram: bucketCount
+            // buckets of bucketWidth from lowest, with salaries below lowest
+            // counted in the first and those past the end in the last.
+            // Throws invalid_argument unless both are positive.
+            explicit RosterCounters(int lowest = 0, int bucketWidth = 10000,
+                                    std::size_t bucketCount = 20);
+
+            void add(int salary, bool hired);
+            void remove(int salary, bool hired);
+            // Adds other's counts to these. Both must use the same buckets.
+            void merge(const RosterCounters& other);
+
+            std::size_t headcount(StatusFilter filter) const;
+            long long payroll(StatusFilter filter) const;
+            // 0 when the headcount is 0.
+            double meanSalary(StatusFilter filter) const;
+            std::size_t bucketEmployees(std::size_t bucket, StatusFilter filter) const;
+
+            int getLowest() const { return mLowest; }
+            int getBucketWidth() const { return mBucketWidth; }
+            std::size_t getBucketCount() const { return mBuckets[0].size(); }
+            std::size_t bucketOf(int salary) const;
+
+        private:
+            int mLowest;
+            int mBucketWidth;
+            // Index 1 holds current employees, index 0 former ones.
+            std::size_t mHeadcount[2] = { 0, 0 };
+            long long mPayroll[2] = { 0, 0 };
+            std::vector<std::size_t> mBuckets[2];
+    };
+}
@@ -0,0 +1,126 @@
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include "ConcurrentDatabase.h"
+#include "Database.h"
+#include "TestHelpers.h"
+
+using namespace std;
+using namespace Records;
+
+/*
+ * Drives a database through random hires, firings and salary changes and
+ * checks its running counters against a recount from scratch.
+ */
+
+static bool matchesRecount(const Database& db)
+{
+    const RosterCounters& counters = db.getCounters();
+    RosterCounters recount(counters.getLowest(), counters.getBucketWidth(), counters.getBucketCount());
+    for (const Employee& employee : db)
+    {
+        recount.add(employee.getSalary(), employee.isHired());
+    }
+    for (StatusFilter filter : { StatusFilter::Current, StatusFilter::Former, StatusFilter::All })
+    {
+        if (counters.headcount(filter) != recount.headcount(filter)
+            || counters.payroll(filter) != recount.payroll(filter)
+            || counters.meanSalary(filter) != recount.meanSalary(filter))
+        {
+            return false;
+        }
+        for (size_t bucket = 0; bucket < counters.getBucketCount(); ++bucket)
+        {
+            if (counters.bucketEmployees(bucket, filter) != recount.bucketEmployees(bucket, filter))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    cout << "A new roster." << endl;
+    Database db;
+    CHECK(db.getCounters().headcount(StatusFilter::All) == 0);
+    CHECK(db.getCounters().meanSalary(StatusFilter::Current) == 0.0);
+    Employee& greg = db.addEmployee("Greg", "Wallis");
+    Employee& marc = db.addEmployee("Marc", "White");
+    marc.setSalary(100000);
+    greg.fire();
+    const RosterCounters& counters = db.getCounters();
+    CHECK(counters.headcount(StatusFilter::Current) == 1);
+    CHECK(counters.headcount(StatusFilter::Former) == 1);
+    CHECK(counters.payroll(StatusFilter::All) == 130000);
+    CHECK(counters.meanSalary(StatusFilter::Current) == 100000.0);
+    CHECK(counters.bucketEmployees(3, StatusFilter::Former) == 1);
+    CHECK(counters.bucketEmployees(10, StatusFilter::Current) == 1);
+    CHECK_THROWS(counters.bucketEmployees(20, StatusFilter::All), out_of_range);
+
+    cout << "Random changes." << endl;
+    mt19937 rng(5);
+    for (int round = 0; round < 20000; ++round)
+    {
+        int number = kDefaultEmployeeNumber + static_cast<int>(rng() % db.size());
+        switch (rng() % 6)
+        {
+            case 0:
+                db.addEmployee("New", "Hire").setSalary(static_cast<int>(rng() % 300000) - 10000);
+                break;
+            case 1:
+                db.getEmployee(number).fire();
+                break;
+            case 2:
+                db.getEmployee(number).hire();
+                break;
+            case 3:
+                db.getEmployee(number).promote(static_cast<int>(rng() % 5000));
+                break;
+            case 4:
+                db.getEmployee(number).demote(static_cast<int>(rng() % 5000));
+                break;
+            default:
+                db.adjustSalaries([](const Employee& e) { return e.getSalary() > 200000; }, -1.0);
+                break;
+        }
+        if (round % 2000 == 0)
+        {
+            CHECK(matchesRecount(db));
+        }
+    }
+    CHECK(matchesRecount(db));
+    db.setSalaryBuckets(-50000, 25000, 16);
+    CHECK(db.getCounters().getBucketCount() == 16);
+    CHECK(matchesRecount(db));
+    CHECK_THROWS(db.setSalaryBuckets(0, 0, 4), invalid_argument);
+
+    cout << "Loaded rosters are counted." << endl;
+    db.saveSnapshot("counters.snapshot");
+    Database loaded;
+    loaded.loadSnapshot("counters.snapshot");
+    remove("counters.snapshot");
+    CHECK(loaded.getCounters().payroll(StatusFilter::Current) == db.getCounters().payroll(StatusFilter::Current));
+    CHECK(matchesRecount(loaded));
+
+    cout << "Shards add up." << endl;
+    ConcurrentDatabase shards(4);
+    for (int i = 0; i < 100; ++i)
+    {
+        int number = shards.addEmployee("Shard", "Member");
+        shards.setSalary(number, 1000 * i);
+        if (i % 4 == 0)
+        {
+            shards.fire(number);
+        }
+    }
+    RosterCounters total = shards.getCounters();
+    CHECK(total.headcount(StatusFilter::Current) == 75);
+    CHECK(total.payroll(StatusFilter::All) == 1000LL * 99 * 100 / 2);
+    shards.setSalaryBuckets(0, 50000, 2);
+    CHECK(shards.getCounters().bucketEmployees(1, StatusFilter::All) == 50);
+
+    return Testing::testResult();
+}
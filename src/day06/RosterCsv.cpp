@@ -0,0 +1,495 @@
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Database.h"
+#include "NamePool.h"
+#include "ReportWriter.h"
+#include "RosterCsv.h"
+
+using namespace std;
+
+namespace Records
+{
+    namespace
+    {
+        const size_t kColumnCount = 5;
+        const char kHeaderColumns[kColumnCount][16] = {
+            "employee_number", "first_name", "last_name", "salary", "hired"
+        };
+
+        runtime_error csvError(const string& path, size_t offset, const string& problem)
+        {
+            return runtime_error(path + ": byte " + to_string(offset) + ": " + problem);
+        }
+
+        struct CsvRow
+        {
+            // Byte offset of the line in the file, for error messages.
+            size_t offset;
+            bool hasNumber;
+            int employeeNumber;
+            int salary;
+            bool hired;
+            NameId firstName;
+            NameId lastName;
+        };
+
+        // Turns the lines of one chunk into CsvRows. Each parsing thread
+        // owns one, so its name cache needs no lock: it maps the raw text
+        // of a name field, a view into the mapped file, to the interned id,
+        // and most rows resolve both names without touching the NamePool.
+        class ChunkParser
+        {
+            public:
+                ChunkParser(const char* data, const string& path, char delimiter)
+                    : mData(data), mPath(path), mDelimiter(delimiter)
+                {
+                }
+
+                void parse(size_t begin, size_t end, vector<CsvRow>& rows)
+                {
+                    size_t lineStart = begin;
+                    while (lineStart < end)
+                    {
+                        const void* newline = memchr(mData + lineStart, '\n', end - lineStart);
+                        size_t lineEnd = newline != nullptr
+                            ? static_cast<size_t>(static_cast<const char*>(newline) - mData)
+                            : end;
+                        string_view line(mData + lineStart, lineEnd - lineStart);
+                        if (!line.empty() && line.back() == '\r')
+                        {
+                            line.remove_suffix(1);
+                        }
+                        if (!line.empty())
+                        {
+                            rows.push_back(parseLine(line, lineStart));
+                        }
+                        lineStart = lineEnd + 1;
+                    }
+                }
+
+            private:
+                CsvRow parseLine(string_view line, size_t offset)
+                {
+                    string_view fields[kColumnCount];
+                    size_t count = 0;
+                    for (;;)
+                    {
+                        if (count == kColumnCount)
+                        {
+                            throw csvError(mPath, offset, "too many fields");
+                        }
+                        fields[count++] = splitField(line, offset);
+                        if (line.empty())
+                        {
+                            break;
+                        }
+                        line.remove_prefix(1);
+                    }
+                    if (count != kColumnCount)
+                    {
+                        throw csvError(mPath, offset, "expected 5 fields");
+                    }
+
+                    CsvRow row;
+                    row.offset = offset;
+                    row.hasNumber = !fields[0].empty();
+                    row.employeeNumber = row.hasNumber ? parseInt(fields[0], offset, "employee number") : 0;
+                    row.firstName = internName(fields[1]);
+                    row.lastName = internName(fields[2]);
+                    row.salary = parseInt(fields[3], offset, "salary");
+                    string_view hired = unquote(fields[4]);
+                    if (hired != "1" && hired != "0")
+                    {
+                        throw csvError(mPath, offset, "hired must be 1 or 0");
+                    }
+                    row.hired = hired == "1";
+                    return row;
+                }
+
+                // Removes the next field from the front of line, leaving line
+                // empty or starting at the delimiter that follows it. Quoted
+                // fields are returned with their quotes.
+                string_view splitField(string_view& line, size_t offset)
+                {
+                    size_t length;
+                    if (!line.empty() && line.front() == '"')
+                    {
+                        size_t quote = line.find('"', 1);
+                        // A doubled quote is part of the text.
+                        while (quote != string_view::npos && quote + 1 < line.size() && line[quote + 1] == '"')
+                        {
+                            quote = line.find('"', quote + 2);
+                        }
+                        if (quote == string_view::npos)
+                        {
+                            throw csvError(mPath, offset, "unterminated quoted field");
+                        }
+                        length = quote + 1;
+                        if (length < line.size() && line[length] != mDelimiter)
+                        {
+                            throw csvError(mPath, offset, "text after a quoted field");
+                        }
+                    }
+                    else
+                    {
+                        length = min(line.find(mDelimiter), line.size());
+                    }
+                    string_view field = line.substr(0, length);
+                    line.remove_prefix(length);
+                    return field;
+                }
+
+                // Text of a field without its quoting. Only fields with
+                // doubled quotes are copied, into scratch space that the next
+                // call reuses.
+                string_view unquote(string_view field)
+                {
+                    if (field.empty() || field.front() != '"')
+                    {
+                        return field;
+                    }
+                    string_view text = field.substr(1, field.size() - 2);
+                    if (text.find('"') == string_view::npos)
+                    {
+                        return text;
+                    }
+                    mScratch.clear();
+                    for (size_t i = 0; i < text.size(); ++i)
+                    {
+                        mScratch.push_back(text[i]);
+                        if (text[i] == '"')
+                        {
+                            ++i;
+                        }
+                    }
+                    return mScratch;
+                }
+
+                NameId internName(string_view field)
+                {
+                    auto found = mNames.find(field);
+                    if (found != mNames.end())
+                    {
+                        return found->second;
+                    }
+                    NameId id = NamePool::global().intern(unquote(field));
+                    mNames.emplace(field, id);
+                    return id;
+                }
+
+                int parseInt(string_view field, size_t offset, const char* what)
+                {
+                    string_view text = unquote(field);
+                    int value = 0;
+                    auto result = from_chars(text.data(), text.data() + text.size(), value);
+                    if (text.empty() || result.ec != errc() || result.ptr != text.data() + text.size())
+                    {
+                        throw csvError(mPath, offset, string("bad ") + what);
+                    }
+                    return value;
+                }
+
+                const char* mData;
+                const string& mPath;
+                char mDelimiter;
+                unordered_map<string_view, NameId> mNames;
+                string mScratch;
+        };
+
+        void addRow(Database& db, const CsvRow& row, const string& path)
+        {
+            if (!row.hasNumber)
+            {
+                NamePool& pool = NamePool::global();
+                Employee& employee = db.addEmployee(pool.view(row.firstName), pool.view(row.lastName));
+                employee.setSalary(row.salary);
+                if (!row.hired)
+                {
+                    employee.fire();
+                }
+                return;
+            }
+            Employee employee(row.firstName, row.lastName);
+            employee.setEmployeeNumber(row.employeeNumber);
+            employee.setSalary(row.salary);
+            if (row.hired)
+            {
+                employee.hire();
+            }
+            try
+            {
+                db.insertEmployee(employee);
+            }
+            catch (const logic_error& e)
+            {
+                throw csvError(path, row.offset, e.what());
+            }
+        }
+
+        // Throws unless line names the columns in order, as exportCsv
+        // writes them, so that a file without a header is not read as one
+        // and its first employee dropped.
+        void checkHeader(string_view line, char delimiter, const string& path)
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+            for (size_t column = 0; column < kColumnCount; ++column)
+            {
+                size_t length = min(line.find(delimiter), line.size());
+                string_view name = line.substr(0, length);
+                if (name.size() >= 2 && name.front() == '"' && name.back() == '"')
+                {
+                    name = name.substr(1, name.size() - 2);
+                }
+                // Every column but the last is followed by a delimiter.
+                bool last = column + 1 == kColumnCount;
+                if (name != kHeaderColumns[column] || last != (length == line.size()))
+                {
+                    throw csvError(path, 0, "first line is not the column header");
+                }
+                line.remove_prefix(min(length + 1, line.size()));
+            }
+        }
+
+        void writeField(ReportWriter& writer, string_view text, char delimiter, const string& path)
+        {
+            if (text.find_first_of("\r\n") != string_view::npos)
+            {
+                throw runtime_error(path + ": line break in name \"" + string(text) + "\"");
+            }
+            bool quoted = text.find(delimiter) != string_view::npos
+                          || text.find('"') != string_view::npos;
+            if (!quoted)
+            {
+                writer.append(text);
+                return;
+            }
+            writer.append("\"");
+            for (size_t quote; (quote = text.find('"')) != string_view::npos; )
+            {
+                writer.append(text.substr(0, quote + 1));
+                writer.append("\"");
+                text.remove_prefix(quote + 1);
+            }
+            writer.append(text);
+            writer.append("\"");
+        }
+    }
+
+    size_t importCsv(Database& db, const string& path, const CsvOptions& options)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw runtime_error(path + ": " + strerror(errno));
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            throw runtime_error(path + ": " + strerror(errno));
+        }
+        size_t fileBytes = static_cast<size_t>(info.st_size);
+        if (fileBytes == 0)
+        {
+            ::close(fd);
+            return 0;
+        }
+        void* mapping = ::mmap(nullptr, fileBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            throw runtime_error(path + ": " + strerror(errno));
+        }
+        ::madvise(mapping, fileBytes, MADV_SEQUENTIAL);
+        const char* data = static_cast<const char*>(mapping);
+
+        // Chunk boundaries: every chunk ends just after a newline, or at the
+        // end of the file. Finding them touches one page per chunk.
+        size_t start = 0;
+        if (options.header)
+        {
+            const void* newline = memchr(data, '\n', fileBytes);
+            size_t lineEnd = newline != nullptr ? static_cast<size_t>(static_cast<const char*>(newline) - data)
+                                                : fileBytes;
+            try
+            {
+                checkHeader(string_view(data, lineEnd), options.delimiter, path);
+            }
+            catch (...)
+            {
+                ::munmap(mapping, fileBytes);
+                throw;
+            }
+            start = min(lineEnd + 1, fileBytes);
+        }
+        size_t chunkBytes = max<size_t>(options.chunkBytes, 1);
+        vector<size_t> bounds{ start };
+        while (bounds.back() < fileBytes)
+        {
+            size_t end = bounds.back() + chunkBytes;
+            if (end >= fileBytes)
+            {
+                end = fileBytes;
+            }
+            else
+            {
+                const void* newline = memchr(data + end - 1, '\n', fileBytes - end + 1);
+                end = newline != nullptr ? static_cast<size_t>(static_cast<const char*>(newline) - data) + 1
+                                         : fileBytes;
+            }
+            bounds.push_back(end);
+        }
+        size_t chunkCount = bounds.size() - 1;
+
+        unsigned threads = options.threads != 0 ? options.threads : thread::hardware_concurrency();
+        threads = static_cast<unsigned>(min<size_t>(max(threads, 1u), max<size_t>(chunkCount, 1)));
+        vector<ChunkParser> parsers(threads, ChunkParser(data, path, options.delimiter));
+        vector<vector<CsvRow>> rows(threads);
+        vector<exception_ptr> errors(threads);
+
+        size_t imported = 0;
+        size_t reserved = 0;
+        try
+        {
+            // Chunks are parsed a wave at a time, one per thread, and added
+            // to db in file order before the next wave starts, so memory
+            // use is bounded by the wave rather than the file.
+            for (size_t first = 0; first < chunkCount; first += threads)
+            {
+                size_t wave = min<size_t>(threads, chunkCount - first);
+                auto parseChunk = [&](size_t i) {
+                    try
+                    {
+                        rows[i].clear();
+                        parsers[i].parse(bounds[first + i], bounds[first + i + 1], rows[i]);
+                    }
+                    catch (...)
+                    {
+                        errors[i] = current_exception();
+                    }
+                };
+                vector<thread> workers;
+                for (size_t i = 1; i < wave; ++i)
+                {
+                    workers.emplace_back(parseChunk, i);
+                }
+                parseChunk(0);
+                for (auto& worker : workers)
+                {
+                    worker.join();
+                }
+
+                size_t waveRows = 0;
+                for (size_t i = 0; i < wave; ++i)
+                {
+                    waveRows += rows[i].size();
+                }
+                // reserve() sizes the hot tier, so archived employees
+                // do not count.
+                size_t needed = db.size() - db.archivedCount() + waveRows;
+                if (needed > reserved)
+                {
+                    // Size storage and indexes for the rest of the file too,
+                    // extrapolated from the rows per byte seen so far, so
+                    // they are not regrown on every wave.
+                    size_t parsed = bounds[first + wave] - start;
+                    size_t rowsLeft = static_cast<size_t>(static_cast<double>(imported + waveRows)
+                                                          * static_cast<double>(fileBytes - start - parsed)
+                                                          / static_cast<double>(parsed));
+                    reserved = needed + rowsLeft + rowsLeft / 16;
+                    db.reserve(reserved);
+                }
+                for (size_t i = 0; i < wave; ++i)
+                {
+                    for (const CsvRow& row : rows[i])
+                    {
+                        addRow(db, row, path);
+                        ++imported;
+                    }
+                    if (errors[i])
+                    {
+                        rethrow_exception(errors[i]);
+                    }
+                }
+                // Parsed pages will not be read again.
+                size_t consumed = bounds[first + wave] & ~static_cast<size_t>(sysconf(_SC_PAGESIZE) - 1);
+                ::madvise(mapping, consumed, MADV_DONTNEED);
+            }
+        }
+        catch (...)
+        {
+            ::munmap(mapping, fileBytes);
+            throw;
+        }
+        ::munmap(mapping, fileBytes);
+        return imported;
+    }
+
+    void exportCsv(const Database& db, const string& path, const CsvOptions& options)
+    {
+        FILE* out = fopen(path.c_str(), "wb");
+        if (out == nullptr)
+        {
+            throw runtime_error(path + ": " + strerror(errno));
+        }
+        try
+        {
+            ReportWriter writer(out);
+            const char delimiter[] = { options.delimiter, '\0' };
+            if (options.header)
+            {
+                for (size_t column = 0; column < kColumnCount; ++column)
+                {
+                    writer.append(column == 0 ? "" : delimiter);
+                    writer.append(kHeaderColumns[column]);
+                }
+                writer.append("\n");
+            }
+            auto writeRow = [&](const Employee& employee) {
+                writer.append(employee.getEmployeeNumber());
+                writer.append(delimiter);
+                writeField(writer, employee.getFirstName(), options.delimiter, path);
+                writer.append(delimiter);
+                writeField(writer, employee.getLastName(), options.delimiter, path);
+                writer.append(delimiter);
+                writer.append(employee.getSalary());
+                writer.append(delimiter);
+                writer.append(employee.isHired() ? "1\n" : "0\n");
+                writer.endRecord();
+            };
+            for (const Employee& employee : db)
+            {
+                writeRow(employee);
+            }
+            db.forEachArchived(writeRow);
+            writer.flush();
+        }
+        catch (...)
+        {
+            fclose(out);
+            throw;
+        }
+        if (fclose(out) != 0)
+        {
+            throw runtime_error(path + ": " + strerror(errno));
+        }
+    }
+}
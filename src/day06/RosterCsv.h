@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Records
+{
+    class Database;
+
+    // Roster files hold one employee per line in the columns
+    //
+    //   employee_number, first_name, last_name, salary, hired
+    //
+    // with hired written as 1 or 0. Fields containing the delimiter or a
+    // quote are quoted, with embedded quotes doubled. Line breaks are not
+    // allowed inside fields: every newline ends a record, which is what lets
+    // the importer split a file into chunks without reading it first.
+    struct CsvOptions
+    {
+        // ',' for CSV, '\t' for TSV.
+        char delimiter = ',';
+        // Whether the first line is a column header. The importer checks
+        // that it names the columns above, in order.
+        bool header = true;
+        // The importer parses the file in pieces of about this size, each
+        // extended to the end of its last line.
+        std::size_t chunkBytes = std::size_t{4} << 20;
+        // Threads parsing chunks; 0 means one per hardware thread.
+        unsigned threads = 0;
+    };
+
+    // Adds every employee in the file at path to db and returns how many
+    // were read. Rows keep their employee number; a row with an empty
+    // number is hired through addEmployee and gets the next free one.
+    //
+    // The file is memory-mapped and parsed in chunks on several threads,
+    // reading names in place rather than copying each field into a string.
+    // Records are then added in file order on the calling thread.
+    //
+    // Throws runtime_error, naming the byte offset of the offending line,
+    // if the file cannot be read, the expected header is missing, a line is
+    // malformed or an employee number is repeated. Rows before that line
+    // have already been added.
+    std::size_t importCsv(Database& db, const std::string& path,
+                          const CsvOptions& options = CsvOptions());
+
+    // Writes every employee in db to path: the hot tier in the order the
+    // employees were added, then the archive.
+    // Throws runtime_error if the file cannot be written or a name
+    // contains a line break.
+    void exportCsv(const Database& db, const std::string& path,
+                   const CsvOptions& options = CsvOptions());
+}
@@ -0,0 +1,76 @@
+/*
+ * An annual review: a raise for half the roster through getEmployee and
+ * promote one at a time, against one Database::adjustSalaries batch.
+ *
+ * Usage: SalaryAdjustmentBenchmark [employees]   (default 1000000)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Database.h"
+
+using namespace std;
+using namespace Records;
+
+template <typename Fn>
+static double seconds(Fn&& fn)
+{
+    auto start = Bench::Clock::now();
+    fn();
+    chrono::duration<double> elapsed = Bench::Clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+
+    Database db;
+    db.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        db.addEmployee("First" + to_string(i % 1000), "Last" + to_string(i % 5000));
+    }
+    vector<SalaryAdjustment> raises;
+    for (size_t i = 0; i < count; i += 2)
+    {
+        raises.push_back({ kDefaultEmployeeNumber + static_cast<int>(i), 1000 });
+    }
+    shuffle(raises.begin(), raises.end(), mt19937(1));
+
+    cout << count << " employees, " << raises.size() << " raises" << endl << fixed << setprecision(1);
+
+    double oneByOne = seconds([&] {
+        for (const auto& raise : raises)
+        {
+            db.getEmployee(raise.employeeNumber).promote(raise.delta);
+        }
+    });
+    cout << setw(28) << "getEmployee + promote" << setw(10) << oneByOne * 1e3 << " ms" << endl;
+
+    unsigned hardware = max(thread::hardware_concurrency(), 1u);
+    for (unsigned threads = 1; ; threads *= 2)
+    {
+        threads = min(threads, hardware);
+        double batch = seconds([&] { db.adjustSalaries(raises, threads); });
+        double percent = seconds([&] {
+            db.adjustSalaries([](const Employee& e) { return e.getEmployeeNumber() % 2 == 0; }, 3.0, threads);
+        });
+        cout << setw(20) << "adjustSalaries x" << setw(2) << left << threads << right
+             << setw(12) << batch * 1e3 << " ms   by predicate " << percent * 1e3 << " ms" << endl;
+        if (threads == hardware)
+        {
+            break;
+        }
+    }
+    return 0;
+}
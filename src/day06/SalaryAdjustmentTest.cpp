@@ -0,0 +1,147 @@
+#include <climits>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "Database.h"
+#include "TestHelpers.h"
+#include "WriteAheadLog.h"
+
+using namespace std;
+using namespace Records;
+
+/*
+ * Database::adjustSalaries: batches by number and by predicate, serial and
+ * threaded, and batches that must leave every salary as it was.
+ */
+
+static void buildRoster(Database& db)
+{
+    for (int i = 0; i < 1000; ++i)
+    {
+        Employee& employee = db.addEmployee("First" + to_string(i % 10), "Last" + to_string(i));
+        employee.setSalary(40000 + i);
+        if (i % 4 == 0)
+        {
+            employee.fire();
+        }
+    }
+}
+
+static vector<int> salariesOf(const Database& db)
+{
+    vector<int> salaries;
+    for (const Employee& employee : db)
+    {
+        salaries.push_back(employee.getSalary());
+    }
+    return salaries;
+}
+
+int main()
+{
+    for (unsigned threads : { 1u, 4u })
+    {
+        cout << "Adjusting with " << threads << " thread(s)." << endl;
+
+        Database db(StorageLayout::Columnar);
+        buildRoster(db);
+        vector<SalaryAdjustment> raises;
+        for (int i = 0; i < 1000; i += 2)
+        {
+            raises.push_back({ kDefaultEmployeeNumber + i, 1000 });
+        }
+        // Deltas for one employee add up.
+        raises.push_back({ kDefaultEmployeeNumber, -250 });
+        db.adjustSalaries(raises, threads);
+        CHECK(db.getEmployee(kDefaultEmployeeNumber).getSalary() == 40750);
+        CHECK(db.getEmployee(kDefaultEmployeeNumber + 2).getSalary() == 41002);
+        CHECK(db.getEmployee(kDefaultEmployeeNumber + 1).getSalary() == 40001);
+        // The salary column follows.
+        CHECK(db.getColumns().salaries()[2] == 41002);
+
+        size_t raised = db.adjustSalaries([](const Employee& e) { return e.isHired(); }, 10.0, threads);
+        CHECK(raised == 750);
+        CHECK(db.getEmployee(kDefaultEmployeeNumber + 1).getSalary() == 44001);
+        CHECK(db.getEmployee(kDefaultEmployeeNumber + 4).getSalary() == 41004);
+        CHECK(db.getEmployee(kDefaultEmployeeNumber + 3).getSalary() == 44003);
+        CHECK(db.adjustSalaries([](const Employee&) { return false; }, 50.0, threads) == 0);
+
+        cout << "Failed batches change nothing." << endl;
+        vector<int> before = salariesOf(db);
+        vector<SalaryAdjustment> unknown = raises;
+        unknown.push_back({ 99999, 1 });
+        CHECK_THROWS(db.adjustSalaries(unknown, threads), logic_error);
+        CHECK(salariesOf(db) == before);
+
+        vector<SalaryAdjustment> overflow = raises;
+        overflow.push_back({ kDefaultEmployeeNumber + 999, INT_MAX });
+        CHECK_THROWS(db.adjustSalaries(overflow, threads), overflow_error);
+        CHECK(salariesOf(db) == before);
+
+        CHECK_THROWS(db.adjustSalaries([](const Employee& e) { return e.getSalary() > 44000; }, 1e10, threads),
+                     overflow_error);
+        CHECK(salariesOf(db) == before);
+        CHECK_THROWS(db.adjustSalaries([](const Employee& e) -> bool {
+                         if (e.getEmployeeNumber() == kDefaultEmployeeNumber + 900)
+                         {
+                             throw runtime_error("predicate failed");
+                         }
+                         return true;
+                     }, 5.0, threads), runtime_error);
+        CHECK(salariesOf(db) == before);
+    }
+
+    cout << "Archived employees are adjusted too." << endl;
+    {
+        Database db;
+        buildRoster(db);
+        db.compact();
+        const int former = kDefaultEmployeeNumber + 8;
+        CHECK(db.isArchived(former) && db.isArchived(kDefaultEmployeeNumber + 12));
+
+        // A failed batch leaves them archived.
+        CHECK_THROWS(db.adjustSalaries({ { former, 100 }, { kDefaultEmployeeNumber + 1, INT_MAX } }),
+                     overflow_error);
+        CHECK(db.isArchived(former));
+        CHECK_THROWS(db.adjustSalaries({ { former, INT_MAX } }), overflow_error);
+        CHECK(db.isArchived(former));
+
+        db.adjustSalaries({ { former, 100 }, { kDefaultEmployeeNumber + 1, 1 }, { former, 5 } });
+        CHECK(!db.isArchived(former));
+        CHECK(db.getEmployee(former).getSalary() == 40113);
+        CHECK(!db.getEmployee(former).isHired());
+        CHECK(db.getEmployee(kDefaultEmployeeNumber + 1).getSalary() == 40002);
+
+        // Selected by predicate, every former employee is found.
+        CHECK(db.adjustSalaries([](const Employee& e) { return !e.isHired(); }, 10.0) == 250);
+        CHECK(db.getEmployee(kDefaultEmployeeNumber + 12).getSalary() == 44013);
+        CHECK(db.archivedCount() == 0);
+        CHECK(db.getCounters().headcount(StatusFilter::Former) == 250);
+    }
+
+    cout << "Adjustments are logged and replay." << endl;
+    {
+        const string logPath = "SalaryAdjustmentTest.log";
+        remove(logPath.c_str());
+        Database db;
+        {
+            WriteAheadLog log(logPath);
+            db.attachLog(&log);
+            buildRoster(db);
+            // Small enough a batch to take the sorting path.
+            db.adjustSalaries({ { kDefaultEmployeeNumber + 5, 500 }, { kDefaultEmployeeNumber + 6, -6 },
+                                { kDefaultEmployeeNumber + 5, 5 } });
+            db.adjustSalaries([](const Employee& e) { return !e.isHired(); }, -50.0);
+            log.commit();
+            db.attachLog(nullptr);
+        }
+        Database recovered;
+        recovered.recover("SalaryAdjustmentTest.missing.snap", logPath);
+        CHECK(salariesOf(recovered) == salariesOf(db));
+        CHECK(recovered.getEmployee(kDefaultEmployeeNumber + 5).getSalary() == 40510);
+        CHECK(recovered.getEmployee(kDefaultEmployeeNumber + 8).getSalary() == 20004);
+        remove(logPath.c_str());
+    }
+
+    return Testing::testResult();
+}
@@ -0,0 +1,87 @@
+#include <stdexcept>
+
+#include "SalaryIndex.h"
+
+using namespace std;
+
+namespace Records
+{
+    void SalaryIndex::assign(vector<uint64_t> keys)
+    {
+        sort(keys.begin(), keys.end());
+        mBlocks.clear();
+        mFirstKeys.clear();
+        mSize = keys.size();
+        // Half-full blocks leave room for updates before the first split.
+        for (size_t first = 0; first < keys.size(); first += kBlockSize / 2)
+        {
+            size_t last = min(keys.size(), first + kBlockSize / 2);
+            mBlocks.emplace_back(keys.begin() + static_cast<ptrdiff_t>(first),
+                                 keys.begin() + static_cast<ptrdiff_t>(last));
+            mFirstKeys.push_back(keys[first]);
+        }
+    }
+
+    void SalaryIndex::insert(int salary, size_t slot)
+    {
+        uint64_t entry = key(salary, slot);
+        ++mSize;
+        if (mBlocks.empty())
+        {
+            mBlocks.push_back({ entry });
+            mFirstKeys.push_back(entry);
+            return;
+        }
+        size_t block = blockFor(entry);
+        vector<uint64_t>& entries = mBlocks[block];
+        entries.insert(lower_bound(entries.begin(), entries.end(), entry), entry);
+        mFirstKeys[block] = entries.front();
+        if (entries.size() > kBlockSize)
+        {
+            auto middle = entries.begin() + static_cast<ptrdiff_t>(entries.size() / 2);
+            vector<uint64_t> upper(middle, entries.end());
+            entries.erase(middle, entries.end());
+            // Otherwise the lower half keeps the doubled capacity.
+            entries.shrink_to_fit();
+            mFirstKeys.insert(mFirstKeys.begin() + static_cast<ptrdiff_t>(block) + 1, upper.front());
+            mBlocks.insert(mBlocks.begin() + static_cast<ptrdiff_t>(block) + 1, move(upper));
+        }
+    }
+
+    void SalaryIndex::erase(int salary, size_t slot)
+    {
+        uint64_t entry = key(salary, slot);
+        if (mBlocks.empty())
+        {
+            return;
+        }
+        size_t block = blockFor(entry);
+        vector<uint64_t>& entries = mBlocks[block];
+        auto found = lower_bound(entries.begin(), entries.end(), entry);
+        if (found == entries.end() || *found != entry)
+        {
+            return;
+        }
+        entries.erase(found);
+        --mSize;
+        if (entries.empty())
+        {
+            mBlocks.erase(mBlocks.begin() + static_cast<ptrdiff_t>(block));
+            mFirstKeys.erase(mFirstKeys.begin() + static_cast<ptrdiff_t>(block));
+        }
+        else
+        {
+            mFirstKeys[block] = entries.front();
+        }
+    }
+
+    uint64_t SalaryIndex::key(int salary, size_t slot)
+    {
+        if (slot > 0xFFFFFFFFu)
+        {
+            throw length_error("Salary index slot out of range.");
+        }
+        // Flipping the sign bit makes the unsigned order match int order.
+        return (static_cast<uint64_t>(static_cast<uint32_t>(salary) ^ kSignBit) << 32) | slot;
+    }
+}
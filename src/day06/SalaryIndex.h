@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Records
+{
+    // Ordered index of (salary, slot) pairs: a two-level B+-tree.
+    //
+    // Entries are kept sorted in blocks of at most kBlockSize (1 KB), and
+    // the first entry of each block in one more sorted array that lookups
+    // binary-search to find the block. An update shifts entries within one
+    // block only; a full block splits in two and an empty one is dropped,
+    // each shifting the O(size/128) blocks after it, so updates cost
+    // O(log size) only amortized over the inserts between splits. Range
+    // scans read whole blocks sequentially. Queries never modify the index,
+    // so they may run concurrently.
+    class SalaryIndex
+    {
+        public:
+            static constexpr std::size_t kBlockSize = 128;
+
+            // Replaces the contents with these entries, each packed by key().
+            void assign(std::vector<std::uint64_t> keys);
+            void insert(int salary, std::size_t slot);
+            // The entry must be present.
+            void erase(int salary, std::size_t slot);
+            std::size_t size() const { return mSize; }
+
+            // Entries are packed into one integer that sorts by salary, then
+            // slot. Throws length_error for slots past 2^32 - 1.
+            static std::uint64_t key(int salary, std::size_t slot);
+            static int salaryOf(std::uint64_t key)
+            {
+                return static_cast<int>(static_cast<std::uint32_t>(key >> 32) ^ kSignBit);
+            }
+            static std::size_t slotOf(std::uint64_t key)
+            {
+                return static_cast<std::size_t>(key & 0xFFFFFFFFu);
+            }
+
+            // Calls fn(key) for each entry with a salary in [minSalary,
+            // maxSalary], lowest first, until fn returns false.
+            template <typename Fn>
+            void forEachBetween(int minSalary, int maxSalary, Fn&& fn) const
+            {
+                if (minSalary > maxSalary || mBlocks.empty())
+                {
+                    return;
+                }
+                std::uint64_t last = key(maxSalary, 0xFFFFFFFFu);
+                std::uint64_t first = key(minSalary, 0);
+                std::size_t block = blockFor(first);
+                auto entry = std::lower_bound(mBlocks[block].begin(), mBlocks[block].end(), first);
+                for (;;)
+                {
+                    for (; entry != mBlocks[block].end(); ++entry)
+                    {
+                        if (*entry > last || !fn(*entry))
+                        {
+                            return;
+                        }
+                    }
+                    if (++block == mBlocks.size())
+                    {
+                        return;
+                    }
+                    entry = mBlocks[block].begin();
+                }
+            }
+
+            // Calls fn(key) for each entry, highest salary first, until fn
+            // returns false.
+            template <typename Fn>
+            void forEachDescending(Fn&& fn) const
+            {
+                for (auto block = mBlocks.rbegin(); block != mBlocks.rend(); ++block)
+                {
+                    for (auto entry = block->rbegin(); entry != block->rend(); ++entry)
+                    {
+                        if (!fn(*entry))
+                        {
+                            return;
+                        }
+                    }
+                }
+            }
+
+        private:
+            static constexpr std::uint32_t kSignBit = 0x80000000u;
+
+            // The block that holds key, or would: the last whose first
+            // entry is not above it, or the first block.
+            std::size_t blockFor(std::uint64_t key) const
+            {
+                auto after = std::upper_bound(mFirstKeys.begin(), mFirstKeys.end(), key);
+                return after == mFirstKeys.begin() ? 0
+                                                   : static_cast<std::size_t>(after - mFirstKeys.begin()) - 1;
+            }
+
+            std::vector<std::vector<std::uint64_t>> mBlocks;
+            // mFirstKeys[i] == mBlocks[i].front(); no block is empty.
+            std::vector<std::uint64_t> mFirstKeys;
+            std::size_t mSize = 0;
+    };
+}
@@ -0,0 +1,74 @@
+/*
+ * Salary range and top-earner queries through the salary index, against
+ * the full scan Database falls back to without one, and what the index
+ * adds to each salary change.
+ *
+ * Usage: SalaryIndexBenchmark [maxEmployees]   (default 10000000)
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "Benchmark.h"
+#include "Database.h"
+
+using namespace std;
+using namespace Records;
+
+int main(int argc, char* argv[])
+{
+    size_t maxEmployees = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+
+    cout << setw(12) << "employees" << setw(20) << "query"
+         << setw(14) << "scan us" << setw(14) << "index us" << endl;
+
+    for (size_t count = 10000; count <= maxEmployees; count *= 10)
+    {
+        Database scanned;
+        Database indexed;
+        mt19937 rng(3);
+        uniform_int_distribution<int> pickSalary(20000, 220000);
+        for (Database* db : { &scanned, &indexed })
+        {
+            db->reserve(count);
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            int salary = pickSalary(rng);
+            for (Database* db : { &scanned, &indexed })
+            {
+                db->addEmployee("First" + to_string(i % 1000), "Last" + to_string(i % 5000)).setSalary(salary);
+            }
+        }
+        indexed.indexSalaries();
+
+        // Keep each scan measurement to ~10^8 records.
+        size_t scanOps = max<size_t>(1, 100000000 / count);
+        auto report = [&](const char* query, auto&& run) {
+            double scan = Bench::nanosPerOp(scanOps, [&](size_t i) { Bench::doNotOptimize(run(scanned, i)); });
+            double index = Bench::nanosPerOp(1000, [&](size_t i) { Bench::doNotOptimize(run(indexed, i)); });
+            cout << setw(12) << count << setw(20) << query << fixed << setprecision(2)
+                 << setw(14) << scan / 1e3 << setw(14) << index / 1e3 << endl;
+        };
+        report("range of 0.01%", [](const Database& db, size_t i) {
+            int low = 20000 + static_cast<int>(i * 7919 % 200000);
+            return db.findEmployeesBySalary(low, low + 20).size();
+        });
+        report("top 10", [](const Database& db, size_t) { return db.getTopEarners(10).size(); });
+        report("top 1000 current", [](const Database& db, size_t) {
+            return db.getTopEarners(1000, StatusFilter::Current).size();
+        });
+
+        auto raise = [&](Database& db) {
+            return Bench::nanosPerOp(100000, [&](size_t i) {
+                db.getEmployee(kDefaultEmployeeNumber + static_cast<int>(i * 7919 % count)).promote(i % 2 == 0 ? 500 : -500);
+            });
+        };
+        cout << setw(12) << count << setw(20) << "promote (ns)" << setw(14) << raise(scanned)
+             << setw(14) << raise(indexed) << endl;
+    }
+    return 0;
+}
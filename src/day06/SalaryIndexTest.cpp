@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "Database.h"
+#include "TestHelpers.h"
+
+using namespace std;
+using namespace Records;
+
+/*
+ * Keeps a salary-indexed database and an unindexed twin through the same
+ * random hires, raises and firings, and checks that both answer range and
+ * top-earner queries alike (the unindexed one scans). A plain sort of the
+ * roster checks the scan.
+ */
+
+static vector<int> sortedBySalary(const Database& db, int minSalary, int maxSalary)
+{
+    vector<const Employee*> matches;
+    for (const Employee& employee : db)
+    {
+        if (employee.getSalary() >= minSalary && employee.getSalary() <= maxSalary)
+        {
+            matches.push_back(&employee);
+        }
+    }
+    stable_sort(matches.begin(), matches.end(), [](const Employee* a, const Employee* b) {
+        return a->getSalary() < b->getSalary();
+    });
+    vector<int> numbers;
+    for (const Employee* employee : matches)
+    {
+        numbers.push_back(employee->getEmployeeNumber());
+    }
+    return numbers;
+}
+
+int main()
+{
+    Database indexed;
+    Database scanned;
+    mt19937 rng(11);
+    // A narrow salary range makes for plenty of ties.
+    uniform_int_distribution<int> pickSalary(30000, 30400);
+
+    for (int i = 0; i < 300; ++i)
+    {
+        for (Database* db : { &indexed, &scanned })
+        {
+            db->addEmployee("Early", to_string(i)).setSalary(30000 + i);
+        }
+    }
+    indexed.indexSalaries();
+    CHECK(indexed.hasSalaryIndex() && !scanned.hasSalaryIndex());
+
+    cout << "Random updates." << endl;
+    for (int round = 0; round < 20000; ++round)
+    {
+        unsigned action = rng() % 8;
+        int salary = pickSalary(rng);
+        int number = kDefaultEmployeeNumber + static_cast<int>(rng() % indexed.size());
+        for (Database* db : { &indexed, &scanned })
+        {
+            switch (action)
+            {
+                case 0:
+                    db->addEmployee("Late", "Hire").setSalary(salary);
+                    break;
+                case 1:
+                    db->getEmployee(number).promote(salary % 50);
+                    break;
+                case 2:
+                    db->getEmployee(number).demote(salary % 50);
+                    break;
+                case 3:
+                    db->getEmployee(number).fire();
+                    break;
+                case 4:
+                    db->getEmployee(number).hire();
+                    break;
+                default:
+                    db->getEmployee(number).setSalary(salary);
+                    break;
+            }
+        }
+        if (round % 1000 == 0)
+        {
+            int low = pickSalary(rng);
+            int high = low + static_cast<int>(rng() % 100);
+            CHECK(indexed.findEmployeesBySalary(low, high) == sortedBySalary(indexed, low, high));
+            for (StatusFilter filter : { StatusFilter::All, StatusFilter::Current, StatusFilter::Former })
+            {
+                CHECK(indexed.findEmployeesBySalary(low, high, filter)
+                      == scanned.findEmployeesBySalary(low, high, filter));
+                for (size_t count : { 0, 1, 7, 100, 100000 })
+                {
+                    CHECK(indexed.getTopEarners(count, filter) == scanned.getTopEarners(count, filter));
+                }
+            }
+        }
+    }
+
+    cout << "Edge cases." << endl;
+    CHECK(indexed.findEmployeesBySalary(INT32_MIN, INT32_MAX).size() == indexed.size());
+    CHECK(indexed.findEmployeesBySalary(1, 0).empty());
+    CHECK(indexed.getTopEarners(indexed.size() + 5).size() == indexed.size());
+    Database empty;
+    empty.indexSalaries();
+    CHECK(empty.getTopEarners(3).empty());
+    Employee& negative = empty.addEmployee("Owes", "Money");
+    negative.setSalary(-5);
+    empty.addEmployee("Paid", "Normally");
+    CHECK(empty.findEmployeesBySalary(-10, 0) == vector<int>{ negative.getEmployeeNumber() });
+    CHECK(empty.getTopEarners(1) == vector<int>{ kDefaultEmployeeNumber + 1 });
+
+    return Testing::testResult();
+}
@@ -0,0 +1,104 @@
+/*
+ * Status filters and salary aggregates over an array-of-structs
+ * std::vector<Employee> compared with the columnar layout.
+ *
+ * Usage: ScanBenchmark [maxEmployees]   (default 10000000)
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Database.h"
+
+using namespace std;
+using namespace Records;
+
+int main(int argc, char* argv[])
+{
+    size_t maxEmployees = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+
+    cout << setw(12) << "employees" << setw(22) << "task"
+         << setw(14) << "rows ms" << setw(14) << "columns ms" << endl;
+
+    for (size_t count = 1000; count <= maxEmployees; count *= 10)
+    {
+        Database db(StorageLayout::Columnar);
+        vector<Employee> rows;
+        rows.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Employee& employee = db.addEmployee("FirstName" + to_string(i % 5000),
+                                                "LongerLastName" + to_string(i));
+            employee.setSalary(30000 + static_cast<int>(i % 90000));
+            if (i % 3 == 0)
+            {
+                employee.fire();
+            }
+            rows.push_back(employee);
+        }
+        const EmployeeColumns& columns = db.getColumns();
+
+        // Repeat small rosters so every measurement covers ~10^7 records.
+        size_t repeats = count >= 10000000 ? 1 : 10000000 / count;
+        auto report = [&](const char* task, double rowsNanos, double columnsNanos) {
+            cout << setw(12) << count << setw(22) << task << fixed << setprecision(3)
+                 << setw(14) << rowsNanos * repeats / 1e6
+                 << setw(14) << columnsNanos * repeats / 1e6 << endl;
+        };
+
+        double rowCount = Bench::nanosPerOp(repeats, [&](size_t) {
+            size_t hired = 0;
+            for (const auto& employee : rows)
+            {
+                hired += employee.isHired();
+            }
+            Bench::doNotOptimize(hired);
+        });
+        double columnCount = Bench::nanosPerOp(repeats, [&](size_t) {
+            Bench::doNotOptimize(columns.countHired(true));
+        });
+        report("count current", rowCount, columnCount);
+
+        double rowPayroll = Bench::nanosPerOp(repeats, [&](size_t) {
+            long long total = 0;
+            for (const auto& employee : rows)
+            {
+                if (employee.isHired())
+                {
+                    total += employee.getSalary();
+                }
+            }
+            Bench::doNotOptimize(total);
+        });
+        double columnPayroll = Bench::nanosPerOp(repeats, [&](size_t) {
+            Bench::doNotOptimize(columns.totalSalary(true));
+        });
+        report("current payroll", rowPayroll, columnPayroll);
+
+        double rowFilter = Bench::nanosPerOp(repeats, [&](size_t) {
+            size_t matched = 0;
+            for (const auto& employee : rows)
+            {
+                if (!employee.isHired())
+                {
+                    matched += static_cast<size_t>(employee.getEmployeeNumber());
+                }
+            }
+            Bench::doNotOptimize(matched);
+        });
+        double columnFilter = Bench::nanosPerOp(repeats, [&](size_t) {
+            size_t matched = 0;
+            const vector<int>& numbers = columns.employeeNumbers();
+            columns.forEach(false, [&](size_t slot) {
+                matched += static_cast<size_t>(numbers[slot]);
+            });
+            Bench::doNotOptimize(matched);
+        });
+        report("select former", rowFilter, columnFilter);
+    }
+    return 0;
+}
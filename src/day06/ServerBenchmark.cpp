@@ -0,0 +1,168 @@
+/*
+ * Load generator for employee_server: clients on their own threads keep
+ * pipelineDepth requests in flight each, 90% lookups and 10% raises, and
+ * the run reports throughput and p50/p99 latency.
+ *
+ * Usage: ServerBenchmark [socketPath] [clients] [requestsPerClient] [pipelineDepth] [employees]
+ *        (default: a server started in-process, 4 clients, 200000 requests
+ *        each, depth 32, 100000 employees; "-" also starts one in-process)
+ *
+ * Latency runs from the flush that sends a request to the read that
+ * delivers its answer, so it includes the time spent queued behind the
+ * rest of its batch.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Benchmark.h"
+#include "Database.h"
+#include "EmployeeClient.h"
+#include "EmployeeServer.h"
+
+using namespace std;
+using namespace Records;
+
+// Hires employees through the server until it has at least count.
+static void populate(const string& path, size_t count)
+{
+    EmployeeClient client(path);
+    Request sizeRequest;
+    sizeRequest.opcode = Opcode::Size;
+    size_t existing = static_cast<size_t>(client.call(sizeRequest).value);
+    const size_t kBatch = 1024;
+    for (size_t i = existing; i < count; )
+    {
+        size_t batch = min(kBatch, count - i);
+        for (size_t j = 0; j < batch; ++j, ++i)
+        {
+            client.send(addEmployeeRequest("First" + to_string(i % 1000), "Last" + to_string(i)));
+        }
+        for (size_t j = 0; j < batch; ++j)
+        {
+            client.receive();
+        }
+    }
+}
+
+// Runs one client and returns the latency of each request in microseconds.
+static vector<double> runClient(const string& path, size_t requests, size_t depth,
+                                size_t employees, unsigned seed, size_t& failures)
+{
+    EmployeeClient client(path);
+    mt19937 rng(seed);
+    vector<double> latencies;
+    latencies.reserve(requests);
+    for (size_t done = 0; done < requests; )
+    {
+        size_t batch = min(depth, requests - done);
+        for (size_t i = 0; i < batch; ++i)
+        {
+            Request request;
+            request.employeeNumber = kDefaultEmployeeNumber + static_cast<int>(rng() % employees);
+            if (rng() % 10 == 0)
+            {
+                request.opcode = Opcode::Promote;
+                request.value = 1;
+            }
+            else
+            {
+                request.opcode = Opcode::GetEmployee;
+            }
+            client.send(move(request));
+        }
+        auto sent = Bench::Clock::now();
+        client.flush();
+        for (size_t i = 0; i < batch; ++i)
+        {
+            Response response = client.receive();
+            chrono::duration<double, micro> latency = Bench::Clock::now() - sent;
+            latencies.push_back(latency.count());
+            failures += response.status == ResponseStatus::Ok ? 0 : 1;
+        }
+        done += batch;
+    }
+    return latencies;
+}
+
+static double percentile(const vector<double>& sorted, double fraction)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+int main(int argc, char* argv[])
+{
+    string path = argc > 1 ? argv[1] : "-";
+    size_t clients = argc > 2 ? strtoull(argv[2], nullptr, 10) : 4;
+    size_t requestsPerClient = argc > 3 ? strtoull(argv[3], nullptr, 10) : 200000;
+    size_t depth = argc > 4 ? max<size_t>(1, strtoull(argv[4], nullptr, 10)) : 32;
+    size_t employees = argc > 5 ? max<size_t>(1, strtoull(argv[5], nullptr, 10)) : 100000;
+
+    // With no server given, serve a fresh Database from this process.
+    Database db;
+    unique_ptr<EmployeeServer> server;
+    thread serverThread;
+    if (path == "-")
+    {
+        path = "/tmp/ServerBenchmark." + to_string(getpid()) + ".sock";
+        server = make_unique<EmployeeServer>(db, path);
+        serverThread = thread([&] { server->run(); });
+    }
+
+    populate(path, employees);
+
+    vector<vector<double>> latencies(clients);
+    vector<size_t> failures(clients, 0);
+    vector<thread> workers;
+    auto start = Bench::Clock::now();
+    for (size_t c = 0; c < clients; ++c)
+    {
+        workers.emplace_back([&, c] {
+            latencies[c] = runClient(path, requestsPerClient, depth, employees,
+                                     static_cast<unsigned>(c) + 1, failures[c]);
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    chrono::duration<double> elapsed = Bench::Clock::now() - start;
+
+    if (server)
+    {
+        server->stop();
+        serverThread.join();
+    }
+
+    vector<double> all;
+    size_t failed = 0;
+    for (size_t c = 0; c < clients; ++c)
+    {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        failed += failures[c];
+    }
+    sort(all.begin(), all.end());
+
+    cout << "clients: " << clients << ", depth: " << depth << ", requests: " << all.size()
+         << ", failed: " << failed << endl;
+    cout << fixed << setprecision(0) << "throughput: " << static_cast<double>(all.size()) / elapsed.count()
+         << " op/s" << endl;
+    cout << setprecision(1) << "latency p50: " << percentile(all, 0.50) << " us, p99: "
+         << percentile(all, 0.99) << " us, max: " << (all.empty() ? 0.0 : all.back()) << " us" << endl;
+    return 0;
+}
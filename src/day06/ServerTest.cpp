@@ -0,0 +1,173 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Database.h"
+#include "EmployeeClient.h"
+#include "EmployeeServer.h"
+#include "TestHelpers.h"
+
+using namespace std;
+using namespace Records;
+
+static Request numbered(Opcode opcode, int employeeNumber, int value = 0)
+{
+    Request request;
+    request.opcode = opcode;
+    request.employeeNumber = employeeNumber;
+    request.value = value;
+    return request;
+}
+
+/*
+ * Runs an EmployeeServer on a thread and talks to it through
+ * EmployeeClient: single calls, deep pipelines, several clients at once
+ * and a client that sends garbage.
+ */
+int main()
+{
+    cout << "Round-tripping messages." << endl;
+    {
+        vector<char> bytes;
+        Request request = addEmployeeRequest("Ada", "Lovelace");
+        request.id = 7;
+        encodeRequest(request, bytes);
+        Request decoded;
+        CHECK(decodeRequest(bytes.data(), bytes.size() - 1, decoded) == 0);
+        CHECK(decodeRequest(bytes.data(), bytes.size(), decoded) == bytes.size());
+        CHECK(decoded.id == 7 && decoded.opcode == Opcode::AddEmployee);
+        CHECK(decoded.value == 3 && decoded.text == "AdaLovelace");
+
+        bytes.assign(4, '\xff');
+        CHECK_THROWS(decodeRequest(bytes.data(), bytes.size(), decoded), runtime_error);
+    }
+
+    Database db;
+    cout << "Refusing to replace a file that is not a socket." << endl;
+    {
+        string kept = "/tmp/ServerTest." + to_string(getpid()) + ".txt";
+        {
+            ofstream out(kept);
+            out << "keep me";
+        }
+        CHECK_THROWS(EmployeeServer(db, kept), runtime_error);
+        ifstream in(kept);
+        string contents;
+        getline(in, contents);
+        CHECK(contents == "keep me");
+        remove(kept.c_str());
+    }
+
+    string path = "/tmp/ServerTest." + to_string(getpid()) + ".sock";
+    EmployeeServer server(db, path);
+    thread serverThread([&] { server.run(); });
+
+    cout << "Calling one request at a time." << endl;
+    {
+        EmployeeClient client(path);
+        Response added = client.call(addEmployeeRequest("Grace", "Hopper"));
+        CHECK(added.status == ResponseStatus::Ok);
+        CHECK(added.employeeNumber == kDefaultEmployeeNumber);
+
+        Response promoted = client.call(numbered(Opcode::Promote, added.employeeNumber, 500));
+        CHECK(promoted.status == ResponseStatus::Ok);
+        CHECK(promoted.value == kDefaultStartingSlalary + 500);
+
+        client.call(numbered(Opcode::Hire, added.employeeNumber));
+        Response found = client.call(numbered(Opcode::GetEmployee, added.employeeNumber));
+        CHECK(found.status == ResponseStatus::Ok && found.hired);
+        CHECK(found.firstName() == "Grace" && found.lastName() == "Hopper");
+
+        CHECK(client.call(numbered(Opcode::Fire, 5)).status == ResponseStatus::NotFound);
+        CHECK(client.call(numbered(Opcode::GetEmployee, 5)).status == ResponseStatus::NotFound);
+        CHECK(client.call(numbered(static_cast<Opcode>(99), 0)).status == ResponseStatus::Invalid);
+        Request badSplit = addEmployeeRequest("A", "B");
+        badSplit.value = 10;
+        CHECK(client.call(badSplit).status == ResponseStatus::Invalid);
+    }
+
+    cout << "Pipelining more answers than the server will buffer." << endl;
+    {
+        // Each answer is 37 bytes, so these pass the server's 1 MiB limit
+        // on unsent output several times over.
+        const int kRequests = 100000;
+        EmployeeClient client(path);
+        for (int i = 0; i < kRequests; ++i)
+        {
+            client.send(numbered(Opcode::GetEmployee, kDefaultEmployeeNumber));
+        }
+        client.flush();
+        int found = 0;
+        for (int i = 0; i < kRequests; ++i)
+        {
+            Response response = client.receive();
+            found += response.status == ResponseStatus::Ok && response.firstName() == "Grace";
+        }
+        CHECK(found == kRequests);
+    }
+
+    cout << "Pipelining from several clients." << endl;
+    const int kClients = 4;
+    const int kHires = 2000;
+    {
+        vector<thread> clients;
+        // char rather than bool, so each thread writes its own byte.
+        vector<char> ordered(kClients, false);
+        for (int c = 0; c < kClients; ++c)
+        {
+            clients.emplace_back([&, c] {
+                EmployeeClient client(path);
+                vector<uint32_t> ids;
+                for (int i = 0; i < kHires; ++i)
+                {
+                    ids.push_back(client.send(addEmployeeRequest("Client" + to_string(c), to_string(i))));
+                }
+                bool inOrder = true;
+                for (uint32_t id : ids)
+                {
+                    Response response = client.receive();
+                    inOrder = inOrder && response.id == id && response.status == ResponseStatus::Ok;
+                }
+                ordered[c] = inOrder;
+            });
+        }
+        for (auto& client : clients)
+        {
+            client.join();
+        }
+        for (int c = 0; c < kClients; ++c)
+        {
+            CHECK(ordered[c]);
+        }
+    }
+    EmployeeClient client(path);
+    CHECK(client.call(numbered(Opcode::Size, 0)).value == 1 + kClients * kHires);
+
+    cout << "Dropping a client that sends garbage." << endl;
+    {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+        CHECK(::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+        const char garbage[8] = { '\xff', '\xff', '\xff', '\xff', 0, 0, 0, 0 };
+        CHECK(::write(fd, garbage, sizeof(garbage)) == static_cast<ssize_t>(sizeof(garbage)));
+        char reply;
+        CHECK(::read(fd, &reply, 1) == 0);
+        ::close(fd);
+    }
+    // Other clients carry on.
+    CHECK(client.call(numbered(Opcode::GetEmployee, kDefaultEmployeeNumber)).status == ResponseStatus::Ok);
+
+    server.stop();
+    serverThread.join();
+    return Testing::testResult();
+}
@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Database.h"
+#include "Snapshot.h"
+
+using namespace std;
+
+namespace Records
+{
+    namespace
+    {
+        // Version 1 headers end before logSequence.
+        const size_t kVersion1HeaderBytes = offsetof(SnapshotHeader, logSequence);
+
+        runtime_error snapshotError(const string& path, const string& what)
+        {
+            return runtime_error("Snapshot " + path + ": " + what);
+        }
+
+        void syncDirectoryOf(const string& path)
+        {
+            size_t slash = path.rfind('/');
+            string directory = slash == string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+            int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+            if (fd < 0)
+            {
+                throw snapshotError(path, strerror(errno));
+            }
+            int result = ::fsync(fd);
+            int error = errno;
+            ::close(fd);
+            if (result != 0)
+            {
+                throw snapshotError(path, strerror(error));
+            }
+        }
+
+        // Tables start on an 8-byte boundary, so the mapped file can be read
+        // through SnapshotRecord and SnapshotName pointers.
+        const uint64_t kTableAlignment = alignof(SnapshotName);
+
+        uint64_t alignUp(uint64_t offset)
+        {
+            return (offset + kTableAlignment - 1) / kTableAlignment * kTableAlignment;
+        }
+
+        void writeAll(FILE* out, const void* data, size_t bytes, const string& path)
+        {
+            if (bytes != 0 && fwrite(data, 1, bytes, out) != bytes)
+            {
+                throw snapshotError(path, "write failed");
+            }
+        }
+    }
+
+    Snapshot::Snapshot(const string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw snapshotError(path, strerror(errno));
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < kVersion1HeaderBytes)
+        {
+            ::close(fd);
+            throw snapshotError(path, "too short");
+        }
+        mMappedBytes = static_cast<size_t>(info.st_size);
+        mMapping = ::mmap(nullptr, mMappedBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mMapping == MAP_FAILED)
+        {
+            mMapping = nullptr;
+            throw snapshotError(path, strerror(errno));
+        }
+
+        const char* base = static_cast<const char*>(mMapping);
+        mHeader = reinterpret_cast<const SnapshotHeader*>(base);
+        auto fits = [&](uint64_t offset, uint64_t count, size_t width) {
+            return offset <= mMappedBytes && count <= (mMappedBytes - offset) / width;
+        };
+        const char* problem = nullptr;
+        if (memcmp(mHeader->magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0)
+        {
+            problem = "not a snapshot file";
+        }
+        else if (mHeader->version < 1 || mHeader->version > kSnapshotVersion
+                 || mHeader->recordBytes != sizeof(SnapshotRecord))
+        {
+            problem = "unsupported snapshot version";
+        }
+        else if (mHeader->version >= 2 && mMappedBytes < sizeof(SnapshotHeader))
+        {
+            problem = "truncated";
+        }
+        else if (!fits(mHeader->recordsOffset, mHeader->recordCount, sizeof(SnapshotRecord))
+                 || !fits(mHeader->namesOffset, mHeader->nameCount, sizeof(SnapshotName))
+                 || !fits(mHeader->heapOffset, mHeader->heapBytes, 1))
+        {
+            problem = "truncated";
+        }
+        else if (mHeader->recordsOffset % alignof(SnapshotRecord) != 0
+                 || mHeader->namesOffset % alignof(SnapshotName) != 0)
+        {
+            problem = "misaligned table";
+        }
+        if (problem != nullptr)
+        {
+            ::munmap(mMapping, mMappedBytes);
+            mMapping = nullptr;
+            throw snapshotError(path, problem);
+        }
+
+        mRecords = reinterpret_cast<const SnapshotRecord*>(base + mHeader->recordsOffset);
+        mNames = reinterpret_cast<const SnapshotName*>(base + mHeader->namesOffset);
+        mHeap = base + mHeader->heapOffset;
+    }
+
+    Snapshot::~Snapshot()
+    {
+        if (mMapping != nullptr)
+        {
+            ::munmap(mMapping, mMappedBytes);
+        }
+    }
+
+    const SnapshotRecord* Snapshot::find(int employeeNumber) const
+    {
+        size_t count = size();
+        if (count == 0)
+        {
+            return nullptr;
+        }
+        // Numbers are usually dense, which puts the record at a fixed offset
+        // from the first one; otherwise fall back to a binary search.
+        long long offset = static_cast<long long>(employeeNumber) - mRecords[0].employeeNumber;
+        if (offset >= 0 && static_cast<unsigned long long>(offset) < count
+            && mRecords[offset].employeeNumber == employeeNumber)
+        {
+            return &mRecords[offset];
+        }
+        const SnapshotRecord* last = mRecords + count;
+        const SnapshotRecord* found = lower_bound(mRecords, last, employeeNumber,
+            [](const SnapshotRecord& record, int number) { return record.employeeNumber < number; });
+        return found != last && found->employeeNumber == employeeNumber ? found : nullptr;
+    }
+
+    string_view Snapshot::name(uint32_t index) const
+    {
+        if (index >= mHeader->nameCount)
+        {
+            throw runtime_error("Snapshot record refers to a missing name.");
+        }
+        const SnapshotName& entry = mNames[index];
+        if (entry.offset > mHeader->heapBytes || entry.length > mHeader->heapBytes - entry.offset)
+        {
+            throw runtime_error("Snapshot name lies outside the string heap.");
+        }
+        return string_view(mHeap + entry.offset, static_cast<size_t>(entry.length));
+    }
+
+    void Snapshot::save(const Database& db, const string& path)
+    {
+        vector<Employee> archived;
+        archived.reserve(db.archivedCount());
+        db.forEachArchived([&](const Employee& employee) { archived.push_back(employee); });
+
+        vector<const Employee*> employees;
+        employees.reserve(db.size());
+        for (const auto& employee : db)
+        {
+            employees.push_back(&employee);
+        }
+        for (const auto& employee : archived)
+        {
+            employees.push_back(&employee);
+        }
+        stable_sort(employees.begin(), employees.end(), [](const Employee* a, const Employee* b) {
+            return a->getEmployeeNumber() < b->getEmployeeNumber();
+        });
+
+        // Give each distinct NameId a slot in the name table.
+        const uint32_t kUnassigned = static_cast<uint32_t>(-1);
+        vector<uint32_t> nameIndex;
+        vector<NameId> names;
+        auto indexOf = [&](NameId id) {
+            if (id >= nameIndex.size())
+            {
+                nameIndex.resize(static_cast<size_t>(id) + 1, kUnassigned);
+            }
+            if (nameIndex[id] == kUnassigned)
+            {
+                nameIndex[id] = static_cast<uint32_t>(names.size());
+                names.push_back(id);
+            }
+            return nameIndex[id];
+        };
+
+        vector<SnapshotRecord> records;
+        records.reserve(employees.size());
+        for (const Employee* employee : employees)
+        {
+            SnapshotRecord record;
+            record.employeeNumber = employee->getEmployeeNumber();
+            record.salary = employee->getSalary();
+            record.firstName = indexOf(employee->getFirstNameId());
+            record.lastName = indexOf(employee->getLastNameId());
+            record.flags = employee->isHired() ? SnapshotRecord::kHired : 0;
+            records.push_back(record);
+        }
+
+        vector<SnapshotName> table;
+        table.reserve(names.size());
+        uint64_t heapBytes = 0;
+        for (NameId id : names)
+        {
+            uint64_t length = NamePool::global().view(id).size();
+            table.push_back({ heapBytes, length });
+            heapBytes += length;
+        }
+
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+        header.version = kSnapshotVersion;
+        header.recordBytes = sizeof(SnapshotRecord);
+        header.recordCount = records.size();
+        header.nameCount = table.size();
+        header.recordsOffset = alignUp(sizeof(SnapshotHeader));
+        header.namesOffset = alignUp(header.recordsOffset + records.size() * sizeof(SnapshotRecord));
+        header.heapOffset = alignUp(header.namesOffset + table.size() * sizeof(SnapshotName));
+        header.heapBytes = heapBytes;
+        header.nextEmployeeNumber = db.getNextEmployeeNumber();
+        header.logSequence = db.getLogSequence();
+
+        string temporary = path + ".tmp";
+        FILE* out = fopen(temporary.c_str(), "wb");
+        if (out == nullptr)
+        {
+            throw snapshotError(temporary, strerror(errno));
+        }
+        try
+        {
+            // Zeroes up to each table's offset.
+            const char padding[kTableAlignment] = {};
+            uint64_t written = 0;
+            auto writeAt = [&](uint64_t offset, const void* data, size_t bytes) {
+                writeAll(out, padding, static_cast<size_t>(offset - written), temporary);
+                writeAll(out, data, bytes, temporary);
+                written = offset + bytes;
+            };
+            writeAt(0, &header, sizeof(header));
+            writeAt(header.recordsOffset, records.data(), records.size() * sizeof(SnapshotRecord));
+            writeAt(header.namesOffset, table.data(), table.size() * sizeof(SnapshotName));
+            writeAll(out, padding, static_cast<size_t>(header.heapOffset - written), temporary);
+            for (NameId id : names)
+            {
+                string_view name = NamePool::global().view(id);
+                writeAll(out, name.data(), name.size(), temporary);
+            }
+            if (fflush(out) != 0 || ::fsync(fileno(out)) != 0)
+            {
+                throw snapshotError(temporary, strerror(errno));
+            }
+        }
+        catch (...)
+        {
+            fclose(out);
+            remove(temporary.c_str());
+            throw;
+        }
+        if (fclose(out) != 0)
+        {
+            int error = errno;
+            remove(temporary.c_str());
+            throw snapshotError(temporary, strerror(error));
+        }
+        if (rename(temporary.c_str(), path.c_str()) != 0)
+        {
+            int error = errno;
+            remove(temporary.c_str());
+            throw snapshotError(path, strerror(error));
+        }
+        // The rename is only durable once the directory entry is.
+        syncDirectoryOf(path);
+    }
+}
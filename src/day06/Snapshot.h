@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Records
+{
+    class Database;
+
+    // On-disk snapshot of a Database, in native byte order:
+    //
+    //   SnapshotHeader
+    //   SnapshotRecord[recordCount]   fixed width, sorted by employee number
+    //   SnapshotName[nameCount]       (offset, length) into the string heap
+    //   char[heapBytes]               each distinct name stored once
+    //
+    // Records refer to names by their index in the name table. Each table
+    // starts on an 8-byte boundary, zero-padded after the one before; files
+    // whose offsets are misaligned are rejected.
+    //
+    // Version 2 appends logSequence to the header: the last write-ahead log
+    // entry the snapshot includes. Version 1 files read as sequence 0.
+    const char kSnapshotMagic[8] = { 'R', 'E', 'C', 'S', 'N', 'A', 'P', '\0' };
+    const std::uint32_t kSnapshotVersion = 2;
+
+    struct SnapshotHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t recordBytes;
+        std::uint64_t recordCount;
+        std::uint64_t nameCount;
+        std::uint64_t recordsOffset;
+        std::uint64_t namesOffset;
+        std::uint64_t heapOffset;
+        std::uint64_t heapBytes;
+        std::int32_t nextEmployeeNumber;
+        std::uint32_t reserved;
+        // Version 2 and later.
+        std::uint64_t logSequence;
+    };
+
+    struct SnapshotRecord
+    {
+        static constexpr std::uint32_t kHired = 1;
+
+        std::int32_t employeeNumber;
+        std::int32_t salary;
+        std::uint32_t firstName;
+        std::uint32_t lastName;
+        std::uint32_t flags;
+    };
+
+    struct SnapshotName
+    {
+        std::uint64_t offset;
+        std::uint64_t length;
+    };
+
+    // Read-only view of a snapshot file. The file is mapped into memory and
+    // records are read in place: opening costs a header check regardless of
+    // roster size, and pages are only faulted in as they are read.
+    // Database::loadSnapshot() keeps one to answer reads until the database
+    // needs its own copy of the records.
+    //
+    // Throws runtime_error if the file cannot be mapped or is not a
+    // snapshot of this version.
+    class Snapshot
+    {
+        public:
+            explicit Snapshot(const std::string& path);
+            ~Snapshot();
+            Snapshot(const Snapshot&) = delete;
+            Snapshot& operator=(const Snapshot&) = delete;
+
+            // Writes db, archive included, to path. The file is written
+            // beside path and renamed over it once complete, so a crash
+            // leaves the old snapshot or the new one. Returns only once the
+            // file and the rename are both on disk; throws runtime_error if
+            // either fails.
+            static void save(const Database& db, const std::string& path);
+
+            std::size_t size() const { return static_cast<std::size_t>(mHeader->recordCount); }
+            int getNextEmployeeNumber() const { return mHeader->nextEmployeeNumber; }
+            std::uint64_t getLogSequence() const
+            {
+                return mHeader->version >= 2 ? mHeader->logSequence : 0;
+            }
+
+            const SnapshotRecord& record(std::size_t index) const { return mRecords[index]; }
+            // Record with this number, or nullptr if there is none.
+            const SnapshotRecord* find(int employeeNumber) const;
+
+            std::size_t nameCount() const { return static_cast<std::size_t>(mHeader->nameCount); }
+            std::string_view name(std::uint32_t index) const;
+            std::string_view firstName(const SnapshotRecord& record) const { return name(record.firstName); }
+            std::string_view lastName(const SnapshotRecord& record) const { return name(record.lastName); }
+
+        private:
+            void* mMapping = nullptr;
+            std::size_t mMappedBytes = 0;
+            const SnapshotHeader* mHeader = nullptr;
+            const SnapshotRecord* mRecords = nullptr;
+            const SnapshotName* mNames = nullptr;
+            const char* mHeap = nullptr;
+    };
+}
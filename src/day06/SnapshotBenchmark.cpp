@@ -0,0 +1,81 @@
+/*
+ * Startup cost of a snapshot at growing roster sizes: opening it as a
+ * mapped Snapshot and reading one record, Database::loadSnapshot() plus
+ * the same read, and the database's first write, which builds its tiers
+ * from every record.
+ *
+ * Usage: SnapshotBenchmark [maxEmployees] [snapshotFile]
+ *        (default 1000000 employees, SnapshotBenchmark.snap)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Database.h"
+#include "Snapshot.h"
+
+using namespace std;
+using namespace Records;
+
+template <typename Fn>
+static double millis(Fn&& fn)
+{
+    auto start = Bench::Clock::now();
+    fn();
+    chrono::duration<double, milli> elapsed = Bench::Clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxEmployees = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    string path = argc > 2 ? argv[2] : "SnapshotBenchmark.snap";
+
+    cout << setw(12) << "employees" << setw(12) << "file MB" << setw(14) << "mapped ms"
+         << setw(14) << "loaded ms" << setw(16) << "first write ms" << setw(12) << "ns/record" << endl;
+    cout << fixed;
+    for (size_t count = 10000; count <= maxEmployees; count *= 10)
+    {
+        {
+            Database db;
+            vector<pair<string, string>> names;
+            names.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                names.emplace_back("First" + to_string(i % 5000), "Last" + to_string(i));
+            }
+            db.addEmployees(names);
+            db.saveSnapshot(path);
+        }
+        int last = kDefaultEmployeeNumber + static_cast<int>(count) - 1;
+
+        double fileMegabytes = static_cast<double>(filesystem::file_size(path)) / (1 << 20);
+        double mapped = millis([&] {
+            Snapshot snapshot(path);
+            const SnapshotRecord* record = snapshot.find(last);
+            Bench::doNotOptimize(record);
+        });
+        // Destroying the database afterwards is not part of the load.
+        Database db;
+        double loaded = millis([&] {
+            db.loadSnapshot(path);
+            Employee found;
+            Bench::doNotOptimize(db.findEmployee(last, found));
+        });
+        double firstWrite = millis([&] { db.getEmployee(last).promote(); });
+
+        cout << setw(12) << count << setw(12) << setprecision(1) << fileMegabytes << setw(14)
+             << setprecision(3) << mapped << setw(14) << loaded << setw(16) << firstWrite
+             << setw(12) << setprecision(0) << firstWrite * 1e6 / static_cast<double>(count) << endl;
+    }
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Database.h"
+#include "Snapshot.h"
+#include "TestHelpers.h"
+
+using namespace std;
+using namespace Records;
+
+/*
+ * Round-trips a database through Database::saveSnapshot and loadSnapshot,
+ * and reads the same file in place through Snapshot.
+ */
+
+static void buildRoster(Database& db)
+{
+    db.addEmployee("Greg", "Wallis").fire();
+    db.addEmployee("Marc", "White").setSalary(100000);
+    Employee& john = db.addEmployee("John", "Doe");
+    john.setSalary(10000);
+    john.promote();
+    db.addEmployee("John", "Doe").setSalary(45000);
+    db.addEmployee("", "Nobody");
+    for (int i = 0; i < 10000; ++i)
+    {
+        Employee& employee = db.addEmployee("First" + to_string(i % 37), "Last" + to_string(i % 101));
+        employee.setSalary(20000 + i);
+        if (i % 5 == 0)
+        {
+            employee.fire();
+        }
+    }
+}
+
+static bool sameEmployee(const Employee& a, const Employee& b)
+{
+    return a.getEmployeeNumber() == b.getEmployeeNumber()
+        && a.getFirstName() == b.getFirstName()
+        && a.getLastName() == b.getLastName()
+        && a.getSalary() == b.getSalary()
+        && a.isHired() == b.isHired();
+}
+
+int main()
+{
+    const string path = "SnapshotTest.snap";
+
+    Database original;
+    buildRoster(original);
+    original.saveSnapshot(path);
+
+    cout << "Reading the snapshot in place." << endl;
+    {
+        Snapshot snapshot(path);
+        CHECK(snapshot.size() == original.size());
+        CHECK(snapshot.getNextEmployeeNumber() == original.getNextEmployeeNumber());
+        // Names are stored once each in the string heap.
+        CHECK(snapshot.nameCount() < 200);
+
+        const SnapshotRecord* marc = snapshot.find(1001);
+        CHECK(marc != nullptr);
+        CHECK(marc != nullptr && snapshot.firstName(*marc) == "Marc");
+        CHECK(marc != nullptr && marc->salary == 100000);
+        CHECK(snapshot.find(999) == nullptr);
+        CHECK(snapshot.find(original.getNextEmployeeNumber()) == nullptr);
+
+        bool allMatch = true;
+        for (const auto& employee : original)
+        {
+            const SnapshotRecord* record = snapshot.find(employee.getEmployeeNumber());
+            allMatch = allMatch && record != nullptr
+                && snapshot.firstName(*record) == employee.getFirstName()
+                && snapshot.lastName(*record) == employee.getLastName()
+                && record->salary == employee.getSalary()
+                && ((record->flags & SnapshotRecord::kHired) != 0) == employee.isHired();
+        }
+        CHECK(allMatch);
+    }
+
+    cout << "Loading the snapshot into a database." << endl;
+    for (StorageLayout layout : { StorageLayout::Rows, StorageLayout::Columnar })
+    {
+        Database restored(layout);
+        restored.loadSnapshot(path);
+        CHECK(restored.size() == original.size());
+        CHECK(restored.getNextEmployeeNumber() == original.getNextEmployeeNumber());
+
+        // Read from the mapped file, before anything needs the tiers.
+        bool allFound = true;
+        for (const auto& employee : original)
+        {
+            Employee found;
+            allFound = allFound && restored.contains(employee.getEmployeeNumber())
+                && !restored.isArchived(employee.getEmployeeNumber())
+                && restored.findEmployee(employee.getEmployeeNumber(), found)
+                && sameEmployee(employee, found);
+        }
+        CHECK(allFound);
+        Employee missing;
+        CHECK(!restored.contains(999));
+        CHECK(!restored.findEmployee(original.getNextEmployeeNumber(), missing));
+
+        bool allMatch = true;
+        for (const auto& employee : original)
+        {
+            allMatch = allMatch && sameEmployee(employee, restored.getEmployee(employee.getEmployeeNumber()));
+        }
+        CHECK(allMatch);
+        CHECK(restored.findEmployees("John", "Doe").size() == 2);
+        CHECK(restored.getEmployee("John", "Doe").getSalary() == 11000);
+
+        // New hires continue the numbering instead of reusing numbers.
+        CHECK(restored.addEmployee("New", "Hire").getEmployeeNumber() == original.getNextEmployeeNumber());
+        CHECK_THROWS(restored.loadSnapshot(path), logic_error);
+    }
+
+    cout << "Building the tiers from concurrent readers." << endl;
+    {
+        Database restored;
+        restored.loadSnapshot(path);
+        vector<thread> readers;
+        vector<size_t> counts(4);
+        for (size_t reader = 0; reader < counts.size(); ++reader)
+        {
+            readers.emplace_back([&, reader] {
+                Employee found;
+                restored.findEmployee(1001, found);
+                counts[reader] = restored.getCounters().headcount(StatusFilter::All);
+            });
+        }
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+        bool allCounted = true;
+        for (size_t count : counts)
+        {
+            allCounted = allCounted && count == original.size();
+        }
+        CHECK(allCounted);
+        CHECK(restored.findEmployees("Marc", "White").size() == 1);
+    }
+
+    cout << "Aligning the name table after an odd number of records." << endl;
+    {
+        const string odd = "SnapshotTest-odd.snap";
+        Database three;
+        three.addEmployee("Ada", "Lovelace");
+        three.addEmployee("Alan", "Turing").fire();
+        three.addEmployee("Grace", "Hopper");
+        three.saveSnapshot(odd);
+        {
+            Snapshot snapshot(odd);
+            CHECK(snapshot.size() == 3);
+            CHECK(snapshot.lastName(*snapshot.find(1001)) == "Turing");
+        }
+        ifstream in(odd, ios::binary);
+        string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        SnapshotHeader header;
+        memcpy(&header, bytes.data(), sizeof(header));
+        CHECK(header.namesOffset % alignof(SnapshotName) == 0);
+        CHECK(header.heapOffset % alignof(SnapshotName) == 0);
+
+        // A file whose name table is misaligned is rejected.
+        header.namesOffset -= 4;
+        memcpy(&bytes[0], &header, sizeof(header));
+        {
+            ofstream out(odd, ios::binary);
+            out.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+        }
+        CHECK_THROWS(Snapshot snapshot(odd), runtime_error);
+        remove(odd.c_str());
+    }
+
+    cout << "Rejecting damaged files." << endl;
+    {
+        Database empty;
+        CHECK_THROWS(empty.loadSnapshot("does-not-exist.snap"), runtime_error);
+
+        const string truncated = "SnapshotTest-truncated.snap";
+        {
+            ifstream in(path, ios::binary);
+            string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+            ofstream out(truncated, ios::binary);
+            out.write(bytes.data(), static_cast<streamsize>(bytes.size() / 2));
+        }
+        CHECK_THROWS(Snapshot snapshot(truncated), runtime_error);
+
+        {
+            ofstream out(truncated, ios::binary);
+            out << string(sizeof(SnapshotHeader), 'x');
+        }
+        CHECK_THROWS(empty.loadSnapshot(truncated), runtime_error);
+        CHECK(empty.size() == 0);
+
+        // A record's names are only checked when it is read, so loading
+        // succeeds and the first call to need that record fails.
+        const string damaged = "SnapshotTest-damaged.snap";
+        {
+            ifstream in(path, ios::binary);
+            string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+            SnapshotHeader header;
+            memcpy(&header, bytes.data(), sizeof(header));
+            SnapshotRecord record;
+            char* last = &bytes[header.recordsOffset + (header.recordCount - 1) * sizeof(SnapshotRecord)];
+            memcpy(&record, last, sizeof(record));
+            record.firstName = static_cast<uint32_t>(header.nameCount);
+            memcpy(last, &record, sizeof(record));
+            ofstream out(damaged, ios::binary);
+            out.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+        }
+        Database partly;
+        partly.loadSnapshot(damaged);
+        CHECK(partly.size() == original.size());
+        Employee found;
+        CHECK(partly.findEmployee(1001, found) && found.getLastName() == "White");
+        CHECK_THROWS(partly.findEmployee(original.getNextEmployeeNumber() - 1, found), runtime_error);
+        CHECK_THROWS(partly.addEmployee("New", "Hire"), runtime_error);
+        CHECK(partly.size() == original.size());
+
+        // A repeated number is caught when the records are copied.
+        {
+            ifstream in(path, ios::binary);
+            string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+            SnapshotHeader header;
+            memcpy(&header, bytes.data(), sizeof(header));
+            char* first = &bytes[header.recordsOffset];
+            memcpy(first + sizeof(SnapshotRecord), first, sizeof(int32_t));
+            ofstream out(damaged, ios::binary);
+            out.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+        }
+        Database repeated;
+        repeated.loadSnapshot(damaged);
+        CHECK_THROWS(repeated.addEmployee("New", "Hire"), runtime_error);
+        CHECK_THROWS(repeated.getEmployee(1001), runtime_error);
+        remove(damaged.c_str());
+        remove(truncated.c_str());
+    }
+
+    remove(path.c_str());
+    return Testing::testResult();
+}
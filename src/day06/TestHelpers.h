@@ -0,0 +1,55 @@
+#pragma once
+
+/*
+ * Minimal checking for the *Test.cpp programs: CHECK records a failure and
+ * keeps going, and testResult() becomes the exit code of main().
+ */
+
+#include <iostream>
+
+namespace Testing
+{
+    inline int& failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    inline void check(bool passed, const char* expression, const char* file, int line)
+    {
+        if (!passed)
+        {
+            ++failures();
+            std::cerr << file << ":" << line << ": CHECK failed: " << expression << std::endl;
+        }
+    }
+
+    inline int testResult()
+    {
+        if (failures() == 0)
+        {
+            std::cout << "All checks passed." << std::endl;
+            return 0;
+        }
+        std::cout << failures() << " check(s) failed." << std::endl;
+        return 1;
+    }
+}
+
+#define CHECK(expression) ::Testing::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+// Passes if statement throws an exception of the given type.
+#define CHECK_THROWS(statement, exceptionType)                                \
+    do                                                                        \
+    {                                                                         \
+        bool threw = false;                                                   \
+        try                                                                   \
+        {                                                                     \
+            statement;                                                        \
+        }                                                                     \
+        catch (const exceptionType&)                                          \
+        {                                                                     \
+            threw = true;                                                     \
+        }                                                                     \
+        ::Testing::check(threw, #statement " throws " #exceptionType, __FILE__, __LINE__); \
+    } while (false)
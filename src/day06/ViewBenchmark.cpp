@@ -0,0 +1,93 @@
+/*
+ * Writer throughput on a ConcurrentDatabase with no view open, with one
+ * view held open, and while a reporting thread scans views back to back.
+ *
+ * Usage: ViewBenchmark [employees] [raisesPerThread]
+ *        (default 1000000 employees, 200000 raises per thread)
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ConcurrentDatabase.h"
+
+using namespace std;
+using namespace Records;
+
+// Raises random employees from threads threads. Returns raises per second.
+static double raise(ConcurrentDatabase& db, size_t threads, size_t raisesPerThread, size_t employees)
+{
+    vector<thread> workers;
+    auto start = Bench::Clock::now();
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t] {
+            mt19937 rng(static_cast<unsigned>(t) + 1);
+            for (size_t i = 0; i < raisesPerThread; ++i)
+            {
+                db.promote(kDefaultEmployeeNumber + static_cast<int>(rng() % employees), 1);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    chrono::duration<double> elapsed = Bench::Clock::now() - start;
+    return static_cast<double>(threads * raisesPerThread) / elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t employees = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t raisesPerThread = argc > 2 ? strtoull(argv[2], nullptr, 10) : 200000;
+
+    ConcurrentDatabase db;
+    for (size_t i = 0; i < employees; ++i)
+    {
+        db.addEmployee("First" + to_string(i % 1000), "Last" + to_string(i));
+    }
+
+    cout << "hardware threads: " << thread::hardware_concurrency() << endl;
+    cout << setw(9) << "threads" << setw(16) << "no view op/s" << setw(16) << "open view op/s"
+         << setw(16) << "scanning op/s" << setw(10) << "reports" << endl;
+
+    for (size_t threads = 1; threads <= 16; threads *= 2)
+    {
+        double plain = raise(db, threads, raisesPerThread, employees);
+
+        double held;
+        {
+            auto view = db.openView();
+            held = raise(db, threads, raisesPerThread, employees);
+        }
+
+        // A report that sums every salary, over and over.
+        atomic<bool> stop{false};
+        size_t reports = 0;
+        thread reporter([&] {
+            while (!stop)
+            {
+                long long total = 0;
+                db.openView().forEach([&](const Employee& employee) { total += employee.getSalary(); });
+                Bench::doNotOptimize(total);
+                ++reports;
+            }
+        });
+        double scanning = raise(db, threads, raisesPerThread, employees);
+        stop = true;
+        reporter.join();
+
+        cout << setw(9) << threads << fixed << setprecision(0) << setw(16) << plain
+             << setw(16) << held << setw(16) << scanning << setw(10) << reports << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "WriteAheadLog.h"
+
+using namespace std;
+
+namespace Records
+{
+    namespace
+    {
+        // sequence, operation, employeeNumber, value, text length
+        const size_t kFixedPayloadBytes = 8 + 1 + 4 + 4 + 4;
+        const size_t kFrameBytes = 8;
+        const uint32_t kMaxPayloadBytes = 1 << 24;
+
+        uint32_t crc32(const char* data, size_t bytes)
+        {
+            static const auto table = [] {
+                array<uint32_t, 256> entries{};
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t crc = i;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+                    }
+                    entries[i] = crc;
+                }
+                return entries;
+            }();
+
+            uint32_t crc = 0xFFFFFFFFu;
+            for (size_t i = 0; i < bytes; ++i)
+            {
+                crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+            }
+            return crc ^ 0xFFFFFFFFu;
+        }
+
+        template <typename T>
+        void put(vector<char>& out, T value)
+        {
+            const char* bytes = reinterpret_cast<const char*>(&value);
+            out.insert(out.end(), bytes, bytes + sizeof(T));
+        }
+
+        template <typename T>
+        T get(const char*& in)
+        {
+            T value;
+            memcpy(&value, in, sizeof(T));
+            in += sizeof(T);
+            return value;
+        }
+
+        runtime_error logError(const string& path, const string& what)
+        {
+            return runtime_error("Write-ahead log " + path + ": " + what);
+        }
+
+        // Reads intact entries from in, passing each to apply. Returns the
+        // byte length of the intact prefix.
+        uint64_t readEntries(FILE* in, const function<void(const LogEntry&)>& apply)
+        {
+            uint64_t intactBytes = 0;
+            vector<char> payload;
+            char frame[kFrameBytes];
+            while (fread(frame, 1, kFrameBytes, in) == kFrameBytes)
+            {
+                const char* cursor = frame;
+                uint32_t length = get<uint32_t>(cursor);
+                uint32_t checksum = get<uint32_t>(cursor);
+                if (length < kFixedPayloadBytes || length > kMaxPayloadBytes)
+                {
+                    break;
+                }
+                payload.resize(length);
+                if (fread(payload.data(), 1, length, in) != length
+                    || crc32(payload.data(), length) != checksum)
+                {
+                    break;
+                }
+
+                cursor = payload.data();
+                LogEntry entry;
+                entry.sequence = get<uint64_t>(cursor);
+                entry.operation = static_cast<LogOperation>(get<uint8_t>(cursor));
+                entry.employeeNumber = get<int32_t>(cursor);
+                entry.value = get<int32_t>(cursor);
+                uint32_t textLength = get<uint32_t>(cursor);
+                if (textLength != length - kFixedPayloadBytes)
+                {
+                    break;
+                }
+                entry.text.assign(cursor, textLength);
+                apply(entry);
+                intactBytes += kFrameBytes + length;
+            }
+            return intactBytes;
+        }
+    }
+
+    WriteAheadLog::WriteAheadLog(const string& path, size_t groupCommitSize)
+        : mPath(path), mGroupCommitSize(groupCommitSize == 0 ? 1 : groupCommitSize)
+    {
+        uint64_t intactBytes = 0;
+        if (FILE* in = fopen(path.c_str(), "rb"))
+        {
+            intactBytes = readEntries(in, [this](const LogEntry& entry) {
+                mLastSequence = max(mLastSequence, entry.sequence);
+            });
+            fclose(in);
+        }
+
+        mFd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+        if (mFd < 0)
+        {
+            throw logError(path, strerror(errno));
+        }
+        // Cut off a torn tail so new entries follow the last intact one.
+        if (::ftruncate(mFd, static_cast<off_t>(intactBytes)) != 0
+            || ::lseek(mFd, 0, SEEK_END) < 0)
+        {
+            ::close(mFd);
+            throw logError(path, strerror(errno));
+        }
+    }
+
+    WriteAheadLog::~WriteAheadLog()
+    {
+        try
+        {
+            commit();
+        }
+        catch (const runtime_error&)
+        {
+            // The entries were never acknowledged as durable; dropping them
+            // is all a destructor can do.
+        }
+        ::close(mFd);
+    }
+
+    uint64_t WriteAheadLog::append(LogOperation operation, int employeeNumber, int value,
+                                   string_view text)
+    {
+        if (mFailed)
+        {
+            throw logError(mPath, "an earlier sync failed");
+        }
+        uint32_t length = static_cast<uint32_t>(kFixedPayloadBytes + text.size());
+        if (length > kMaxPayloadBytes)
+        {
+            throw length_error("Write-ahead log entry is too large.");
+        }
+
+        size_t start = mBuffer.size();
+        put<uint32_t>(mBuffer, length);
+        put<uint32_t>(mBuffer, 0);
+        put<uint64_t>(mBuffer, ++mLastSequence);
+        put<uint8_t>(mBuffer, static_cast<uint8_t>(operation));
+        put<int32_t>(mBuffer, employeeNumber);
+        put<int32_t>(mBuffer, value);
+        put<uint32_t>(mBuffer, static_cast<uint32_t>(text.size()));
+        mBuffer.insert(mBuffer.end(), text.begin(), text.end());
+
+        uint32_t checksum = crc32(mBuffer.data() + start + kFrameBytes, length);
+        memcpy(mBuffer.data() + start + 4, &checksum, sizeof(checksum));
+
+        if (++mPending >= mGroupCommitSize)
+        {
+            commit();
+        }
+        return mLastSequence;
+    }
+
+    void WriteAheadLog::commit()
+    {
+        if (mFailed)
+        {
+            throw logError(mPath, "an earlier sync failed");
+        }
+        if (mBuffer.empty())
+        {
+            return;
+        }
+        const char* data = mBuffer.data();
+        size_t remaining = mBuffer.size();
+        while (remaining > 0)
+        {
+            ssize_t written = ::write(mFd, data, remaining);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                // Keep only what has not reached the file, so a later
+                // commit does not write those frames twice.
+                string reason = strerror(errno);
+                mBuffer.erase(mBuffer.begin(), mBuffer.begin() + (data - mBuffer.data()));
+                throw logError(mPath, reason);
+            }
+            data += written;
+            remaining -= static_cast<size_t>(written);
+        }
+        mBuffer.clear();
+        mPending = 0;
+        if (::fdatasync(mFd) != 0)
+        {
+            // The entries just written are gone from the buffer, so a
+            // later commit would otherwise report them durable.
+            mFailed = true;
+            throw logError(mPath, strerror(errno));
+        }
+    }
+
+    void WriteAheadLog::truncate()
+    {
+        mBuffer.clear();
+        mPending = 0;
+        if (::ftruncate(mFd, 0) != 0 || ::lseek(mFd, 0, SEEK_SET) < 0 || ::fsync(mFd) != 0)
+        {
+            throw logError(mPath, strerror(errno));
+        }
+    }
+
+    void WriteAheadLog::resumeAfter(uint64_t sequence)
+    {
+        mLastSequence = max(mLastSequence, sequence);
+    }
+
+    uint64_t WriteAheadLog::getLastSequence() const
+    {
+        return mLastSequence;
+    }
+
+    size_t WriteAheadLog::getGroupCommitSize() const
+    {
+        return mGroupCommitSize;
+    }
+
+    size_t WriteAheadLog::pendingEntries() const
+    {
+        return mPending;
+    }
+
+    uint64_t WriteAheadLog::replay(const string& path, uint64_t afterSequence,
+                                   const function<void(const LogEntry&)>& apply)
+    {
+        FILE* in = fopen(path.c_str(), "rb");
+        if (in == nullptr)
+        {
+            if (errno == ENOENT)
+            {
+                return afterSequence;
+            }
+            throw logError(path, strerror(errno));
+        }
+        uint64_t lastSequence = afterSequence;
+        try
+        {
+            readEntries(in, [&](const LogEntry& entry) {
+                if (entry.sequence > afterSequence)
+                {
+                    apply(entry);
+                    lastSequence = max(lastSequence, entry.sequence);
+                }
+            });
+        }
+        catch (...)
+        {
+            fclose(in);
+            throw;
+        }
+        fclose(in);
+        return lastSequence;
+    }
+}
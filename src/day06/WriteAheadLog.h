@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Records
+{
+    enum class LogOperation : std::uint8_t
+    {
+        // text holds first name then last name; value is the first name's length.
+        AddEmployee = 1,
+        SetFirstName,
+        SetLastName,
+        // value is the new number.
+        SetEmployeeNumber,
+        SetSalary,
+        Hire,
+        Fire
+    };
+
+    struct LogEntry
+    {
+        std::uint64_t sequence = 0;
+        LogOperation operation = LogOperation::AddEmployee;
+        // The employee as numbered before this mutation.
+        int employeeNumber = 0;
+        int value = 0;
+        std::string text;
+    };
+
+    // Append-only log of Database mutations. Each entry is framed as
+    //
+    //   uint32 payload length | uint32 CRC-32 of payload | payload
+    //
+    // and a torn or corrupt entry ends the log: it and everything after it
+    // are ignored on replay and cut off when the log is reopened.
+    //
+    // Entries are buffered and made durable together: once groupCommitSize
+    // entries are pending, they are written with one write() and one
+    // fdatasync(). A size of 1 syncs every mutation; larger sizes trade the
+    // durability of the last few mutations for throughput. commit() forces
+    // the pending entries out early.
+    //
+    // A failed fdatasync() leaves it unknown which entries reached the disk,
+    // so it fails the log: that commit() and every later append() and
+    // commit() throw runtime_error.
+    class WriteAheadLog
+    {
+        public:
+            // Opens (or creates) the log at path and positions after its
+            // last intact entry. Throws runtime_error on I/O failure.
+            explicit WriteAheadLog(const std::string& path, std::size_t groupCommitSize = 1);
+            // Commits pending entries.
+            ~WriteAheadLog();
+            WriteAheadLog(const WriteAheadLog&) = delete;
+            WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+            // Buffers an entry and returns its sequence number.
+            std::uint64_t append(LogOperation operation, int employeeNumber, int value,
+                                 std::string_view text = std::string_view());
+            // Writes and syncs every pending entry.
+            void commit();
+            // Discards every entry, once a snapshot covers them.
+            void truncate();
+
+            // Makes the next sequence number at least sequence + 1, so new
+            // entries sort after everything a loaded snapshot already holds.
+            void resumeAfter(std::uint64_t sequence);
+            std::uint64_t getLastSequence() const;
+            std::size_t getGroupCommitSize() const;
+            std::size_t pendingEntries() const;
+
+            // Calls apply for each intact entry of the log at path whose
+            // sequence is greater than afterSequence. A missing file has no
+            // entries. Returns the last sequence seen.
+            static std::uint64_t replay(const std::string& path, std::uint64_t afterSequence,
+                                        const std::function<void(const LogEntry&)>& apply);
+
+        private:
+            std::string mPath;
+            int mFd = -1;
+            std::size_t mGroupCommitSize;
+            std::size_t mPending = 0;
+            std::uint64_t mLastSequence = 0;
+            std::vector<char> mBuffer;
+            // Set once an fdatasync() has failed.
+            bool mFailed = false;
+    };
+}
@@ -0,0 +1,61 @@
+/*
+ * Logged mutations per second at different group-commit sizes. Each batch
+ * costs one write() and one fdatasync() on a local file.
+ *
+ * Usage: WriteAheadLogBenchmark [mutations] [logFile]
+ *        (default 200000 mutations, WriteAheadLogBenchmark.wal)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "Benchmark.h"
+#include "Database.h"
+#include "WriteAheadLog.h"
+
+using namespace std;
+using namespace Records;
+
+int main(int argc, char* argv[])
+{
+    size_t mutations = argc > 1 ? strtoull(argv[1], nullptr, 10) : 200000;
+    string path = argc > 2 ? argv[2] : "WriteAheadLogBenchmark.wal";
+
+    Database db;
+    for (int i = 0; i < 10000; ++i)
+    {
+        db.addEmployee("First" + to_string(i), "Last" + to_string(i));
+    }
+
+    cout << setw(12) << "batch size" << setw(14) << "mutations" << setw(16) << "mutations/s"
+         << setw(14) << "fsyncs/s" << endl;
+
+    for (size_t batch : { 1, 4, 16, 64, 256, 1024, 4096 })
+    {
+        remove(path.c_str());
+        // Syncing every mutation is slow; keep the unbatched runs short.
+        size_t count = min(mutations, batch * 2000);
+
+        WriteAheadLog log(path, batch);
+        db.attachLog(&log);
+        auto start = Bench::Clock::now();
+        for (size_t i = 0; i < count; ++i)
+        {
+            Employee& employee = db.getEmployee(kDefaultEmployeeNumber + static_cast<int>(i % 10000));
+            employee.setSalary(30000 + static_cast<int>(i % 50000));
+        }
+        log.commit();
+        chrono::duration<double> elapsed = Bench::Clock::now() - start;
+        db.attachLog(nullptr);
+
+        double perSecond = static_cast<double>(count) / elapsed.count();
+        cout << setw(12) << batch << setw(14) << count << setw(16) << fixed << setprecision(0)
+             << perSecond << setw(14) << perSecond / static_cast<double>(batch) << endl;
+    }
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include "Database.h"
+#include "TestHelpers.h"
+#include "WriteAheadLog.h"
+
+using namespace std;
+using namespace Records;
+
+/*
+ * Mutates a logged database, "crashes" it at various points and checks that
+ * Database::recover rebuilds the same roster from the snapshot and log.
+ */
+
+static bool sameRoster(const Database& expected, Database& actual)
+{
+    if (expected.size() != actual.size())
+    {
+        return false;
+    }
+    for (const auto& employee : expected)
+    {
+        const Employee& other = actual.getEmployee(employee.getEmployeeNumber());
+        if (employee.getFirstName() != other.getFirstName()
+            || employee.getLastName() != other.getLastName()
+            || employee.getSalary() != other.getSalary()
+            || employee.isHired() != other.isHired())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void mutate(Database& db, int round)
+{
+    Employee& hired = db.addEmployee("First" + to_string(round), "Last" + to_string(round % 7));
+    hired.setSalary(40000 + round);
+    db.getEmployee(kDefaultEmployeeNumber + round / 2).promote(100);
+    if (round % 3 == 0)
+    {
+        hired.fire();
+    }
+    if (round % 5 == 0)
+    {
+        hired.setLastName("Renamed");
+    }
+}
+
+int main()
+{
+    const string snapshotPath = "WriteAheadLogTest.snap";
+    const string logPath = "WriteAheadLogTest.wal";
+    remove(snapshotPath.c_str());
+    remove(logPath.c_str());
+
+    cout << "Replaying a log with no snapshot." << endl;
+    {
+        WriteAheadLog log(logPath, 8);
+        Database db;
+        db.attachLog(&log);
+        for (int round = 0; round < 100; ++round)
+        {
+            mutate(db, round);
+        }
+        log.commit();
+
+        Database recovered;
+        recovered.recover(snapshotPath, logPath);
+        CHECK(sameRoster(db, recovered));
+        CHECK(recovered.getLogSequence() == db.getLogSequence());
+    }
+
+    cout << "Replaying the log on top of a checkpoint." << endl;
+    {
+        WriteAheadLog log(logPath, 8);
+        Database db;
+        db.recover(snapshotPath, logPath);
+        db.attachLog(&log);
+        db.checkpoint(snapshotPath);
+        for (int round = 100; round < 250; ++round)
+        {
+            mutate(db, round);
+        }
+        db.getEmployee(kDefaultEmployeeNumber + 3).setEmployeeNumber(500);
+        log.commit();
+
+        Database recovered;
+        recovered.recover(snapshotPath, logPath);
+        CHECK(sameRoster(db, recovered));
+        CHECK(recovered.getEmployee(500).getEmployeeNumber() == 500);
+        // New hires continue after everything replayed.
+        CHECK(recovered.getNextEmployeeNumber() == db.getNextEmployeeNumber());
+
+    }
+
+    cout << "Ignoring a torn tail." << endl;
+    {
+        Database before;
+        before.recover(snapshotPath, logPath);
+        {
+            // A frame header promising more payload than follows.
+            const char torn[] = { 0x30, 0, 0, 0, 1, 2, 3, 4, 'x', 'y' };
+            ofstream out(logPath, ios::binary | ios::app);
+            out.write(torn, sizeof(torn));
+        }
+        Database recovered;
+        recovered.recover(snapshotPath, logPath);
+        CHECK(sameRoster(before, recovered));
+
+        // Reopening cuts the tail off, so new entries are replayable.
+        WriteAheadLog log(logPath, 1);
+        recovered.attachLog(&log);
+        recovered.addEmployee("After", "Tear").setSalary(77777);
+
+        Database again;
+        again.recover(snapshotPath, logPath);
+        CHECK(sameRoster(recovered, again));
+        CHECK(again.getEmployee("After", "Tear").getSalary() == 77777);
+    }
+
+    cout << "Losing only uncommitted entries." << endl;
+    {
+        Database committed;
+        committed.recover(snapshotPath, logPath);
+        size_t before = committed.size();
+        {
+            WriteAheadLog log(logPath, 1000);
+            committed.attachLog(&log);
+            committed.addEmployee("Pending", "Hire");
+            CHECK(log.pendingEntries() == 1);
+            committed.attachLog(nullptr);
+            // The destructor commits what is still pending.
+        }
+        Database recovered;
+        recovered.recover(snapshotPath, logPath);
+        CHECK(recovered.size() == before + 1);
+    }
+
+    cout << "Retrying a partly written batch." << endl;
+    {
+        const string partialPath = "WriteAheadLogTest.partial.wal";
+        remove(partialPath.c_str());
+        {
+            WriteAheadLog log(partialPath, 1000);
+            for (int i = 0; i < 100; ++i)
+            {
+                log.append(LogOperation::SetSalary, kDefaultEmployeeNumber + i, 40000 + i);
+            }
+            // Capping the file size makes write() store what fits, part of
+            // the way into a frame, and then fail.
+            signal(SIGXFSZ, SIG_IGN);
+            rlimit original;
+            getrlimit(RLIMIT_FSIZE, &original);
+            rlimit capped = original;
+            capped.rlim_cur = 1000;
+            setrlimit(RLIMIT_FSIZE, &capped);
+            CHECK_THROWS(log.commit(), runtime_error);
+            setrlimit(RLIMIT_FSIZE, &original);
+            log.commit();
+        }
+        vector<uint64_t> sequences;
+        WriteAheadLog::replay(partialPath, 0, [&](const LogEntry& entry) {
+            sequences.push_back(entry.sequence);
+        });
+        CHECK(sequences.size() == 100);
+        for (size_t i = 0; i < sequences.size(); ++i)
+        {
+            CHECK(sequences[i] == i + 1);
+        }
+        remove(partialPath.c_str());
+    }
+
+    remove(snapshotPath.c_str());
+    remove(logPath.c_str());
+    return Testing::testResult();
+}
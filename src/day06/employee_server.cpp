@@ -0,0 +1,67 @@
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "Database.h"
+#include "EmployeeServer.h"
+
+using namespace std;
+using namespace Records;
+
+namespace
+{
+    EmployeeServer* gServer = nullptr;
+
+    extern "C" void stopServer(int)
+    {
+        if (gServer != nullptr)
+        {
+            gServer->stop();
+        }
+    }
+}
+
+// Usage: employee_server socketPath [snapshotFile]
+// Serves the roster to local clients (see EmployeeProtocol.h) until
+// interrupted. With a snapshot file, the roster is loaded from it at
+// startup (if it exists) and saved back to it on exit.
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0] << " socketPath [snapshotFile]" << endl;
+        return 2;
+    }
+    string socketPath = argv[1];
+    string snapshotPath = argc > 2 ? argv[2] : "";
+
+    Database employeeDB;
+    try
+    {
+        if (!snapshotPath.empty() && ifstream(snapshotPath).good())
+        {
+            employeeDB.loadSnapshot(snapshotPath);
+            cout << "Loaded " << employeeDB.size() << " employees from " << snapshotPath << endl;
+        }
+
+        EmployeeServer server(employeeDB, socketPath);
+        gServer = &server;
+        signal(SIGINT, stopServer);
+        signal(SIGTERM, stopServer);
+        cout << "Serving on " << socketPath << endl;
+        server.run();
+        gServer = nullptr;
+
+        if (!snapshotPath.empty())
+        {
+            employeeDB.saveSnapshot(snapshotPath);
+        }
+    }
+    catch (const runtime_error& exception)
+    {
+        cerr << exception.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,7 +1,9 @@
+#include <fstream>
 #include <iostream>
 #include <stdexcept>
 #include <exception>
 #include "Database.h"
+#include "OperationStats.h"
 using namespace std;
 using namespace Records;
 int displayMenu();
@@ -9,9 +11,23 @@ void doHire(Database& db);
 void doFire(Database& db);
 void doPromote(Database& db);
 void doDemote(Database& db);
-int main()
+void doDumpStats();
+// Usage: user_interface [snapshotFile]
+// With a snapshot file, the roster is loaded from it at startup (if it
+// exists) and saved back to it on quit.
+int main(int argc, char* argv[])
 {
  Database employeeDB;
+ string snapshotPath = argc > 1 ? argv[1] : "";
+ if (!snapshotPath.empty() && ifstream(snapshotPath).good()) {
+ try {
+ employeeDB.loadSnapshot(snapshotPath);
+ cout << "Loaded " << employeeDB.size() << " employees from " << snapshotPath << endl;
+ } catch (const std::runtime_error& exception) {
+ cerr << "Unable to load snapshot: " << exception.what() << endl;
+ return 1;
+ }
+ }
  bool done = false;
  while (!done) {
  int selection = displayMenu();
@@ -37,11 +53,25 @@ int main()
  case 6:
  employeeDB.displayFormer();
  break;
+ case 7:
+ OperationStats::collect().writeText(cout);
+ break;
+ case 8:
+ doDumpStats();
+ break;
  default:
  cerr << "Unknown command." << endl;
  break;
  }
  }
+ if (!snapshotPath.empty()) {
+ try {
+ employeeDB.saveSnapshot(snapshotPath);
+ } catch (const std::runtime_error& exception) {
+ cerr << "Unable to save snapshot: " << exception.what() << endl;
+ return 1;
+ }
+ }
  return 0;
 }
 
@@ -57,6 +87,8 @@ int displayMenu()
  cout << "4) List all employees" << endl;
  cout << "5) List all current employees" << endl;
  cout << "6) List all former employees" << endl;
+ cout << "7) Show operation statistics" << endl;
+ cout << "8) Dump operation statistics as JSON" << endl;
  cout << "0) Quit" << endl;
  cout << endl;
  cout << "---> ";
@@ -102,4 +134,20 @@ void doPromote(Database& db)
  } catch (const std::logic_error& exception) {
  cerr << "Unable to promote employee: " << exception.what() << endl;
  }
-}
\ No newline at end of file
+}
+
+void doDumpStats()
+{
+ string path;
+ cout << "File name (- for the screen)? ";
+ cin >> path;
+ if (path == "-") {
+ OperationStats::collect().writeJson(cout);
+ return;
+ }
+ ofstream out(path);
+ OperationStats::collect().writeJson(out);
+ if (!out) {
+ cerr << "Unable to write " << path << endl;
+ }
+}